@@ -0,0 +1,28 @@
+# Copyright (c) 2026 LMMS Developers
+#
+# Redistribution and use is allowed according to the terms of the New BSD license.
+# For details see the accompanying COPYING-CMAKE-SCRIPTS file.
+
+include(ImportedTargetHelpers)
+
+find_package_config_mode_with_fallback(zstd zstd::libzstd_shared
+	LIBRARY_NAMES "zstd" "libzstd"
+	INCLUDE_NAMES "zstd.h"
+	PKG_CONFIG libzstd
+	PREFIX Zstd
+)
+
+# The config package exports separate shared and static targets
+if(TARGET zstd::libzstd_shared AND NOT TARGET zstd::libzstd)
+	add_library(zstd::libzstd INTERFACE IMPORTED)
+	set_target_properties(zstd::libzstd PROPERTIES INTERFACE_LINK_LIBRARIES zstd::libzstd_shared)
+elseif(TARGET zstd::libzstd_static AND NOT TARGET zstd::libzstd)
+	add_library(zstd::libzstd INTERFACE IMPORTED)
+	set_target_properties(zstd::libzstd PROPERTIES INTERFACE_LINK_LIBRARIES zstd::libzstd_static)
+endif()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd
+	REQUIRED_VARS Zstd_LIBRARY Zstd_INCLUDE_DIRS
+	VERSION_VAR Zstd_VERSION
+)
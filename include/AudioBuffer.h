@@ -239,6 +239,28 @@ public:
 		return {m_interleavedBuffer.data(), m_frames};
 	}
 
+	/**
+	 * Copies the first channel group to the temporary interleaved buffer, unless
+	 * nothing changed since they were last in sync.
+	 * TODO: Remove once using planar only
+	 */
+	void syncInterleavedBuffer();
+
+	/**
+	 * Copies the temporary interleaved buffer to the first channel group after
+	 * writing to it, so both are in sync.
+	 * TODO: Remove once using planar only
+	 */
+	void syncFromInterleavedBuffer();
+
+	/**
+	 * Marks the temporary interleaved buffer as out of date after writing to the
+	 * first channel group directly. Conversions are deferred until the
+	 * interleaved buffer is needed again.
+	 * TODO: Remove once using planar only
+	 */
+	void invalidateInterleavedBuffer() { m_interleavedInSync = false; }
+
 	/**
 	 * @brief Adds a new channel group at the end of the list.
 	 *
@@ -378,6 +400,9 @@ public:
 	//! @returns absolute peak sample value for the given channel
 	auto absPeakValue(ch_cnt_t channel) const -> float;
 
+	//! @returns root mean square of the sample values of the given channel
+	auto rmsValue(ch_cnt_t channel) const -> float;
+
 private:
 	/**
 	 * Large buffer that all channel buffers are sourced from.
@@ -400,6 +425,9 @@ private:
 	 */
 	std::pmr::vector<float> m_interleavedBuffer;
 
+	//! Whether the temporary interleaved buffer holds the same audio as the first channel group
+	bool m_interleavedInSync = false;
+
 	//! Divides channels into arbitrary groups
 	ArrayVector<ChannelGroup, MaxGroupsPerAudioBuffer> m_groups;
 
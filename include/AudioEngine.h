@@ -35,6 +35,7 @@
 
 #include "AudioBufferView.h"
 #include "AudioDevice.h"
+#include "AudioTelemetry.h"
 #include "LmmsTypes.h"
 #include "SampleFrame.h"
 #include "LocklessList.h"
@@ -48,6 +49,7 @@ namespace lmms
 class MidiClient;
 class AudioBusHandle;  // IWYU pragma: keep
 class AudioEngineWorkerThread;
+class ThreadableJob;
 
 constexpr f_cnt_t MINIMUM_BUFFER_SIZE = 32;
 constexpr f_cnt_t DEFAULT_BUFFER_SIZE = 256;
@@ -186,6 +188,10 @@ public:
 		return m_profiler.detailLoad(type);
 	}
 
+	//! Levels, output and profiler statistics of the recent periods, for the GUI
+	const AudioTelemetry& telemetry() const { return m_telemetry; }
+	AudioTelemetry& telemetry() { return m_telemetry; }
+
 	sample_rate_t baseSampleRate() const { return m_baseSampleRate; }
 
 
@@ -310,7 +316,6 @@ public:
 signals:
 	void qualitySettingsChanged();
 	void sampleRateChanged();
-	void nextAudioBuffer(const lmms::SampleFrame* buffer);
 
 
 private:
@@ -365,6 +370,9 @@ private:
 
 	void swapBuffers();
 
+	// hand the levels and statistics of the finished period to the GUI
+	void publishTelemetry();
+
 	void clearInternal();
 
 	bool m_renderOnly;
@@ -394,6 +402,8 @@ private:
 	// place where new playhandles are added temporarily
 	LocklessList<PlayHandle *> m_newPlayHandles;
 	ConstPlayHandleList m_playHandlesToRemove;
+	// jobs handed out by instruments through Instrument::queueJobs()
+	std::vector<ThreadableJob*> m_instrumentJobs;
 
 	float m_masterGain;
 
@@ -409,6 +419,7 @@ private:
 	QString m_midiClientName;
 
 	AudioEngineProfiler m_profiler;
+	AudioTelemetry m_telemetry;
 
 	bool m_clearSignal;
 	std::atomic<bool> m_sanitizationEnabled = false;
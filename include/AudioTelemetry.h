@@ -0,0 +1,191 @@
+/*
+ * AudioTelemetry.h - lock-free channel for levels and statistics of the
+ *                    audio processing
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUDIO_TELEMETRY_H
+#define LMMS_AUDIO_TELEMETRY_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "AudioEngineProfiler.h"
+#include "LmmsTypes.h"
+#include "SampleFrame.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+ * Carries what the GUI shows about the audio processing from the audio thread
+ * to the GUI: the levels of the mixer channels, the master output and the
+ * profiler statistics.
+ *
+ * The audio thread fills one snapshot per period into a ring of snapshots and
+ * publishes it by advancing an atomic counter. Each reader keeps its own
+ * position and consumes all snapshots published since it last looked,
+ * typically once per displayed frame. Neither side ever waits for the other:
+ * a reader that falls too far behind skips the snapshots it missed. Readers
+ * copy each snapshot and check afterwards that the writer did not start on
+ * its slot again meanwhile, so a stalled reader never sees a torn snapshot.
+ */
+class LMMS_EXPORT AudioTelemetry
+{
+public:
+	//! Number of snapshots in the ring
+	static constexpr std::size_t Capacity = 64;
+	//! How far readers stay behind the writer, so that they rarely have to
+	//! discard a snapshot the writer reached while they were copying it
+	static constexpr std::size_t ReadableSnapshots = Capacity - 4;
+
+	struct ChannelLevels
+	{
+		std::array<float, 2> peak = {};
+		std::array<float, 2> rms = {};
+		//! whether an effect of the channel produced infs or NaNs
+		bool corrupted = false;
+	};
+
+	struct Snapshot
+	{
+		std::uint64_t period = 0;
+		int cpuLoad = 0;
+		std::array<int, AudioEngineProfiler::DetailCount> detailLoad = {};
+		//! The levels of the first channelCount mixer channels are valid
+		std::size_t channelCount = 0;
+		std::vector<ChannelLevels> channels;
+		//! The master output of the period
+		std::vector<SampleFrame> output;
+	};
+
+	class Reader
+	{
+	public:
+		//! Start with the next snapshot to be published
+		explicit Reader(const AudioTelemetry& telemetry) :
+			m_telemetry(&telemetry),
+			m_position(telemetry.published())
+		{
+		}
+
+		//! Call @p fn with each snapshot published since the last call,
+		//! oldest first, and return how many there were. Snapshots that were
+		//! overwritten while being copied are skipped.
+		template<class Fn>
+		std::size_t read(Fn&& fn)
+		{
+			const std::uint64_t published = m_telemetry->published();
+			if (published > ReadableSnapshots)
+			{
+				m_position = std::max(m_position, published - ReadableSnapshots);
+			}
+
+			std::size_t count = 0;
+			for (; m_position < published; ++m_position)
+			{
+				if (!copy(m_position))
+				{
+					// The writer lapped the reader, so all snapshots up to here are gone
+					const std::uint64_t now = m_telemetry->published();
+					m_position = std::max(m_position, now - ReadableSnapshots - 1);
+					continue;
+				}
+				fn(static_cast<const Snapshot&>(m_snapshot));
+				++count;
+			}
+			return count;
+		}
+
+		//! A copy of the newest snapshot, or nullptr before the first period
+		const Snapshot* latest()
+		{
+			for (;;)
+			{
+				const std::uint64_t published = m_telemetry->published();
+				if (published == 0) { return nullptr; }
+				if (copy(published - 1)) { return &m_snapshot; }
+			}
+		}
+
+	private:
+		//! Copy the snapshot of period @p position into m_snapshot and return
+		//! whether the writer left it alone while it was copied
+		bool copy(std::uint64_t position)
+		{
+			m_snapshot = m_telemetry->m_ring[position % Capacity];
+
+			// The writer starts on this slot again once position + Capacity is
+			// the period being written, i.e. once that many are published
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return m_telemetry->m_published.load(std::memory_order_relaxed) < position + Capacity;
+		}
+
+		const AudioTelemetry* m_telemetry;
+		std::uint64_t m_position;
+		Snapshot m_snapshot; //!< Reused, so copying does not allocate once the vectors have grown
+	};
+
+	explicit AudioTelemetry(f_cnt_t framesPerPeriod);
+
+	//! Make room for the levels of @p count mixer channels. This must not run
+	//! while a period is written, i.e. only within a change in model.
+	void reserveChannels(std::size_t count);
+	std::size_t channelCapacity() const { return m_channelCapacity; }
+
+	//! Audio thread: the snapshot to fill for the current period
+	Snapshot& beginWrite()
+	{
+		const std::uint64_t period = m_published.load(std::memory_order_relaxed);
+		// Keeps writes to the slot from becoming visible before the count that
+		// tells readers their copy of the slot may be torn
+		std::atomic_thread_fence(std::memory_order_release);
+		return m_ring[period % Capacity];
+	}
+
+	//! Audio thread: publish the snapshot returned by beginWrite()
+	void endWrite()
+	{
+		m_published.fetch_add(1, std::memory_order_release);
+	}
+
+	//! Number of snapshots published so far
+	std::uint64_t published() const
+	{
+		return m_published.load(std::memory_order_acquire);
+	}
+
+private:
+	std::array<Snapshot, Capacity> m_ring;
+	std::size_t m_channelCapacity = 0;
+	std::atomic<std::uint64_t> m_published = 0;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_AUDIO_TELEMETRY_H
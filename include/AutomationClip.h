@@ -30,6 +30,7 @@
 #include <QMap>
 #include <QPointer>
 
+#include "AutomationLod.h"
 #include "AutomationNode.h"
 #include "Clip.h"
 
@@ -169,6 +170,10 @@ public:
 	float valueAt( const TimePos & _time ) const;
 	float *valuesAfter( const TimePos & _time ) const;
 
+	//! Min/max of the curve from the first to the last node at several
+	//! zoom levels, brought up to date with the latest node edits
+	const AutomationLod& levelsOfDetail() const;
+
 	QString name() const;
 
 	// settings-management
@@ -213,7 +218,13 @@ private:
 	void cleanObjects();
 	void generateTangents();
 	void generateTangents(timeMap::iterator it, int numToGenerate);
+	void computeTangents(timeMap::iterator it, int numToGenerate);
 	float valueAt( timeMap::const_iterator v, int offset ) const;
+	void sampleValues(tick_t from, tick_t to, float* out) const;
+
+	//! Mark the curve as changed around the nodes between the given ticks,
+	//! including the segments whose shape depends on their tangents
+	void invalidateCurve(tick_t from, tick_t to);
 
 	/**
 	 * @brief
@@ -247,6 +258,10 @@ private:
 	bool m_isRecording;
 	float m_lastRecordedValue;
 
+	tick_t m_dragPos; // Where the dragged node was put last
+
+	mutable AutomationLod m_levelsOfDetail;
+
 	static int s_quantization;
 
 	static const float DEFAULT_MIN_VALUE;
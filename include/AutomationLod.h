@@ -0,0 +1,128 @@
+/*
+ * AutomationLod.h - min/max pyramid of an automation curve for drawing it
+ *                   at any zoom level
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUTOMATION_LOD_H
+#define LMMS_AUTOMATION_LOD_H
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+ * Minimum and maximum of an automation curve per bucket of ticks, at several
+ * levels of detail. Level 0 holds one bucket per tick, and each further level
+ * merges two buckets of the level below, so drawing the curve costs about one
+ * bucket per pixel, however many nodes it has.
+ *
+ * Changes to the curve are marked with invalidate(), and update() only
+ * recomputes the buckets covering the changed ticks.
+ */
+class LMMS_EXPORT AutomationLod
+{
+public:
+	struct Bucket
+	{
+		float min;
+		float max;
+	};
+
+	//! Writes the value of the curve for each tick in [from, to) to the output
+	using Sampler = std::function<void(tick_t from, tick_t to, float* out)>;
+
+	//! Mark the curve between the ticks @p from and @p to (both included) as changed
+	void invalidate(tick_t from, tick_t to)
+	{
+		m_dirtyFrom = std::min(m_dirtyFrom, from);
+		m_dirtyTo = std::max(m_dirtyTo, to);
+	}
+
+	void invalidateAll()
+	{
+		invalidate(std::numeric_limits<tick_t>::min(), std::numeric_limits<tick_t>::max());
+	}
+
+	//! Drop all buckets, e.g. because the curve has no nodes
+	void clear();
+
+	//! Bring the buckets of the curve spanning the ticks [begin, end) up to date
+	void update(tick_t begin, tick_t end, const Sampler& sample);
+
+	tick_t begin() const { return m_begin; }
+	tick_t end() const { return m_end; }
+	bool isEmpty() const { return m_begin >= m_end; }
+
+	int levelCount() const { return static_cast<int>(m_levels.size()); }
+
+	//! Buckets of 2^level ticks each, the first one starting at begin()
+	const std::vector<Bucket>& level(int level) const { return m_levels[level]; }
+
+	//! The coarsest level that still has at least one bucket per pixel
+	int levelFor(float ticksPerPixel) const;
+
+	//! Call @p fn(firstTick, bucket) for each bucket of @p level that
+	//! overlaps the ticks [from, to)
+	template<class Fn>
+	void forEachBucket(int level, tick_t from, tick_t to, Fn&& fn) const
+	{
+		if (isEmpty()) { return; }
+
+		from = std::max(from, m_begin);
+		to = std::min(to, m_end);
+		if (from >= to) { return; }
+
+		const auto& buckets = m_levels[level];
+		const auto first = static_cast<std::size_t>(from - m_begin) >> level;
+		const auto last = std::min(static_cast<std::size_t>(to - 1 - m_begin) >> level, buckets.size() - 1);
+		for (auto i = first; i <= last; ++i)
+		{
+			fn(m_begin + static_cast<tick_t>(i << level), buckets[i]);
+		}
+	}
+
+private:
+	void resize(std::size_t ticks);
+
+	tick_t m_begin = 0;
+	tick_t m_end = 0;
+	std::vector<std::vector<Bucket>> m_levels;
+	std::vector<float> m_samples;
+
+	// Ticks whose buckets are out of date; initially everything
+	tick_t m_dirtyFrom = std::numeric_limits<tick_t>::min();
+	tick_t m_dirtyTo = std::numeric_limits<tick_t>::max();
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_AUTOMATION_LOD_H
@@ -27,10 +27,10 @@
 #define LMMS_GUI_CPU_LOAD_WIDGET_H
 
 #include <algorithm>
-#include <QTimer>
 #include <QPixmap>
 #include <QWidget>
 
+#include "AudioTelemetry.h"
 #include "LmmsTypes.h"
 
 
@@ -66,7 +66,7 @@ private:
 
 	bool m_changed;
 
-	QTimer m_updateTimer;
+	AudioTelemetry::Reader m_telemetryReader;
 
 	int m_stepSize = 1;
 
@@ -238,6 +238,10 @@ public:
 	// Returns true if the working dir (e.g. ~/lmms) exists on disk.
 	bool hasWorkingDir() const;
 
+	// Returns the directory for data that can be regenerated at any time,
+	// creating it if needed. Safe to call from any thread.
+	static QString cacheDir(const QString& subdir);
+
 	void addRecentlyOpenedProject(const QString & _file);
 
 	void addFavoriteItem(const QString& item);
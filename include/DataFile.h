@@ -27,11 +27,14 @@
 #define LMMS_DATA_FILE_H
 
 #include <map>
+#include <memory>
+#include <optional>
 #include <QDomDocument>
 #include <vector>
 
 #include "lmms_export.h"
 
+class QIODevice;
 class QTextStream;
 
 namespace lmms
@@ -75,6 +78,10 @@ public:
 
 	void write( QTextStream& strm );
 	bool writeFile(const QString& fn, bool withResources = false);
+	//! Write the file like writeFile() does without resources, but only log
+	//! errors instead of showing them. Unlike writeFile(), this can run on
+	//! any thread, as long as no other thread uses this DataFile meanwhile.
+	bool writeFileQuietly(const QString& fn, bool keepBackup);
 	bool copyResources(const QString& resourcesDir); //!< Copies resources to the resourcesDir and changes the DataFile to use local paths to them
 	bool hasLocalPlugins(QDomElement parent = QDomElement(), bool firstCall = true) const;
 
@@ -95,7 +102,14 @@ public:
 
 	unsigned int legacyFileVersion();
 
+	//! Return the binary data referenced by `attributeValue` if it refers to a
+	//! blob of a project container that is currently being loaded, or an empty
+	//! optional if the attribute holds its data inline (i.e. as base64)
+	static std::optional<QByteArray> embeddedData(const QString& attributeValue);
+
 private:
+	struct EmbeddedBlobs;
+
 	static Type type( const QString& typeName );
 	static QString typeName( Type type );
 
@@ -145,6 +159,22 @@ private:
 	using ResourcesMap = std::map<QString, std::vector<QString>>;
 	static const ResourcesMap ELEMENTS_WITH_RESOURCES;
 
+	// Map with DOM elements that embed binary data as base64 (moved to blob
+	// sections in project containers)
+	static const ResourcesMap ELEMENTS_WITH_EMBEDDED_DATA;
+
+	enum class WriteResult
+	{
+		Ok,
+		OpenFailed,
+		WriteFailed
+	};
+
+	//! Serialize the document to @p fullName, replacing the file atomically
+	WriteResult writeToDisk(const QString& fullName, bool keepBackup);
+	bool writeContainer(QIODevice& device);
+	void loadContainer(QIODevice& device, const QString& sourceFile);
+
 	void upgrade();
 
 	void loadData( const QByteArray & _data, const QString & _sourceFile );
@@ -154,6 +184,8 @@ private:
 	QDomElement m_head;
 	Type m_type;
 	unsigned int m_fileVersion;
+	//! Blobs read from a project container, shared between copies
+	std::shared_ptr<EmbeddedBlobs> m_embeddedBlobs;
 } ;
 
 
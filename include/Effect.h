@@ -28,6 +28,7 @@
 
 #include <span>
 
+#include "AudioBufferView.h"
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
 #include "Engine.h"
@@ -159,9 +160,30 @@ protected:
 	};
 
 	/**
-	 * The main audio processing method that runs when plugin is awake and running
+	 * The main audio processing method that runs when plugin is awake and running,
+	 * unless `usesPlanarBuffers` returns true
 	 */
-	virtual ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames) = 0;
+	virtual ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames)
+	{
+		(void)buf;
+		(void)frames;
+		return ProcessStatus::Continue;
+	}
+
+	/**
+	 * Method that runs instead of `processImpl` if `usesPlanarBuffers`
+	 * returns true. It processes the planar channels of the buffer in place.
+	 * Chains of such effects never convert between planar and interleaved
+	 * buffers, so new effects should prefer it.
+	 */
+	virtual ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> inOut)
+	{
+		(void)inOut;
+		return ProcessStatus::Continue;
+	}
+
+	//! Whether `processPlanarImpl` shall be used instead of `processImpl`
+	virtual bool usesPlanarBuffers() const { return false; }
 
 	/**
 	 * Optional method that runs instead of `processImpl` when an effect
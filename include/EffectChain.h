@@ -65,6 +65,9 @@ public:
 	void moveUp( Effect * _effect );
 	bool processAudioBuffer(AudioBuffer& buffer);
 
+	//! @returns true if any effect of the chain outputted infs/nans
+	bool isCorrupted() const;
+
 	void clear();
 
 
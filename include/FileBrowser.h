@@ -93,6 +93,7 @@ private:
 	void saveDirectoriesStates();
 	void restoreDirectoriesStates();
 
+	void indexDirectories();
 	void onSearch(const QString& filter);
 	void onSearchMatch(const QString& path);
 	void onSearchStarted();
@@ -156,6 +157,8 @@ private:
 	void previewFileItem(FileItem* file);
 	//! If a preview is playing, stop it.
 	void stopPreview();
+	//! Load the presets following a file item ahead of time, as browsing usually goes on with them
+	void preloadPresetsBelow(FileItem* file);
 
 	void handleFile( FileItem * fi, InstrumentTrack * it );
 	void openInNewInstrumentTrack( TrackContainer* tc, FileItem* item );
@@ -0,0 +1,159 @@
+/*
+ * FileIndex.h - persistent index of the directories shown in the file browser
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_GUI_FILE_INDEX_H
+#define LMMS_GUI_FILE_INDEX_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+class QFileInfo;
+
+namespace lmms::gui {
+//! The `FileIndex` class keeps the names and metadata of all files below the directories of the file browsers,
+//! so searching them does not have to walk the filesystem.
+//! The index is built and kept up to date on a background thread, and it is saved to the cache directory so it only
+//! needs to be checked for changes on the next start.
+class FileIndex : public QObject
+{
+	Q_OBJECT
+public:
+	//! An indexed file or directory.
+	struct Entry
+	{
+		QString name;			//! The file name.
+		QString suffix;			//! The complete suffix, as used by the file browser filters.
+		qint64 size = 0;		//! The size in bytes.
+		qint64 modified = 0;	//! The time of the last modification in ms since the epoch.
+		bool isDir = false;		//! Whether this is a directory.
+		bool isHidden = false;	//! Whether this is a hidden file or directory.
+		double duration = 0;	//! The length of audio files in seconds, 0 if unknown.
+		int sampleRate = 0;		//! The sample rate of audio files, 0 if unknown.
+	};
+
+	//! Return the global `FileIndex` instance.
+	static auto instance() -> FileIndex&;
+
+	//! Stop processing and destroy the object.
+	~FileIndex() override;
+
+	FileIndex(const FileIndex&) = delete;
+	FileIndex(FileIndex&&) = delete;
+	FileIndex& operator=(const FileIndex&) = delete;
+	FileIndex& operator=(FileIndex&&) = delete;
+
+	//! Index the directory tree at @p root in the background and keep it up to date.
+	void addRoot(const QString& root);
+
+	//! Return true if the directory tree at @p path is completely indexed and kept up to date.
+	auto isIndexed(const QString& path) const -> bool;
+
+	//! Call @p fn with the path and entry of everything below @p path whose name contains all @p tokens, ignoring
+	//! case, until it returns false. Hidden entries and the contents of hidden directories are left out unless
+	//! @p includeHidden is set.
+	void search(const QString& path, const QStringList& tokens, bool includeHidden,
+		const std::function<bool(const QString&, const Entry&)>& fn) const;
+
+	//! Return the entry of the file or directory at @p path, if it is indexed.
+	auto entry(const QString& path) const -> std::optional<Entry>;
+
+private:
+	struct Directory
+	{
+		qint64 modified = 0;		  //! The time of the last modification of the directory itself.
+		bool isHidden = false;		  //! Whether the directory or any directory above it is hidden.
+		std::vector<Entry> entries;	  //! The files and subdirectories.
+		QString names;				  //! The case folded names of the entries, each followed by a newline.
+		std::vector<int> nameOffsets; //! The position of each name within `names`.
+	};
+
+	struct Root
+	{
+		bool complete = false; //! Whether the whole tree has been indexed.
+		bool inUse = false;	   //! Whether a file browser shows the tree, so it is worth saving.
+		bool watched = true;   //! Whether all directories are watched, so changes to the tree are noticed.
+		QHash<QString, Directory> directories;
+	};
+
+	struct Job
+	{
+		enum class Type
+		{
+			Load,	 //! Load the saved index.
+			AddRoot, //! Build the index of a root, or check it for changes if it was loaded.
+			Rescan	 //! Update the index of a directory after it changed.
+		};
+
+		Type type;
+		QString path;
+	};
+
+	explicit FileIndex(QObject* parent);
+
+	void queueJob(Job job);
+	void runJobs();
+
+	void load();
+	void save() const;
+	void addRootInBackground(const QString& root);
+	void refresh(const QString& root);
+	void rescan(const QString& root, const QString& path, bool isHidden, bool recursive, QSet<QString>& visited,
+		QStringList& found);
+	void rescanChanged(const QString& path);
+	void watch(const QString& root, const QStringList& directories);
+	auto rootOf(const QString& path) const -> const QString*;
+
+	static void removeTree(Root& root, const QString& path);
+	static auto makeEntry(const QFileInfo& info, const Entry* previous) -> Entry;
+
+	static void indexNames(Directory& directory);
+
+	std::map<QString, Root> m_roots;
+	mutable std::shared_mutex m_rootsMutex;
+
+	std::deque<Job> m_jobs;
+	bool m_running = false;
+	bool m_changed = false;
+	std::mutex m_jobsMutex;
+	std::future<void> m_worker;
+	std::atomic<bool> m_stop = false;
+
+	QFileSystemWatcher m_watcher;
+};
+} // namespace lmms::gui
+
+#endif // LMMS_GUI_FILE_INDEX_H
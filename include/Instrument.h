@@ -35,6 +35,7 @@
 #include "TimePos.h"
 
 #include <cmath>
+#include <vector>
 
 
 namespace lmms
@@ -46,6 +47,7 @@ class MidiEvent;
 class NotePlayHandle;
 class Track;
 class SampleFrame;
+class ThreadableJob;
 
 
 class LMMS_EXPORT Instrument : public Plugin
@@ -78,6 +80,26 @@ public:
 	// output buffer only once per audio engine period
 	virtual void play( SampleFrame* _working_buffer );
 
+	// instruments rendering in another process can split play() into
+	// startPlay(), which hands the period off and returns true, and
+	// finishPlay(), which the audio engine calls once the other jobs of
+	// the period are done; returning false falls back to play()
+	virtual bool startPlay()
+	{
+		return false;
+	}
+
+	virtual void finishPlay( SampleFrame* /* _working_buffer */ )
+	{
+	}
+
+	// after startPlay() returned true, instruments can split their own
+	// rendering into jobs which the audio engine processes on all worker
+	// threads before calling finishPlay()
+	virtual void queueJobs( std::vector<ThreadableJob*>& /* _jobs */ )
+	{
+	}
+
 	// to be implemented by actual plugin
 	virtual void playNote( NotePlayHandle * /* _note_to_play */,
 					SampleFrame* /* _working_buf */ )
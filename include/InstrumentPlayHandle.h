@@ -25,6 +25,8 @@
 #ifndef LMMS_INSTRUMENT_PLAY_HANDLE_H
 #define LMMS_INSTRUMENT_PLAY_HANDLE_H
 
+#include <vector>
+
 #include "PlayHandle.h"
 #include "lmms_export.h"
 
@@ -33,6 +35,7 @@ namespace lmms
 
 class Instrument;
 class InstrumentTrack;
+class ThreadableJob;
 
 class LMMS_EXPORT InstrumentPlayHandle : public PlayHandle
 {
@@ -43,6 +46,11 @@ public:
 
 	void play(SampleFrame* working_buffer) override;
 
+	//! Collects the jobs of an instrument that deferred play() via Instrument::startPlay()
+	void queueJobs(std::vector<ThreadableJob*>& jobs);
+	//! Completes a play() that the instrument deferred via Instrument::startPlay()
+	void finishPlay();
+
 	bool isFinished() const override
 	{
 		return false;
@@ -51,7 +59,10 @@ public:
 	bool isFromTrack(const Track* track) const override;
 
 private:
+	void processOutput(SampleFrame* working_buffer);
+
 	Instrument* m_instrument;
+	SampleFrame* m_pendingBuffer = nullptr;
 };
 
 } // namespace lmms
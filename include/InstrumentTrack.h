@@ -234,6 +234,19 @@ public:
 	{
 		return m_previewMode;
 	}
+
+	//! While suspended, the InstrumentPlayHandle of the track renders nothing, so
+	//! e.g. presets can be loaded into preview tracks that are not playing without
+	//! contending with the audio threads. Only change this within a change in model.
+	void setRenderingSuspended(bool suspended)
+	{
+		m_renderingSuspended = suspended;
+	}
+
+	bool isRenderingSuspended() const
+	{
+		return m_renderingSuspended;
+	}
 	
 	void replaceInstrument(DataFile dataFile);
 
@@ -282,6 +295,7 @@ private:
 	bool m_silentBuffersProcessed;
 
 	bool m_previewMode;
+	bool m_renderingSuspended = false;
 
 	IntModel m_baseNoteModel;	//!< The "A4" or "440 Hz" key (default 69)
 	IntModel m_firstKeyModel;	//!< First key the instrument reacts to
@@ -30,14 +30,18 @@
 #include <ladspa.h>
 
 #include <QMap>
+#include <QMutex>
 #include <QPair>
 #include <QString>
 #include <QStringList>
+#include <QVariant>
 
 
 #include "lmms_export.h"
 #include "LmmsTypes.h"
 
+class QFileInfo;
+
 
 namespace lmms
 {
@@ -74,11 +78,18 @@ enum class LadspaPluginType
 
 struct LadspaManagerDescription
 {
+	//! Null until the library is first needed, as the rest of the
+	//! description may come from the metadata cache
 	LADSPA_Descriptor_Function descriptorFunction;
+	QString library;
 	uint32_t index;
 	LadspaPluginType type;
 	uint16_t inputChannels;
 	uint16_t outputChannels;
+	QString name;
+	QString maker;
+	QString copyright;
+	LADSPA_Properties properties;
 };
 
 class LMMS_EXPORT LadspaManager
@@ -330,8 +341,11 @@ public:
 						LADSPA_Handle _instance );
 
 private:
-	void  addPlugins( LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file );
+	QVariantList  addPlugins( LADSPA_Descriptor_Function _descriptor_func,
+						const QFileInfo & _file );
+	void  addPlugin( const QFileInfo & _file, const QVariantMap & _metadata,
+				LADSPA_Descriptor_Function _descriptor_func );
+	bool  loadLibrary( LadspaManagerDescription & _plugin );
 	uint16_t  getPluginInputs( const LADSPA_Descriptor * _descriptor );
 	uint16_t  getPluginOutputs( const LADSPA_Descriptor * _descriptor );
 
@@ -343,6 +357,7 @@ private:
 	using LadspaManagerMapType = QMap<ladspa_key_t, LadspaManagerDescription*>;
 	LadspaManagerMapType m_ladspaManagerMap;
 	l_sortable_plugin_t m_sortedPlugins;
+	QMutex m_libraryMutex;
 
 } ;
 
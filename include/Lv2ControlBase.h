@@ -121,6 +121,14 @@ protected:
 	void copyBuffersFromLmms(const SampleFrame* buf, f_cnt_t frames);
 	//! Copy our ports into buffers passed by LMMS
 	void copyBuffersToLmms(SampleFrame* buf, f_cnt_t frames) const;
+	//! Whether each processor maps its inputs and outputs 1:1 to channels,
+	//! so connectPlanarBuffers() can replace the copy functions
+	bool supportsPlanarBuffers() const;
+	//! Whether inputs and outputs must not be connected to the same buffers
+	bool inPlaceBroken() const;
+	//! Connect all processors to the DEFAULT_CHANNELS planar channels
+	//! @p in and @p out for the next run()
+	void connectPlanarBuffers(float* const* in, float* const* out);
 	//! Run the Lv2 plugin instance for @param frames frames
 	void run(f_cnt_t frames);
 
@@ -121,6 +121,7 @@ public:
 	Iterator begin() { return m_lv2InfoMap.begin(); }
 	Iterator end() { return m_lv2InfoMap.end(); }
 
+	LilvWorld* world() { return m_world; }
 	UridMap& uridMap() { return m_uridMap; }
 	const Lv2UridCache& uridCache() const { return m_uridCache; }
 	const std::set<std::string_view>& supportedFeatureURIs() const
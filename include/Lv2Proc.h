@@ -29,6 +29,8 @@
 
 #ifdef LMMS_HAVE_LV2
 
+#include <atomic>
+#include <future>
 #include <lilv/lilv.h>
 #include <memory>
 #include <optional>
@@ -149,6 +151,26 @@ public:
 	//! Run the Lv2 plugin instance for @param frames frames
 	void run(f_cnt_t frames);
 
+	/*
+		planar buffers (alternative to copyBuffersFromCore/copyBuffersToCore)
+	*/
+	//! Number of channels if the audio inputs and outputs map 1:1 to
+	//! channels, otherwise 0, meaning the buffers must be copied
+	unsigned planarChannels() const;
+	//! Whether the plugin forbids connecting an input and an output to the same buffer
+	bool inPlaceBroken() const { return m_inPlaceBroken; }
+	/**
+	 * Connect the audio ports directly to planar channel buffers for the next
+	 * run(), instead of copying through the port buffers. Realtime safe.
+	 * @param in first input channel of this processor
+	 * @param out first output channel of this processor. May be @p in, unless
+	 *   inPlaceBroken() is true.
+	 * @param num must be planarChannels()
+	 */
+	void connectPlanarBuffers(float* const* in, float* const* out, unsigned num);
+	//! Connect the audio ports back to the port buffers. Realtime safe.
+	void connectPortBuffers();
+
 	void handleMidiInputEvent(const class MidiEvent &event,
 		const TimePos &time, f_cnt_t offset);
 
@@ -180,10 +202,19 @@ private:
 	std::optional<Lv2Worker> m_worker;
 	Semaphore m_workLock; // this must be shared by different workers
 
+	// state
+	//! default state restore running on the worker pool, if any
+	std::future<void> m_stateRestore;
+	//! set while the default state restore is in progress, as run() must wait for it
+	std::atomic<bool> m_runBlockedByRestore = false;
+
 	// full list of ports
 	std::vector<std::unique_ptr<Lv2Ports::PortBase>> m_ports;
 	// quick reference to specific, unique ports
 	StereoPortRef m_inPorts, m_outPorts;
+	//! whether the audio ports are currently connected to external buffers
+	bool m_planarConnected = false;
+	bool m_inPlaceBroken = false;
 	Lv2Ports::AtomSeq *m_midiIn = nullptr, *m_midiOut = nullptr;
 
 	// MIDI
@@ -207,6 +238,8 @@ private:
 
 	void initMOptions(); //!< initialize m_options
 	void initPluginSpecificFeatures();
+	//! Restore the plugin's default state on the worker pool if the plugin requires it
+	void restoreDefaultState();
 
 	//! load a file in the plugin, but don't do anything in LMMS
 	void loadFileInternal(const QString &file);
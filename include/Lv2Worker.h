@@ -29,16 +29,66 @@
 
 #ifdef LMMS_HAVE_LV2
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
 #include <lv2/worker/worker.h>
+#include <mutex>
 #include <thread>
 #include <vector>
 
+#include "LocklessList.h"
 #include "LocklessRingBuffer.h"
 #include "LmmsSemaphore.h"
 
 namespace lmms
 {
 
+class Lv2Worker;
+
+/**
+	Bounded thread pool shared by all Lv2Worker instances
+
+	A worker with pending requests is queued once and gets one request handled
+	per turn, then goes to the back of the queue if it has more. This keeps
+	the work of one plugin instance serialized, as the worker extension
+	requires, and prevents a single busy plugin from starving the others.
+
+	Non-realtime code can also post other plugin work, like state restores.
+*/
+class Lv2WorkerPool
+{
+public:
+	static Lv2WorkerPool& instance();
+	~Lv2WorkerPool();
+
+	//! Queue a turn for @p worker; realtime safe
+	void schedule(Lv2Worker* worker);
+	//! Run @p task on one of the pool threads; not realtime safe
+	std::future<void> post(std::function<void()> task);
+
+private:
+	Lv2WorkerPool();
+	void threadFunc();
+	//! Move workers scheduled from the audio threads into m_queue, keeping their order
+	void collectScheduled();
+
+	static constexpr unsigned MaxThreads = 8;
+	//! Upper bound of workers waiting for a turn at the same time
+	static constexpr std::size_t MaxScheduled = 4096;
+
+	std::vector<std::thread> m_threads;
+	LocklessList<Lv2Worker*> m_scheduled;  //!< workers scheduled from realtime threads
+	std::deque<std::function<void()>> m_queue;  //!< tasks in the order they will be run
+	std::mutex m_queueMutex;  //!< guards m_queue and popping m_scheduled
+	Semaphore m_sem;  //!< counts the tasks that are not yet taken by a thread
+	std::atomic<bool> m_exit = false;
+};
+
+
+
+
 /**
 	Worker container
 */
@@ -64,8 +114,11 @@ public:
 	LV2_Worker_Status respond(uint32_t size, const void* data);
 
 private:
+	friend class Lv2WorkerPool;
+
 	// functions
-	void workerFunc();
+	//! Handle the oldest request; called by the pool for each turn
+	void workOnNextRequest();
 	std::size_t bufferSize() const;  //!< size of internal buffers
 
 	// parameters
@@ -75,12 +128,13 @@ private:
 	LV2_Worker_Schedule m_scheduleFeature;
 
 	// threading/synchronization
-	std::thread m_thread;
-	std::vector<char> m_response;  //!< buffer where single requests from m_requests are unpacked
+	std::vector<char> m_request;  //!< buffer where single requests from m_requests are unpacked
+	std::vector<char> m_response;  //!< buffer where single responses from m_responses are unpacked
 	LocklessRingBuffer<char> m_requests, m_responses;  //!< ringbuffer to queue multiple requests
 	LocklessRingBufferReader<char> m_requestsReader, m_responsesReader;
-	std::atomic<bool> m_exit = false;  //!< Whether the worker function should keep looping
-	Semaphore m_sem;
+	//! Requests not handled yet; the worker is queued in the pool while this is non-zero
+	std::atomic<uint32_t> m_pendingRequests = 0;
+	std::atomic<bool> m_exit = false;  //!< Whether pending requests should be dropped
 	Semaphore* m_workLock;
 };
 
@@ -31,6 +31,8 @@
 #include <QMainWindow>
 #include <QMdiArea>
 
+#include <optional>
+
 #include "ConfigManager.h"
 
 class QAction;
@@ -239,6 +241,8 @@ private:
 	QBasicTimer m_updateTimer;
 	QTimer m_autoSaveTimer;
 	int m_autoSaveInterval;
+	//! Song::modificationCount() when the recovery file was last written
+	std::optional<unsigned> m_autoSavedModificationCount;
 
 	friend class GuiApplication;
 
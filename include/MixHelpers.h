@@ -46,6 +46,27 @@ void add( SampleFrame* dst, const SampleFrame* src, int frames );
 /*! \brief Add samples from src to dst */
 void add(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src);
 
+/*! \brief Add interleaved samples from src to the stereo channels of dst */
+void add(PlanarBufferView<sample_t> dst, const SampleFrame* src);
+
+/*! \brief Add samples from src multiplied by coeffSrc to dst */
+void addMultiplied(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc);
+
+/*! \brief Add the stereo channels of src multiplied by coeffSrc to the interleaved dst */
+void addMultiplied(SampleFrame* dst, PlanarBufferView<const sample_t> src, float coeffSrc);
+
+/*! \brief Add samples from src multiplied by coeffSrc and coeffSrcBuf to dst */
+void addMultipliedByBuffer(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc,
+	ValueBuffer* coeffSrcBuf);
+
+/*! \brief Add the stereo channels of src multiplied by coeffSrc and coeffSrcBuf to the interleaved dst */
+void addMultipliedByBuffer(SampleFrame* dst, PlanarBufferView<const sample_t> src, float coeffSrc,
+	ValueBuffer* coeffSrcBuf);
+
+/*! \brief Add samples from src multiplied by coeffSrcBuf1 and coeffSrcBuf2 to dst */
+void addMultipliedByBuffers(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	ValueBuffer* coeffSrcBuf1, ValueBuffer* coeffSrcBuf2);
+
 /*! \brief Multiply samples from `dst` by `coeff` */
 void multiply(SampleFrame* dst, float coeff, int frames);
 
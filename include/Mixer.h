@@ -26,6 +26,7 @@
 #define LMMS_MIXER_H
 
 #include "AudioBuffer.h"
+#include "AudioTelemetry.h"
 #include "EffectChain.h"
 #include "JournallingObject.h"
 #include "Model.h"
@@ -53,8 +54,8 @@ public:
 	// set to true if any effect in the channel is enabled and running
 	bool m_stillRunning;
 
-	float m_peakLeft;
-	float m_peakRight;
+	//! levels of the last period, published through AudioTelemetry
+	AudioTelemetry::ChannelLevels m_levels;
 	AudioBuffer m_buffer;
 	bool m_muteBeforeSolo;
 	BoolModel m_muteModel;
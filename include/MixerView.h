@@ -27,6 +27,7 @@
 
 #include <QWidget>
 
+#include "AudioTelemetry.h"
 #include "MixerChannelView.h"
 #include "ModelView.h"
 #include "SerializingObject.h"
@@ -122,6 +123,7 @@ private:
 	QStackedLayout* m_racksLayout;
 	QWidget* m_racksWidget;
 	Mixer* m_mixer;
+	AudioTelemetry::Reader m_telemetryReader;
 
 	void updateMaxChannelSelector();
 
@@ -0,0 +1,94 @@
+/*
+ * NoteIndex.h - time x key index for finding the notes within a region
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_NOTE_INDEX_H
+#define LMMS_NOTE_INDEX_H
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "Note.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+ * An index over a vector of notes for finding those which overlap a range of
+ * ticks and keys, e.g. the visible part of the piano roll, without going
+ * through all notes of the clip.
+ *
+ * The notes are put into one bucket per key and sorted by position. As each
+ * bucket knows the length of its longest note, a query only has to look at
+ * the notes of a bucket which start between the query start minus that length
+ * and the query end.
+ *
+ * The index stores pointers, so it has to be rebuilt when the indexed notes
+ * change or are deleted.
+ */
+class LMMS_EXPORT NoteIndex
+{
+public:
+	//! Returns the last tick a note covers, or a tick before its position to leave it out
+	using EndFunction = std::function<tick_t(const Note&)>;
+
+	//! Index @p notes, which cover the ticks from their position to @p end
+	void rebuild(const NoteVector& notes, const EndFunction& end);
+	void clear();
+
+	//! Write the notes on keys [@p lowKey, @p highKey] which overlap ticks
+	//! [@p start, @p end] to @p result, in the order of the indexed vector
+	void query(tick_t start, tick_t end, int lowKey, int highKey, NoteVector& result) const;
+
+	std::size_t size() const { return m_size; }
+
+private:
+	struct Entry
+	{
+		tick_t start;
+		tick_t end;
+		std::size_t order;
+		Note* note;
+	};
+
+	struct Bucket
+	{
+		std::vector<Entry> entries;
+		tick_t maxLength = 0;
+	};
+
+	std::array<Bucket, NumKeys> m_buckets;
+	std::size_t m_size = 0;
+
+	//! Reused between queries to keep them from allocating
+	mutable std::vector<const Entry*> m_hits;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_NOTE_INDEX_H
@@ -28,15 +28,9 @@
 #include <QWidget>
 #include <QPixmap>
 
+#include "AudioTelemetry.h"
 #include "LmmsTypes.h"
 
-namespace lmms
-{
-
-class SampleFrame;
-
-}
-
 namespace lmms::gui
 {
 
@@ -74,7 +68,7 @@ protected:
 
 
 protected slots:
-	void updateAudioBuffer(const lmms::SampleFrame* buffer);
+	void updateAudioBuffer();
 
 private:
 	bool clips(float level) const;
@@ -90,6 +84,8 @@ private:
 	QColor m_rightChannelColor;
 	QColor m_otherChannelsColor;
 	QColor m_clippingColor;
+
+	AudioTelemetry::Reader m_telemetryReader;
 } ;
 
 
@@ -27,14 +27,17 @@
 #ifndef LMMS_GUI_PIANO_ROLL_H
 #define LMMS_GUI_PIANO_ROLL_H
 
+#include <QPixmap>
 #include <QWidget>
 
+#include <bitset>
 #include <vector>
 
 #include "Editor.h"
 #include "ComboBoxModel.h"
 #include "SerializingObject.h"
 #include "Note.h"
+#include "NoteIndex.h"
 #include "LmmsTypes.h"
 #include "Song.h"
 #include "StepRecorder.h"
@@ -183,6 +186,9 @@ protected:
 	void mouseReleaseEvent( QMouseEvent * me ) override;
 	void mouseMoveEvent( QMouseEvent * me ) override;
 	void paintEvent( QPaintEvent * pe ) override;
+	//! Redraw the cached layers painted below the overlay if their contents changed
+	void renderGridLayer(int topKey, bool drawNoteNames);
+	void renderNoteLayer(int topKey, bool drawNoteNames);
 	void resizeEvent( QResizeEvent * re ) override;
 	void wheelEvent( QWheelEvent * we ) override;
 	void focusOutEvent( QFocusEvent * ) override;
@@ -277,6 +283,56 @@ private:
 		Count // make sure this one is always last
 	};
 
+	//! What the cached grid layer depends on
+	struct GridLayerKey
+	{
+		QSize size;
+		qreal pixelRatio = 0;
+		int position = 0;
+		int startKey = 0;
+		int topKey = 0;
+		int pianoKeysVisible = 0;
+		int notesEditHeight = 0;
+		int ppb = 0;
+		int whiteKeyWidth = 0;
+		int keyLineHeight = 0;
+		int zoom = 0;
+		int quantization = 0;
+		int timeSigNumerator = 0;
+		int timeSigDenominator = 0;
+		NoteEditMode noteEditMode = NoteEditMode::Volume;
+		bool drawNoteNames = false;
+		QList<int> markedSemiTones;
+		std::bitset<NumKeys> mappedKeys;
+		std::bitset<NumKeys> pressedKeys;
+
+		bool operator==(const GridLayerKey&) const = default;
+	};
+
+	//! What the cached note layer depends on
+	struct NoteLayerKey
+	{
+		QSize size;
+		qreal pixelRatio = 0;
+		int position = 0;
+		int startKey = 0;
+		int topKey = 0;
+		int pianoKeysVisible = 0;
+		int notesEditHeight = 0;
+		int ppb = 0;
+		int whiteKeyWidth = 0;
+		int keyLineHeight = 0;
+		NoteEditMode noteEditMode = NoteEditMode::Volume;
+		EditMode editMode = EditMode::Draw;
+		bool drawNoteNames = false;
+		const MidiClip* clip = nullptr;
+		std::size_t notesGeometry = 0;
+		std::size_t notesAppearance = 0;
+		std::size_t ghostNotesGeometry = 0;
+
+		bool operator==(const NoteLayerKey&) const = default;
+	};
+
 	enum class KeyType
 	{
 		WhiteSmall,
@@ -381,6 +437,19 @@ private:
 	MidiClip* m_midiClip;
 	NoteVector m_ghostNotes;
 
+	QPixmap m_gridLayer;
+	QPixmap m_noteLayer;
+	GridLayerKey m_gridLayerKey;
+	NoteLayerKey m_noteLayerKey;
+
+	//! The notes of the clip and the ghost notes by position and key, for painting only
+	NoteIndex m_noteIndex;
+	NoteIndex m_ghostNoteIndex;
+	const MidiClip* m_indexedMidiClip = nullptr;
+	std::size_t m_indexedNotesHash = 0;
+	std::size_t m_indexedGhostNotesHash = 0;
+	NoteVector m_visibleNotes;
+
 	inline const NoteVector & ghostNotes() const
 	{
 		return m_ghostNotes;
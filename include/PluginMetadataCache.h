@@ -0,0 +1,89 @@
+/*
+ * PluginMetadataCache.h - persistent cache of plugin scan results
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PLUGIN_METADATA_CACHE_H
+#define LMMS_PLUGIN_METADATA_CACHE_H
+
+#include <optional>
+#include <QByteArray>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVariant>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+ * Remembers metadata that is expensive to obtain from plugin files, so that
+ * plugins do not have to be loaded or probed at every start.
+ *
+ * Entries are stored per key (usually the plugin file) together with the
+ * paths, sizes and modification times of the files they were read from, and
+ * are only returned while none of those files changed. The whole cache is discarded if it
+ * was written for a different context, e.g. another LMMS version.
+ */
+class LMMS_EXPORT PluginMetadataCache
+{
+public:
+	//! @param name File name of the cache inside the cache directory
+	//! @param context Anything the cached results depend on
+	PluginMetadataCache(const QString& name, const QString& context);
+
+	//! Return the metadata stored for `key` if `file` did not change since
+	std::optional<QVariant> find(const QString& key, const QFileInfo& file);
+	//! Return the metadata stored for `key` if none of `files` changed since
+	std::optional<QVariant> find(const QString& key, const QList<QFileInfo>& files);
+
+	void insert(const QString& key, const QFileInfo& file, const QVariant& metadata);
+	void insert(const QString& key, const QList<QFileInfo>& files, const QVariant& metadata);
+
+	//! Write the cache if anything changed. Entries that were neither found
+	//! nor inserted since loading belong to removed plugins and are dropped.
+	void save();
+
+private:
+	struct Entry
+	{
+		QByteArray stamp; //!< Identifies the state of the files the metadata was read from
+		QVariant metadata;
+		bool used = false;
+	};
+
+	static QByteArray stamp(const QList<QFileInfo>& files);
+
+	void load();
+
+	QString m_fileName;
+	QString m_context;
+	QHash<QString, Entry> m_entries;
+	bool m_modified = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_PLUGIN_METADATA_CACHE_H
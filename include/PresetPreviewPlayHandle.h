@@ -39,6 +39,10 @@ class PreviewTrackContainer;
 class LMMS_EXPORT PresetPreviewPlayHandle : public PlayHandle
 {
 public:
+	//! Number of preview tracks, i.e. the playing one and the ones for
+	//! presets loaded ahead of time
+	static constexpr std::size_t PoolSize = 3;
+
 	PresetPreviewPlayHandle( const QString& presetFile, bool loadByPlugin = false, DataFile *dataFile = 0 );
 	~PresetPreviewPlayHandle() override;
 
@@ -52,6 +56,10 @@ public:
 
 	bool isFromTrack( const Track * _track ) const override;
 
+	//! Load a preset into an idle preview track in the background, so
+	//! previewing it next starts right away
+	static void preload(const QString& presetFile, bool loadByPlugin);
+
 	static void init();
 	static void cleanup();
 	static ConstNotePlayHandleList nphsOfInstrumentTrack( const InstrumentTrack* instrumentTrack );
@@ -62,6 +70,7 @@ public:
 private:
 	static PreviewTrackContainer* s_previewTC;
 
+	InstrumentTrack* m_previewTrack;
 	NotePlayHandle* m_previewNote;
 
 } ;
@@ -0,0 +1,82 @@
+/*
+ * ProjectContainer.h - binary project container with a compressed XML part
+ *                      and raw sections for embedded binary data
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PROJECT_CONTAINER_H
+#define LMMS_PROJECT_CONTAINER_H
+
+#include <optional>
+#include <QByteArray>
+#include <vector>
+
+#include "lmms_export.h"
+
+class QIODevice;
+
+namespace lmms
+{
+
+/**
+ * Reads and writes the .mmpx project container.
+ *
+ * The file starts with an 8 byte magic and a format version, followed by a
+ * sequence of sections. Each section has a header (type, flags, stored size,
+ * raw size) and its payload. The first section holds the project XML,
+ * zstd-compressed when LMMS is built with zstd. It is followed by one raw,
+ * uncompressed section per blob of embedded binary data (e.g. samples), so
+ * that neither base64 encoding nor a decompression pass is needed for them.
+ * All integers are little endian. Sections are read sequentially, so the
+ * XML can be consumed without reading any blob.
+ */
+class LMMS_EXPORT ProjectContainer
+{
+public:
+	struct Contents
+	{
+		QByteArray xml;
+		std::vector<QByteArray> blobs;
+	};
+
+	//! File extension used for containers
+	static constexpr const char* Extension = "mmpx";
+
+	//! Test whether `device` starts with a container header, without consuming it
+	static bool isContainer(QIODevice& device);
+
+	static bool write(QIODevice& device, const QByteArray& xml, const std::vector<QByteArray>& blobs);
+
+	//! Read a container, or return an empty optional if it is invalid or
+	//! uses a compression method this build does not support
+	static std::optional<Contents> read(QIODevice& device);
+
+	//! Read only the XML section of a container
+	static std::optional<QByteArray> readXml(QIODevice& device);
+
+	//! Whether this build compresses the XML section
+	static bool supportsCompression();
+};
+
+} // namespace lmms
+
+#endif // LMMS_PROJECT_CONTAINER_H
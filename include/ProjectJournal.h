@@ -25,8 +25,11 @@
 #ifndef LMMS_PROJECT_JOURNAL_H
 #define LMMS_PROJECT_JOURNAL_H
 
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <QByteArray>
 #include <QHash>
-#include <QStack>
 
 #include "LmmsTypes.h"
 #include "DataFile.h"
@@ -39,11 +42,23 @@ namespace lmms
 class JournallingObject;
 
 
-//! @warning many parts of this class may be rewritten soon
+/**
+ * Keeps the undo and redo history of all journalling objects.
+ *
+ * Checkpoints are stored as serialized XML. The newest undo checkpoint of
+ * each object is kept in full, while older checkpoints of the same object are
+ * reduced in the background to a delta against the next newer one. The undo
+ * history is bounded by a memory budget rather than a number of steps.
+ *
+ * @warning many parts of this class may be rewritten soon
+ */
 class ProjectJournal
 {
 public:
-	static const int MAX_UNDO_STATES;
+	//! Default memory budget of the undo history in MiB
+	static constexpr int DEFAULT_UNDO_BUDGET_MB = 64;
+	static constexpr int MIN_UNDO_BUDGET_MB = 8;
+	static constexpr int MAX_UNDO_BUDGET_MB = 1024;
 
 	ProjectJournal();
 	virtual ~ProjectJournal() = default;
@@ -104,20 +119,33 @@ private:
 
 	struct CheckPoint
 	{
-		CheckPoint( jo_id_t initID = 0, const DataFile& initData = DataFile( DataFile::Type::JournalData ) ) :
-			joID( initID ),
-			data( initData )
-		{
-		}
-		jo_id_t joID;
-		DataFile data;
+		jo_id_t joID = 0;
+		//! The serialized state, or a delta against the next newer
+		//! checkpoint of the same object if `isDelta` is set
+		QByteArray data;
+		bool isDelta = false;
+		//! Delta being computed in the background
+		std::shared_future<QByteArray> pendingDelta;
 	} ;
-	using CheckPointStack = QStack<CheckPoint>;
+	using CheckPointStack = std::deque<CheckPoint>;
+
+	static QByteArray serializeState( JournallingObject* jo );
+	static std::size_t undoBudget();
+
+	void pushUndoCheckPoint( jo_id_t id, QByteArray state );
+
+	//! Take over deltas that finished computing in the background
+	void collectDeltas();
+	//! Make the newest remaining undo checkpoint of `id` a full state again
+	//! after `newer` was taken off the stack
+	void expandPredecessor( jo_id_t id, const QByteArray& newer );
+	void trimUndoHistory();
 
 	JoIdMap m_joIDs;
 
 	CheckPointStack m_undoCheckPoints;
 	CheckPointStack m_redoCheckPoints;
+	std::size_t m_undoBytes;
 
 	bool m_journalling;
 
@@ -28,8 +28,12 @@
 #include <QThread>
 #include <QProcess>
 #include <QRecursiveMutex>
+#include <QTimer>
+#include <array>
+#include <atomic>
 
 #include "RemotePluginBase.h"
+#include "RemoteProcessChannel.h"
 #include "SharedMemory.h"
 #include "LmmsTypes.h"
 
@@ -100,6 +104,15 @@ public:
 
 	bool process( const SampleFrame* _in_buf, SampleFrame* _out_buf );
 
+	//! First half of process(): hands the next period to the remote process.
+	//! With a RemoteProcessChannel this returns right away, so several remote
+	//! plugins can run concurrently while the caller does other work; with
+	//! the message protocol the whole round trip still happens here.
+	bool startProcessing( const SampleFrame* _in_buf );
+	//! Second half of process(): waits for the period started by
+	//! startProcessing() and copies the result to @p _out_buf
+	bool finishProcessing( SampleFrame* _out_buf );
+
 	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset );
 
 	void updateSampleRate( sample_rate_t _sr )
@@ -156,6 +169,12 @@ protected:
 	bool m_failed;
 private:
 	void resizeSharedProcessingMemory();
+	std::string createProcessChannel();
+	bool waitForProcessChannel();
+	//! Keeps an event that did not fit into the ring of m_processChannel for later
+	void queueMidiEvent( const RemoteProcessChannel::MidiEntry& entry );
+	//! Moves as many queued events into the ring as fit, oldest first
+	void flushMidiOverflow();
 
 
 	QProcess m_process;
@@ -170,6 +189,25 @@ private:
 	SharedMemory<float[]> m_audioBuffer;
 	std::size_t m_audioBufferSize;
 
+	//! Set up on request of the client; used instead of
+	//! IdStartProcessing/IdProcessingDone and IdMidiEvent once valid
+	RemoteProcessChannel m_processChannel;
+	bool m_processingStarted = false;
+
+	//! MIDI events that did not fit into the ring of m_processChannel, oldest
+	//! first. They go into the ring before any later event and before the next
+	//! period is requested.
+	static constexpr std::size_t MidiOverflowSize = 256;
+	std::array<RemoteProcessChannel::MidiEntry, MidiOverflowSize> m_midiOverflow;
+	std::size_t m_midiOverflowCount = 0;
+	//! Channels that lost a note-off because even m_midiOverflow was full; each
+	//! gets an all-notes-off once m_midiOverflow is flushed
+	std::uint16_t m_pendingAllNotesOff = 0;
+	//! MIDI events dropped on the audio thread, reported by
+	//! m_midiDropReporter from the thread that created the plugin
+	std::atomic<std::size_t> m_droppedMidiEvents = 0;
+	QTimer m_midiDropReporter;
+
 	int m_inputCount;
 	int m_outputCount;
 
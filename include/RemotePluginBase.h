@@ -344,6 +344,8 @@ enum RemoteMessageIDs
 	IdLoadPresetFile,
 	IdDebugMessage,
 	IdIdle,
+	IdEnableProcessChannel,
+	IdProcessChannelKey,
 	IdUserBase = 64
 } ;
 
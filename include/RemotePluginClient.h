@@ -29,6 +29,14 @@
 
 #include <stdexcept>
 
+#include "RemoteProcessChannel.h"
+
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+#	include <atomic>
+#	include <mutex>
+#	include <thread>
+#endif
+
 #ifndef LMMS_BUILD_WIN32
 #	include <condition_variable>
 #	include <mutex>
@@ -124,6 +132,20 @@ public:
 	}
 
 
+protected:
+	//! Asks the host for a RemoteProcessChannel and, if it provides one, runs
+	//! all further processing requests and MIDI events on a dedicated thread
+	//! instead of the message loop. Clients opting in must be able to process
+	//! concurrently with their message handling (see processChannelRequest())
+	//! and must call disableProcessChannel() before they are destroyed.
+	void enableProcessChannel();
+	void disableProcessChannel();
+
+	//! Handles one period received through the process channel. Runs on the
+	//! processing thread; override to take any lock the message loop holds.
+	virtual void processChannelRequest();
+
+
 private:
 	void setShmKey(const std::string& key);
 	void doProcessing();
@@ -131,6 +153,16 @@ private:
 	SharedMemory<float[]> m_audioBuffer;
 	SharedMemory<const VstSyncData> m_vstSyncData;
 
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+	void attachProcessChannel(const std::string& key);
+	void processChannelLoop();
+
+	RemoteProcessChannel m_processChannel;
+	std::thread m_processThread;
+	std::atomic<bool> m_processThreadQuit = false;
+	std::mutex m_audioBufferMutex; // guards m_audioBuffer against setShmKey()
+#endif
+
 	int m_inputCount;
 	int m_outputCount;
 
@@ -221,6 +253,7 @@ RemotePluginClient::RemotePluginClient( const char * socketPath ) :
 
 RemotePluginClient::~RemotePluginClient()
 {
+	disableProcessChannel();
 	sendMessage( IdQuit );
 
 #ifndef SYNC_WITH_SHM_FIFO
@@ -305,6 +338,12 @@ bool RemotePluginClient::processMessage( const message & _m )
 			setShmKey(_m.getString(0));
 			break;
 
+		case IdProcessChannelKey:
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+			attachProcessChannel(_m.getString(0));
+#endif
+			break;
+
 		case IdInitDone:
 			break;
 
@@ -329,6 +368,9 @@ bool RemotePluginClient::processMessage( const message & _m )
 
 void RemotePluginClient::setShmKey(const std::string& key)
 {
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+	const auto lock = std::lock_guard{m_audioBufferMutex};
+#endif
 	try
 	{
 		m_audioBuffer.attach(key);
@@ -357,6 +399,89 @@ void RemotePluginClient::doProcessing()
 }
 
 
+
+
+void RemotePluginClient::enableProcessChannel()
+{
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+	// the reply is handled in processMessage()
+	sendMessage( IdEnableProcessChannel );
+	waitForMessage( IdProcessChannelKey );
+#endif
+}
+
+
+
+
+void RemotePluginClient::disableProcessChannel()
+{
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+	if (m_processThread.joinable())
+	{
+		m_processThreadQuit = true;
+		m_processThread.join();
+	}
+	m_processChannel.detach();
+#endif
+}
+
+
+
+
+void RemotePluginClient::processChannelRequest()
+{
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+	m_processChannel.drainMidiEvents([this](const RemoteProcessChannel::MidiEntry& e) {
+		processMidiEvent(MidiEvent(static_cast<MidiEventTypes>(e.type), e.channel, e.param0, e.param1), e.offset);
+	});
+
+	const auto lock = std::lock_guard{m_audioBufferMutex};
+	doProcessing();
+#endif
+}
+
+
+
+
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+void RemotePluginClient::attachProcessChannel(const std::string& key)
+{
+	// an empty key means the host can't provide a channel; keep using messages
+	if (key.empty() || m_processThread.joinable()) { return; }
+
+	try
+	{
+		m_processChannel.attach(key);
+	}
+	catch (const std::runtime_error& error)
+	{
+		debugMessage(std::string{"failed attaching process channel: "} + error.what() + '\n');
+		return;
+	}
+
+	m_processThreadQuit = false;
+	m_processThread = std::thread{&RemotePluginClient::processChannelLoop, this};
+}
+
+
+
+
+void RemotePluginClient::processChannelLoop()
+{
+	using namespace std::chrono_literals;
+	while (!m_processThreadQuit)
+	{
+		// wake up regularly to notice shutdown
+		if (m_processChannel.waitForRequest(100ms))
+		{
+			processChannelRequest();
+			m_processChannel.signalProcessingDone();
+		}
+	}
+}
+#endif // LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+
+
 } // namespace lmms
 
 #endif // LMMS_REMOTE_PLUGIN_CLIENT_H
@@ -0,0 +1,168 @@
+/*
+ * RemoteProcessChannel.h - shared-memory fast path for remote plugin processing
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_REMOTE_PROCESS_CHANNEL_H
+#define LMMS_REMOTE_PROCESS_CHANNEL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "Hardware.h"
+#include "SharedMemory.h"
+#include "lmmsconfig.h"
+
+// Wine-hosted clients are built for the Windows API and cannot make raw syscalls
+#if defined(LMMS_BUILD_LINUX) && !defined(_WIN32)
+#	define LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+#endif
+
+namespace lmms
+{
+
+namespace detail
+{
+
+//! Layout of the shared block. Everything is plain data so it can live in
+//! SharedMemory; the counters are only ever accessed through std::atomic_ref.
+struct RemoteProcessChannelData
+{
+	static constexpr std::uint32_t MidiRingSize = 1024; // must be a power of two
+
+	struct MidiEntry
+	{
+		std::int32_t type;
+		std::int32_t channel;
+		std::int32_t param0;
+		std::int32_t param1;
+		std::int32_t offset;
+	};
+
+	// written by the host
+	alignas(hardware_destructive_interference_size) std::uint32_t requestSeq;
+	std::uint32_t clientWaiting;
+	std::uint32_t midiHead;
+
+	// written by the client
+	alignas(hardware_destructive_interference_size) std::uint32_t doneSeq;
+	std::uint32_t hostWaiting;
+	std::uint32_t midiTail;
+
+	alignas(hardware_destructive_interference_size) MidiEntry midi[MidiRingSize];
+};
+
+} // namespace detail
+
+
+/**
+ * Signalling path between RemotePlugin and RemotePluginClient that bypasses
+ * the message socket/FIFO for the per-period work.
+ *
+ * The host pushes MIDI events into a single-producer/single-consumer ring and
+ * bumps a request counter; the client drains the ring, processes the shared
+ * audio buffer in place and publishes the same counter back. Either side
+ * spins briefly before sleeping on a futex, and the spin budget adapts to how
+ * long the other side usually takes to answer.
+ *
+ * Only available where LMMS_HAVE_REMOTE_PROCESS_CHANNEL is defined; elsewhere
+ * the classic IdStartProcessing/IdProcessingDone messages are used.
+ */
+class RemoteProcessChannel
+{
+public:
+	using Data = detail::RemoteProcessChannelData;
+	using MidiEntry = Data::MidiEntry;
+
+	RemoteProcessChannel() = default;
+	RemoteProcessChannel(const RemoteProcessChannel&) = delete;
+	RemoteProcessChannel& operator=(const RemoteProcessChannel&) = delete;
+
+	void create();
+	void attach(const std::string& key);
+	void detach() noexcept;
+
+	const std::string& key() const noexcept { return m_data.key(); }
+	explicit operator bool() const noexcept { return static_cast<bool>(m_data); }
+
+	// host side
+
+	//! @returns false if the ring is full; the event must then be sent another way
+	bool pushMidiEvent(const MidiEntry& entry);
+	void requestProcessing();
+	//! Waits until the client finished the last request
+	//! @returns false on timeout
+	bool waitForProcessingDone(std::chrono::milliseconds timeout);
+
+	// client side
+
+	//! Waits until the host issued a new request
+	//! @returns false on timeout
+	bool waitForRequest(std::chrono::milliseconds timeout);
+	template<typename F>
+	void drainMidiEvents(F&& handler);
+	void signalProcessingDone();
+
+private:
+	class Spinner
+	{
+	public:
+		//! Spins on @p word until it differs from @p old, then sleeps on it
+		//! while announcing itself through @p waiting
+		bool wait(std::uint32_t& word, std::uint32_t old, std::uint32_t& waiting,
+			std::chrono::milliseconds timeout);
+
+	private:
+		static constexpr int MinSpins = 16;
+		static constexpr int MaxSpins = 16384;
+		int m_spins = 256;
+	};
+
+	static void wake(std::uint32_t& word, std::uint32_t& waiting);
+
+	SharedMemory<Data> m_data;
+
+	std::uint32_t m_request = 0; // last request issued (host) or seen (client)
+	Spinner m_spinner;
+};
+
+
+
+
+template<typename F>
+void RemoteProcessChannel::drainMidiEvents(F&& handler)
+{
+	const auto head = std::atomic_ref{m_data->midiHead}.load(std::memory_order_acquire);
+	auto tail = std::atomic_ref{m_data->midiTail};
+	for (auto pos = tail.load(std::memory_order_relaxed); pos != head; ++pos)
+	{
+		handler(m_data->midi[pos & (Data::MidiRingSize - 1)]);
+		tail.store(pos + 1, std::memory_order_release);
+	}
+}
+
+
+} // namespace lmms
+
+#endif // LMMS_REMOTE_PROCESS_CHANNEL_H
@@ -0,0 +1,83 @@
+/*
+ * RepaintScheduler.h - coalesces repaints of model views changed from other threads
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_GUI_REPAINT_SCHEDULER_H
+#define LMMS_GUI_REPAINT_SCHEDULER_H
+
+#include <QBasicTimer>
+#include <QObject>
+#include <QPointer>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "lmms_export.h"
+
+class QWidget;
+
+namespace lmms {
+class Model;
+}
+
+namespace lmms::gui {
+
+//! The `RepaintScheduler` class updates widgets when their models change, without flooding the GUI thread.
+//! Changes made on the GUI thread update the widget right away. Changes made on other threads, e.g. by automation
+//! or controllers on the audio thread, only mark the widget dirty, and each dirty widget that is visible is updated
+//! once per display frame. Dirty widgets that are hidden are updated once they are shown again.
+class LMMS_EXPORT RepaintScheduler : public QObject
+{
+	Q_OBJECT
+public:
+	//! Call @p update whenever the data of @p model changes, as described above.
+	//! The connection ends when @p widget or @p model is destroyed, or when @p model is disconnected from @p widget.
+	static void connectDataChanged(Model* model, QWidget* widget, std::function<void()> update);
+
+protected:
+	void timerEvent(QTimerEvent* event) override;
+	bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+	struct Entry
+	{
+		QPointer<QWidget> widget;
+		std::function<void()> update;
+		std::atomic<bool> dirty = false;
+	};
+
+	RepaintScheduler();
+	static auto instance() -> RepaintScheduler&;
+
+	void markDirty(Entry& entry);
+	static void runIfDirty(Entry& entry);
+
+	std::vector<std::weak_ptr<Entry>> m_entries; //!< Only accessed from the GUI thread
+	std::atomic<bool> m_anyDirty = false;
+	QBasicTimer m_timer;
+};
+
+} // namespace lmms::gui
+
+#endif // LMMS_GUI_REPAINT_SCHEDULER_H
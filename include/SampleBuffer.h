@@ -84,6 +84,7 @@ public:
 	static auto emptyBuffer() -> std::shared_ptr<const SampleBuffer>;
 
 	static std::shared_ptr<const SampleBuffer> fromFile(const QString& path);
+	//! `str` may also be a reference to data embedded in a project container being loaded
 	static std::shared_ptr<const SampleBuffer> fromBase64(
 		const QString& str, int sampleRate = Engine::audioEngine()->outputSampleRate());
 
@@ -28,6 +28,7 @@
 #include "ClipView.h"
 
 #include "SampleThumbnail.h"
+#include "SampleWaveformTiles.h"
 
 namespace lmms
 {
@@ -66,6 +67,8 @@ protected:
 private:
 	SampleClip * m_clip;
 	SampleThumbnail m_sampleThumbnail;
+	bool m_thumbnailPending = false;
+	SampleWaveformTiles m_waveformTiles;
 	QPixmap m_paintPixmap;
 	long m_paintPixmapXPosition;
 } ;
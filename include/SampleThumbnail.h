@@ -26,7 +26,9 @@
 #ifndef LMMS_SAMPLE_THUMBNAIL_H
 #define LMMS_SAMPLE_THUMBNAIL_H
 
+#include <atomic>
 #include <QDateTime>
+#include <QObject>
 #include <QRect>
 #include <memory>
 
@@ -42,6 +44,14 @@ class Sample;
 
 namespace lmms::gui {
 
+//! Announces on the GUI thread that a thumbnail finished generating in the background
+class LMMS_EXPORT SampleThumbnailNotifier : public QObject
+{
+	Q_OBJECT
+signals:
+	void thumbnailReady();
+};
+
 /**
    Allows for visualizing sample data.
 
@@ -52,6 +62,11 @@ namespace lmms::gui {
    Given that we are dealing with far less data to generate
    the visualization however (i.e., we are not reading from original sample data when drawing), this provides a
    significant performance boost that wouldn't be possible otherwise.
+
+   Thumbnails of long samples are generated on the ThreadPool. Until they are ready, `visualize` only draws a
+   center line, and `notifier()` emits `thumbnailReady` once they are. The thumbnails of sample files are also
+   stored in an on-disk cache keyed by the file's path, size and modification time, so they do not have to be
+   generated again when the file is opened later.
  */
 class LMMS_EXPORT SampleThumbnail
 {
@@ -76,6 +91,11 @@ public:
 	SampleThumbnail(const Sample& sample);
 	void visualize(VisualizeParameters parameters, QPainter& painter) const;
 
+	//! Whether the thumbnails have been generated
+	bool isReady() const { return m_pyramid->ready.load(std::memory_order_acquire); }
+
+	static SampleThumbnailNotifier* notifier();
+
 private:
 	class Thumbnail
 	{
@@ -110,6 +130,7 @@ private:
 		Thumbnail zoomOut(float factor) const;
 
 		Peak* data() { return m_peaks.data(); }
+		const Peak* data() const { return m_peaks.data(); }
 		Peak& operator[](size_t index) { return m_peaks[index]; }
 		const Peak& operator[](size_t index) const { return m_peaks[index]; }
 
@@ -138,9 +159,25 @@ private:
 	};
 
 	using ThumbnailCache = std::vector<Thumbnail>;
-	std::shared_ptr<ThumbnailCache> m_thumbnailCache = std::make_shared<ThumbnailCache>();
+
+	//! The thumbnails at all zoom levels, finest first. Written once by the
+	//! generating thread, read only after `ready` is set.
+	struct Pyramid
+	{
+		explicit Pyramid(bool ready) : ready(ready) {}
+
+		ThumbnailCache thumbnails;
+		std::atomic<bool> ready;
+	};
+
+	static void generate(Pyramid& pyramid, const SampleBuffer& buffer);
+	static bool loadFromDisk(Pyramid& pyramid, const QString& cacheFile, std::size_t frames);
+	static void saveToDisk(const Pyramid& pyramid, const QString& cacheFile, std::size_t frames);
+	static QString diskCacheFile(const QString& sampleFile);
+
+	std::shared_ptr<Pyramid> m_pyramid = std::make_shared<Pyramid>(true);
 	std::shared_ptr<const SampleBuffer> m_buffer = SampleBuffer::emptyBuffer();
-	inline static std::unordered_map<SampleThumbnailEntry, std::shared_ptr<ThumbnailCache>, Hash> s_sampleThumbnailCacheMap;
+	inline static std::unordered_map<SampleThumbnailEntry, std::shared_ptr<Pyramid>, Hash> s_sampleThumbnailCacheMap;
 };
 
 } // namespace lmms::gui
@@ -0,0 +1,105 @@
+/*
+ * SampleWaveformTiles.h - cache of rendered waveform tiles of a sample
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_GUI_SAMPLE_WAVEFORM_TILES_H
+#define LMMS_GUI_SAMPLE_WAVEFORM_TILES_H
+
+#include <QColor>
+#include <QObject>
+#include <QPixmap>
+#include <vector>
+
+#include "SampleThumbnail.h"
+
+class QPainter;
+
+namespace lmms::gui {
+
+/**
+   Caches the waveform of a sample in pixmap tiles of a fixed width.
+
+   Tiles are laid out from the start of the sample, so moving the sample around (e.g. scrolling or changing its start
+   offset) reuses all of them, and only tiles that come into view for the first time have to be rendered. Tiles are
+   rendered from the `SampleThumbnail` on the ThreadPool; until a tile is ready, a tile with the same geometry in
+   another color or a center line is drawn in its place, and `tileReady` is emitted once it is.
+ */
+class LMMS_EXPORT SampleWaveformTiles : public QObject
+{
+	Q_OBJECT
+public:
+	static constexpr int TileWidth = 256;
+	static constexpr std::size_t MaxTiles = 64;
+
+	//! Everything the look of a tile depends on besides the sample
+	struct Parameters
+	{
+		int sampleWidth = 0; //!< The width of the whole sample in pixels, i.e. the zoom level.
+		int height = 0; //!< The height of the waveform in pixels.
+		float amplification = 1.0f; //!< The amount of amplification to apply to the waveform.
+		bool reversed = false; //!< Determines if the waveform is drawn in reverse or not.
+		QColor color; //!< The color of the waveform.
+
+		friend bool operator==(const Parameters&, const Parameters&) = default;
+	};
+
+	explicit SampleWaveformTiles(QObject* parent = nullptr);
+
+	//! Draw the waveforms of @p thumbnail from now on, dropping all tiles
+	void setThumbnail(const SampleThumbnail& thumbnail);
+
+	//! Draw the waveform with its top left corner at @p position, as far as it overlaps @p viewport
+	void draw(QPainter& painter, QPoint position, const Parameters& parameters, const QRect& viewport);
+
+signals:
+	void tileReady();
+
+private:
+	struct Tile
+	{
+		Parameters parameters;
+		int index = 0;
+		QPixmap pixmap;
+		unsigned lastUsed = 0;
+	};
+
+	struct PendingTile
+	{
+		Parameters parameters;
+		int index = 0;
+	};
+
+	auto findTile(const Parameters& parameters, int index, bool anyColor) -> Tile*;
+	void render(const Parameters& parameters, int index);
+	void addTile(const Parameters& parameters, int index, unsigned generation, const QImage& image);
+
+	SampleThumbnail m_thumbnail;
+	std::vector<Tile> m_tiles;
+	std::vector<PendingTile> m_pendingTiles;
+	unsigned m_generation = 0; //!< Counts the thumbnails, so tiles of a previous one can be told apart
+	unsigned m_useCount = 0;
+};
+
+} // namespace lmms::gui
+
+#endif // LMMS_GUI_SAMPLE_WAVEFORM_TILES_H
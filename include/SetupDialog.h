@@ -94,8 +94,10 @@ private slots:
 	void resetAutoSave();
 	void toggleAutoSave(bool enabled);
 	void toggleRunningAutoSave(bool enabled);
+	void setUndoBudget(int steps);
 	void toggleSmoothScroll(bool enabled);
 	void toggleAnimateAFP(bool enabled);
+	void toggleVirtualTrackList(bool enabled);
 	void vstEmbedMethodChanged();
 	void toggleVSTAlwaysOnTop(bool en);
 	void toggleDisableAutoQuit(bool enabled);
@@ -166,8 +168,12 @@ private:
 	QLabel * m_saveIntervalLbl;
 	QCheckBox * m_autoSave;
 	QCheckBox * m_runningAutoSave;
+	int m_undoBudget;
+	QSlider * m_undoBudgetSlider;
+	QLabel * m_undoBudgetLbl;
 	bool m_smoothScroll;
 	bool m_animateAFP;
+	bool m_virtualTrackList;
 	QLabel * m_vstEmbedLbl;
 	QComboBox* m_vstEmbedComboBox;
 	QString m_vstEmbedMethod;
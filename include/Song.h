@@ -26,6 +26,7 @@
 #define LMMS_SONG_H
 
 #include <array>
+#include <future>
 #include <memory>
 
 #include <QString>
@@ -44,6 +45,7 @@ namespace lmms
 {
 
 class AutomationTrack;
+class DataFile;
 class Keymap;
 class MidiClip;
 class Scale;
@@ -251,6 +253,12 @@ public:
 	bool guiSaveProject();
 	bool guiSaveProjectAs(const QString & filename);
 	bool saveProjectFile(const QString & filename, bool withResources = false);
+	//! Save like saveProjectFile(), but serialize, compress and write the
+	//! file on a worker thread. Only one such save runs at a time, so this
+	//! returns false if the previous one has not finished yet.
+	bool saveProjectFileInBackground(const QString & filename);
+	bool isSavingInBackground() const;
+	void waitForBackgroundSave();
 
 	const QString & projectFileName() const
 	{
@@ -278,6 +286,12 @@ public:
 		return m_modified;
 	}
 
+	//! Counts the modifications, to tell whether a saved state is outdated
+	unsigned modificationCount() const
+	{
+		return m_modificationCount;
+	}
+
 	QString nodeName() const override
 	{
 		return "song";
@@ -384,6 +398,9 @@ private:
 		return getTimeline(m_playMode).ticks() * Engine::framesPerTick() + getTimeline(m_playMode).frameOffset();
 	}
 
+	//! Store the whole project in @p dataFile
+	void saveProject(DataFile & dataFile);
+
 	void saveControllerStates( QDomDocument & doc, QDomElement & element );
 	void restoreControllerStates( const QDomElement & element );
 
@@ -417,6 +434,7 @@ private:
 	QString m_fileName;
 	QString m_oldFileName;
 	bool m_modified;
+	unsigned m_modificationCount = 0;
 	bool m_loadOnLaunch;
 
 	volatile bool m_recording;
@@ -432,6 +450,8 @@ private:
 
 	SaveOptions m_saveOptions;
 
+	std::future<bool> m_backgroundSave;
+
 	QHash<QString, int> m_errors;
 
 	std::array<Timeline, PlayModeCount> m_timelines;
@@ -474,6 +494,8 @@ signals:
 	void controllerRemoved( lmms::Controller * );
 	void stopped();
 	void modified();
+	//! @p modificationCount is the count at the time the state was saved
+	void backgroundSaveFinished(const QString& filename, bool success, unsigned modificationCount);
 	void projectFileNameChanged();
 	void scaleListChanged(int index);
 	void keymapListChanged(int index);
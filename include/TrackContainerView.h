@@ -149,6 +149,15 @@ public:
 
 	unsigned int totalHeightOfTracks() const;
 
+	//! Whether clip views only exist for the tracks in or near the viewport
+	bool isVirtualized() const
+	{
+		return m_virtualized;
+	}
+
+	//! Create the views of all clips, e.g. before selecting all of them
+	void createAllClipViews();
+
 	RubberBand *rubberBand() const;
 
 public slots:
@@ -164,6 +173,9 @@ public slots:
 	/// Removes the rubber band from display when finished with.
 	void stopRubberBand();
 
+	//! Tell the tracks whether they are in or near the viewport
+	void updateVisibleTracks();
+
 
 protected:
 	static const int DEFAULT_PIXELS_PER_BAR = 128;
@@ -198,6 +210,11 @@ private:
 
 	RubberBand * m_rubberBand;
 
+	bool m_virtualized;
+	bool m_visibleTracksUpdatePending = false;
+
+	void scheduleVisibleTracksUpdate();
+
 signals:
 	void positionChanged( const lmms::TimePos & _pos );
 	void tracksRealigned();
@@ -31,11 +31,13 @@
 #include "TimePos.h"
 
 class QMimeData;  // IWYU pragma: keep
+class QPainter;
 
 
 namespace lmms
 {
 
+class Clip;
 class Track;
 
 namespace gui
@@ -69,13 +71,18 @@ public:
 
 	void addClipView( ClipView * clipv );
 	void removeClipView( ClipView * clipv );
-	void removeClipView( int clipNum )
-	{
-		if( clipNum >= 0 && clipNum < m_clipViews.size() )
-		{
-			removeClipView( m_clipViews[clipNum] );
-		}
-	}
+	void removeClipView( int clipNum );
+
+	// In a virtualized TrackContainerView, clip views only exist while
+	// the track is in or near the viewport, and only for the clips around
+	// the visible time range. The others are painted as plain boxes.
+
+	//! Whether a view for @p clip should exist at the moment
+	bool wantsClipView( const Clip * clip ) const;
+	bool hasClipView( const Clip * clip ) const;
+	//! Set whether the track is in or near the viewport
+	void setInView( bool inView );
+	void createAllClipViews();
 
 	bool canPasteSelection( TimePos clipPos, const QDropEvent *de );
 	bool canPasteSelection( TimePos clipPos, const QMimeData *md, bool allowSameBar = false );
@@ -156,12 +163,24 @@ private:
 	Track * getTrack();
 	TimePos getPosition( int mouseX );
 
+	bool isVirtualized() const;
+	void scheduleClipViewsUpdate();
+	//! Create the wanted clip views and delete the others which are not in use
+	void updateClipViews();
+	void createMissingClipViews( bool all );
+	void paintClipsWithoutViews( QPainter & p );
+
 	TrackView * m_trackView;
 
 	using clipViewVector = QVector<ClipView*>;
 	clipViewVector m_clipViews;
 
 	QPixmap m_background;
+	bool m_backgroundStale = false;
+
+	bool m_inView = false;
+	bool m_updatingClipViews = false;
+	bool m_clipViewsUpdatePending = false;
 
 	// qproperty fields
 	QBrush m_darkerColor;
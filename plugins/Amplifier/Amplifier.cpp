@@ -57,8 +57,9 @@ AmplifierEffect::AmplifierEffect(Model* parent, const Descriptor::SubPluginFeatu
 }
 
 
-Effect::ProcessStatus AmplifierEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus AmplifierEffect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
 {
+	const f_cnt_t frames = inOut.frames();
 	const float d = dryLevel();
 	const float w = wetLevel();
 
@@ -77,12 +78,15 @@ Effect::ProcessStatus AmplifierEffect::processImpl(SampleFrame* buf, const f_cnt
 		const float panLeft = std::min(1.0f, 1.0f - pan);
 		const float panRight = std::min(1.0f, 1.0f + pan);
 
-		auto& currentFrame = buf[f];
+		auto& currentLeft = inOut[0][f];
+		auto& currentRight = inOut[1][f];
 
-		const auto s = currentFrame * SampleFrame(left * panLeft, right * panRight) * volume;
+		const float sLeft = currentLeft * left * panLeft * volume;
+		const float sRight = currentRight * right * panRight * volume;
 
 		// Dry/wet mix
-		currentFrame = currentFrame * d + s * w;
+		currentLeft = currentLeft * d + sLeft * w;
+		currentRight = currentRight * d + sRight * w;
 	}
 
 	return ProcessStatus::ContinueIfNotQuiet;
@@ -38,7 +38,8 @@ public:
 	AmplifierEffect(Model* parent, const Descriptor::SubPluginFeatures::Key* key);
 	~AmplifierEffect() override = default;
 
-	ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> inOut) override;
+	bool usesPlanarBuffers() const override { return true; }
 
 	EffectControls* controls() override
 	{
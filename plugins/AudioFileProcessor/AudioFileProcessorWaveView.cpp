@@ -91,6 +91,11 @@ AudioFileProcessorWaveView::AudioFileProcessorWaveView(QWidget* parent, int w, i
 
 	configureKnobRelationsAndWaveViews();
 
+	connect(SampleThumbnail::notifier(), &SampleThumbnailNotifier::thumbnailReady, this, [this]
+	{
+		if (m_thumbnailPending && m_sampleThumbnail.isReady()) { update(); }
+	});
+
 	updateSampleRange();
 
 	m_graph.fill(Qt::transparent);
@@ -333,7 +338,8 @@ void AudioFileProcessorWaveView::updateGraph()
 	{
 		reverse();
 	}
-	else if (m_last_from == m_from && m_last_to == m_to && m_sample->amplification() == m_last_amp)
+	else if (!m_thumbnailPending && m_last_from == m_from && m_last_to == m_to
+		&& m_sample->amplification() == m_last_amp)
 	{
 		return;
 	}
@@ -347,6 +353,7 @@ void AudioFileProcessorWaveView::updateGraph()
 	p.setPen(QColor(255, 255, 255));
 
 	m_sampleThumbnail = SampleThumbnail{*m_sample};
+	m_thumbnailPending = !m_sampleThumbnail.isReady();
 
 	const auto param = SampleThumbnail::VisualizeParameters{
 		.sampleRect = m_graph.rect(),
@@ -143,6 +143,7 @@ private:
 	f_cnt_t m_framesPlayed;
 	bool m_animation;
 	SampleThumbnail m_sampleThumbnail;
+	bool m_thumbnailPending = false;
 
 	friend class AudioFileProcessorView;
 
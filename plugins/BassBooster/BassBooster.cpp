@@ -69,8 +69,10 @@ BassBoosterEffect::BassBoosterEffect( Model* parent, const Descriptor::SubPlugin
 
 
 
-Effect::ProcessStatus BassBoosterEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus BassBoosterEffect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
 {
+	const f_cnt_t frames = inOut.frames();
+
 	// check out changed controls
 	if( m_frequencyChangeNeeded || m_bbControls.m_freqModel.isValueChanged() )
 	{
@@ -88,7 +90,7 @@ Effect::ProcessStatus BassBoosterEffect::processImpl(SampleFrame* buf, const f_c
 
 	for (f_cnt_t f = 0; f < frames; ++f)
 	{
-		auto& currentFrame = buf[f];
+		const auto currentFrame = SampleFrame{inOut[0][f], inOut[1][f]};
 
 		// Process copy of current sample frame
 		m_bbFX.setGain(gainBuffer ? gainBuffer->value(f) : const_gain);
@@ -96,7 +98,9 @@ Effect::ProcessStatus BassBoosterEffect::processImpl(SampleFrame* buf, const f_c
 		m_bbFX.nextSample(s);
 
 		// Dry/wet mix
-		currentFrame = currentFrame * d + s * w;
+		const auto mixed = currentFrame * d + s * w;
+		inOut[0][f] = mixed[0];
+		inOut[1][f] = mixed[1];
 	}
 
 	return ProcessStatus::ContinueIfNotQuiet;
@@ -39,7 +39,8 @@ public:
 	BassBoosterEffect( Model* parent, const Descriptor::SubPluginFeatures::Key* key );
 	~BassBoosterEffect() override = default;
 
-	ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> inOut) override;
+	bool usesPlanarBuffers() const override { return true; }
 
 	EffectControls* controls() override
 	{
@@ -236,8 +236,12 @@ void CompressorEffect::calcMix()
 
 
 
-Effect::ProcessStatus CompressorEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus CompressorEffect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
 {
+	const f_cnt_t frames = inOut.frames();
+	sample_t* left = inOut[0];
+	sample_t* right = inOut[1];
+
 	m_cleanedBuffers = false;
 
 	const float d = dryLevel();
@@ -263,7 +267,7 @@ Effect::ProcessStatus CompressorEffect::processImpl(SampleFrame* buf, const f_cn
 
 	for(f_cnt_t f = 0; f < frames; ++f)
 	{
-		auto drySignal = std::array{buf[f][0], buf[f][1]};
+		auto drySignal = std::array{left[f], right[f]};
 		auto s = std::array{drySignal[0] * m_inGainVal, drySignal[1] * m_inGainVal};
 
 		// Calculate tilt filters, to bias the sidechain to the low or high frequencies
@@ -493,10 +497,10 @@ Effect::ProcessStatus CompressorEffect::processImpl(SampleFrame* buf, const f_cn
 		// Calculate wet/dry value results
 		const float temp1 = delayedDrySignal[0];
 		const float temp2 = delayedDrySignal[1];
-		buf[f][0] = d * temp1 + w * s[0];
-		buf[f][1] = d * temp2 + w * s[1];
-		buf[f][0] = (1 - m_mixVal) * temp1 + m_mixVal * buf[f][0];
-		buf[f][1] = (1 - m_mixVal) * temp2 + m_mixVal * buf[f][1];
+		left[f] = d * temp1 + w * s[0];
+		right[f] = d * temp2 + w * s[1];
+		left[f] = (1 - m_mixVal) * temp1 + m_mixVal * left[f];
+		right[f] = (1 - m_mixVal) * temp2 + m_mixVal * right[f];
 
 		if (--m_lookWrite < 0) { m_lookWrite = m_lookBufLength - 1; }
 
@@ -44,7 +44,8 @@ public:
 	CompressorEffect(Model* parent, const Descriptor::SubPluginFeatures::Key* key);
 	~CompressorEffect() override = default;
 
-	ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> inOut) override;
+	bool usesPlanarBuffers() const override { return true; }
 	void processBypassedImpl() override;
 
 	EffectControls* controls() override
@@ -81,8 +81,9 @@ DelayEffect::~DelayEffect()
 
 
 
-Effect::ProcessStatus DelayEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus DelayEffect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
 {
+	const f_cnt_t frames = inOut.frames();
 	const float sr = Engine::audioEngine()->outputSampleRate();
 	const float d = dryLevel();
 	const float w = wetLevel();
@@ -112,7 +113,8 @@ Effect::ProcessStatus DelayEffect::processImpl(SampleFrame* buf, const f_cnt_t f
 
 	for (f_cnt_t f = 0; f < frames; ++f)
 	{
-		auto& currentFrame = buf[f];
+		// StereoDelay works on whole frames
+		auto currentFrame = SampleFrame{inOut[0][f], inOut[1][f]};
 		const auto dryS = currentFrame;
 
 		// Prepare delay for current sample
@@ -130,6 +132,8 @@ Effect::ProcessStatus DelayEffect::processImpl(SampleFrame* buf, const f_cnt_t f
 
 		// Dry/wet mix
 		currentFrame = dryS * d + currentFrame * w;
+		inOut[0][f] = currentFrame.left();
+		inOut[1][f] = currentFrame.right();
 
 		lengthPtr += lengthInc;
 		amplitudePtr += amplitudeInc;
@@ -40,7 +40,8 @@ public:
 	DelayEffect(Model* parent , const Descriptor::SubPluginFeatures::Key* key );
 	~DelayEffect() override;
 
-	ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> inOut) override;
+	bool usesPlanarBuffers() const override { return true; }
 
 	EffectControls* controls() override
 	{
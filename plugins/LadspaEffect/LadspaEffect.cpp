@@ -26,6 +26,8 @@
 
 #include <QVarLengthArray>
 #include <QMessageBox>
+#include <algorithm>
+#include <limits>
 
 #include "LadspaEffect.h"
 #include "DataFile.h"
@@ -107,10 +109,10 @@ void LadspaEffect::changeSampleRate()
 	LadspaControls * controls = m_controls;
 	m_controls = nullptr;
 
-	m_pluginMutex.lock();
+	Engine::audioEngine()->requestChangeInModel();
 	pluginDestruction();
 	pluginInstantiation();
-	m_pluginMutex.unlock();
+	Engine::audioEngine()->doneChangeInModel();
 
 	controls->effectModelChanged( m_controls );
 	delete controls;
@@ -127,72 +129,61 @@ void LadspaEffect::changeSampleRate()
 
 Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
 {
-	m_pluginMutex.lock();
 	if (!isProcessingAudio())
 	{
-		m_pluginMutex.unlock();
 		return ProcessStatus::Sleep;
 	}
 
-	// Copy the LMMS audio buffer to the LADSPA input buffer and initialize
-	// the control ports.
-	ch_cnt_t channel = 0;
-	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+	// Copy the LMMS audio buffer to the LADSPA input buffers. Output ports
+	// share these buffers unless the plugin is in-place broken.
+	for (const auto& in : m_channelIns)
 	{
-		for( int port = 0; port < m_portCount; ++port )
+		for (f_cnt_t frame = 0; frame < frames; ++frame)
 		{
-			port_desc_t * pp = m_ports.at( proc ).at( port );
-			switch( pp->rate )
+			in.buffer[frame] = buf[frame][in.channel];
+		}
+	}
+
+	// Update the control ports. Port buffers keep their contents between
+	// periods, so they are only rewritten when the value has changed.
+	const f_cnt_t bufferSize = Engine::audioEngine()->framesPerPeriod();
+	for (port_desc_t* pp : m_portControls)
+	{
+		if (pp->control == nullptr)
+		{
+			continue;
+		}
+
+		LADSPA_Data& written = m_writtenControlValues[pp->control_id];
+		if (pp->rate == BufferRate::AudioRateInput)
+		{
+			if (ValueBuffer* vb = pp->control->valueBuffer())
 			{
-				case BufferRate::ChannelIn:
-					for (f_cnt_t frame = 0; frame < frames; ++frame)
-					{
-						pp->buffer[frame] = buf[frame][channel];
-					}
-					++channel;
-					break;
-				case BufferRate::AudioRateInput:
-				{
-					ValueBuffer * vb = pp->control->valueBuffer();
-					if( vb )
-					{
-						memcpy(pp->buffer, vb->values(), frames * sizeof(float));
-					}
-					else
-					{
-						pp->value = static_cast<LADSPA_Data>(
-											pp->control->value() / pp->scale );
-						// This only supports control rate ports, so the audio rates are
-						// treated as though they were control rate by setting the
-						// port buffer to all the same value.
-						for (f_cnt_t frame = 0; frame < frames; ++frame)
-						{
-							pp->buffer[frame] = pp->value;
-						}
-					}
-					break;
-				}
-				case BufferRate::ControlRateInput:
-					if( pp->control == nullptr )
-					{
-						break;
-					}
-					pp->value = static_cast<LADSPA_Data>(
-										pp->control->value() / pp->scale );
-					pp->buffer[0] =
-						pp->value;
-					break;
-				case BufferRate::ChannelOut:
-				case BufferRate::AudioRateOutput:
-				case BufferRate::ControlRateOutput:
-					break;
-				default:
-					break;
+				std::copy_n(vb->values(), frames, pp->buffer);
+				written = std::numeric_limits<LADSPA_Data>::quiet_NaN();
+				continue;
+			}
+			pp->value = static_cast<LADSPA_Data>(pp->control->value() / pp->scale);
+			// This only supports control rate ports, so the audio rates are
+			// treated as though they were control rate by setting the
+			// port buffer to all the same value.
+			if (pp->value != written)
+			{
+				std::fill_n(pp->buffer, bufferSize, pp->value);
+				written = pp->value;
+			}
+		}
+		else
+		{
+			pp->value = static_cast<LADSPA_Data>(pp->control->value() / pp->scale);
+			if (pp->value != written)
+			{
+				pp->buffer[0] = pp->value;
+				written = pp->value;
 			}
 		}
 	}
 
-
 	// Process the buffers.
 	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
 	{
@@ -200,38 +191,16 @@ Effect::ProcessStatus LadspaEffect::processImpl(SampleFrame* buf, const f_cnt_t
 	}
 
 	// Copy the LADSPA output buffers to the LMMS buffer.
-	channel = 0;
 	const float d = dryLevel();
 	const float w = wetLevel();
-	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+	for (const auto& out : m_channelOuts)
 	{
-		for( int port = 0; port < m_portCount; ++port )
+		for (f_cnt_t frame = 0; frame < frames; ++frame)
 		{
-			port_desc_t * pp = m_ports.at( proc ).at( port );
-			switch( pp->rate )
-			{
-				case BufferRate::ChannelIn:
-				case BufferRate::AudioRateInput:
-				case BufferRate::ControlRateInput:
-					break;
-				case BufferRate::ChannelOut:
-					for (f_cnt_t frame = 0; frame < frames; ++frame)
-					{
-						buf[frame][channel] = d * buf[frame][channel] + w * pp->buffer[frame];
-					}
-					++channel;
-					break;
-				case BufferRate::AudioRateOutput:
-				case BufferRate::ControlRateOutput:
-					break;
-				default:
-					break;
-			}
+			buf[frame][out.channel] = d * buf[frame][out.channel] + w * out.buffer[frame];
 		}
 	}
 
-	m_pluginMutex.unlock();
-
 	return ProcessStatus::ContinueIfNotQuiet;
 }
 
@@ -489,6 +458,28 @@ void LadspaEffect::pluginInstantiation()
 		}
 	}
 
+	// Collect the audio ports in the order their channels are assigned,
+	// so processImpl() doesn't have to look at every port
+	ch_cnt_t inChannel = 0;
+	ch_cnt_t outChannel = 0;
+	for( ch_cnt_t proc = 0; proc < processorCount(); proc++ )
+	{
+		for( int port = 0; port < m_portCount; port++ )
+		{
+			port_desc_t * pp = m_ports.at( proc ).at( port );
+			if( pp->rate == BufferRate::ChannelIn )
+			{
+				m_channelIns.push_back( { pp->buffer, inChannel++ } );
+			}
+			else if( pp->rate == BufferRate::ChannelOut )
+			{
+				m_channelOuts.push_back( { pp->buffer, outChannel++ } );
+			}
+		}
+	}
+	m_writtenControlValues.assign( m_portControls.size(),
+				std::numeric_limits<LADSPA_Data>::quiet_NaN() );
+
 	// Activate the processing units.
 	for( ch_cnt_t proc = 0; proc < processorCount(); proc++ )
 	{
@@ -528,6 +519,9 @@ void LadspaEffect::pluginDestruction()
 	m_ports.clear();
 	m_handles.clear();
 	m_portControls.clear();
+	m_channelIns.clear();
+	m_channelOuts.clear();
+	m_writtenControlValues.clear();
 }
 
 extern "C"
@@ -26,7 +26,7 @@
 #ifndef _LADSPA_EFFECT_H
 #define _LADSPA_EFFECT_H
 
-#include <QMutex>
+#include <vector>
 
 #include "Effect.h"
 #include "ladspa.h"
@@ -76,7 +76,6 @@ private:
 
 	static sample_rate_t maxSamplerate( const QString & _name );
 
-	QMutex m_pluginMutex;
 	LadspaControls * m_controls;
 
 	ladspa_key_t m_key;
@@ -89,6 +88,18 @@ private:
 	QVector<multi_proc_t> m_ports;
 	multi_proc_t m_portControls;
 
+	//! An audio port buffer together with the LMMS channel it belongs to
+	struct ChannelPort
+	{
+		LADSPA_Data * buffer;
+		ch_cnt_t channel;
+	};
+	std::vector<ChannelPort> m_channelIns;
+	std::vector<ChannelPort> m_channelOuts;
+	//! Last value written into each port of m_portControls, NaN if the
+	//! port buffer has to be rewritten
+	std::vector<LADSPA_Data> m_writtenControlValues;
+
 	ch_cnt_t m_processors = 1;
 };
 
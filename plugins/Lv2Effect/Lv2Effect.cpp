@@ -61,8 +61,16 @@ Plugin::Descriptor PLUGIN_EXPORT lv2effect_plugin_descriptor =
 Lv2Effect::Lv2Effect(Model* parent, const Descriptor::SubPluginFeatures::Key *key) :
 	Effect(&lv2effect_plugin_descriptor, parent, key),
 	m_controls(this, key->attributes["uri"]),
-	m_tmpOutputSmps(Engine::audioEngine()->framesPerPeriod())
+	m_tmpOutputSmps(Engine::audioEngine()->framesPerPeriod()),
+	m_planar(m_controls.supportsPlanarBuffers()),
+	m_tmpPlanarSmps(m_planar ? DEFAULT_CHANNELS * Engine::audioEngine()->framesPerPeriod() : 0)
 {
+	for (std::size_t ch = 0; ch < m_tmpPlanarChannels.size(); ++ch)
+	{
+		m_tmpPlanarChannels[ch] = m_planar
+			? m_tmpPlanarSmps.data() + ch * Engine::audioEngine()->framesPerPeriod()
+			: nullptr;
+	}
 }
 
 
@@ -97,6 +105,43 @@ Effect::ProcessStatus Lv2Effect::processImpl(SampleFrame* buf, const f_cnt_t fra
 
 
 
+Effect::ProcessStatus Lv2Effect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
+{
+	const f_cnt_t frames = inOut.frames();
+	Q_ASSERT(frames <= static_cast<f_cnt_t>(m_tmpOutputSmps.size()));
+
+	bool corrupt = wetLevel() < 0; // #3261 - if w < 0, bash w := 0, d := 1
+	const float d = corrupt ? 1 : dryLevel();
+	const float w = corrupt ? 0 : wetLevel();
+
+	// a fully wet signal can be written directly into the channels
+	const bool inPlace = d == 0.f && w == 1.f && !m_controls.inPlaceBroken();
+	m_controls.connectPlanarBuffers(inOut.data(), inPlace ? inOut.data() : m_tmpPlanarChannels.data());
+	m_controls.copyModelsFromLmms();
+
+	m_controls.run(frames);
+
+	m_controls.copyModelsToLmms();
+
+	if (!inPlace)
+	{
+		for (ch_cnt_t ch = 0; ch < inOut.channels(); ++ch)
+		{
+			float* channel = inOut[ch];
+			const float* wet = m_tmpPlanarChannels[ch];
+			for (f_cnt_t f = 0; f < frames; ++f)
+			{
+				channel[f] = d * channel[f] + w * wet[f];
+			}
+		}
+	}
+
+	return ProcessStatus::ContinueIfNotQuiet;
+}
+
+
+
+
 extern "C"
 {
 
@@ -25,8 +25,11 @@
 #ifndef LV2_EFFECT_H
 #define LV2_EFFECT_H
 
+#include <array>
+
 #include "Effect.h"
 #include "Lv2FxControls.h"
+#include "lmms_constants.h"
 
 namespace lmms
 {
@@ -43,6 +46,8 @@ public:
 	Lv2Effect(Model* parent, const Descriptor::SubPluginFeatures::Key* _key);
 
 	ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBufferView<float, 2> inOut) override;
+	bool usesPlanarBuffers() const override { return m_planar; }
 
 	EffectControls* controls() override { return &m_controls; }
 
@@ -52,6 +57,12 @@ public:
 private:
 	Lv2FxControls m_controls;
 	std::vector<SampleFrame> m_tmpOutputSmps;
+
+	//! whether the ports can be connected to the planar channels directly
+	const bool m_planar;
+	//! planar wet output, used unless the plugin can run in place
+	std::vector<float> m_tmpPlanarSmps;
+	std::array<float*, DEFAULT_CHANNELS> m_tmpPlanarChannels;
 };
 
 
@@ -24,7 +24,8 @@
 
 // TODO:
 // - Better voice allocation: long releases get cut short :(
-// - RT safety = get rid of mutex = make emulator code thread-safe
+// - RT safety: the chip emulator keeps its rendering scratch state in file statics,
+//   so update() calls of different instances still have to be serialized
 
 // - Extras:
 //   - double release: first release is in effect until noteoff (heard if percussive sound),
@@ -46,6 +47,7 @@
 #include <QDomElement>
 #include <cassert>
 #include <cmath>
+#include <utility>
 
 #include <opl.h>
 #include <temuopl.h>
@@ -87,10 +89,40 @@ PLUGIN_EXPORT Plugin * lmms_plugin_main( Model *m, void * )
 
 }
 
-// I'd much rather do without a mutex, but it looks like
-// the emulator code isn't really ready for threads
+// The emulator (fmopl.c) shares its tables and per-update scratch variables
+// between all chips, so calls into it must not overlap. Only play() and
+// creating/destroying a chip take this lock; register writes from anywhere
+// else go through the per-instance RegisterQueue instead, unless it is full.
 QMutex OpulenzInstrument::emulatorMutex;
 
+bool OpulenzInstrument::RegisterQueue::push(int reg, int value)
+{
+	const auto head = m_head.load(std::memory_order_relaxed);
+	if (head - m_tail.load(std::memory_order_acquire) >= Size) { return false; }
+
+	m_writes[head & (Size - 1)] = {static_cast<std::uint8_t>(reg), static_cast<std::uint8_t>(value)};
+	m_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename F>
+void OpulenzInstrument::RegisterQueue::drain(F&& write)
+{
+	const auto head = m_head.load(std::memory_order_acquire);
+	auto tail = m_tail.load(std::memory_order_relaxed);
+	for (; tail != head; ++tail)
+	{
+		const auto& w = m_writes[tail & (Size - 1)];
+		write(w.reg, w.value);
+	}
+	m_tail.store(tail, std::memory_order_release);
+}
+
+void OpulenzInstrument::RegisterQueue::clear()
+{
+	m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
 // Weird ordering of voice parameters
 const auto adlib_opadd = std::array<unsigned int, OPL2_VOICES>{0x00, 0x01, 0x02, 0x08, 0x09, 0x0A, 0x10, 0x11, 0x12};
 
@@ -138,13 +170,7 @@ OpulenzInstrument::OpulenzInstrument( InstrumentTrack * _instrument_track ) :
 	trem_depth_mdl(false, this, tr( "Tremolo depth" )   )
 {
 
-	// Create an emulator - samplerate, 16 bit, mono
-	emulatorMutex.lock();
-	theEmulator = new CTemuopl(Engine::audioEngine()->outputSampleRate(), true, false);
-	theEmulator->init();
-	// Enable waveform selection
-	theEmulator->write(0x01,0x20);
-	emulatorMutex.unlock();
+	theEmulator = createEmulator();
 
 	//Initialize voice values
 	// voiceNote[0] = 0;
@@ -220,29 +246,81 @@ OpulenzInstrument::OpulenzInstrument( InstrumentTrack * _instrument_track ) :
 }
 
 OpulenzInstrument::~OpulenzInstrument() {
-	delete theEmulator;
 	Engine::audioEngine()->removePlayHandlesOfTypes( instrumentTrack(),
 				PlayHandle::Type::NotePlayHandle
 				| PlayHandle::Type::InstrumentPlayHandle );
+	emulatorMutex.lock();
+	delete theEmulator;
+	emulatorMutex.unlock();
 	delete [] renderbuffer;
 }
 
-// Samplerate changes when choosing oversampling, so this is more or less mandatory
+// Create an emulator - samplerate, 16 bit, mono
+Copl* OpulenzInstrument::createEmulator() {
+	emulatorMutex.lock();
+	auto emulator = new CTemuopl(Engine::audioEngine()->outputSampleRate(), true, false);
+	emulator->init();
+	// Enable waveform selection
+	emulator->write(0x01,0x20);
+	emulatorMutex.unlock();
+	return emulator;
+}
+
+// Samplerate changes when choosing oversampling, so this is more or less mandatory.
+// The audio engine doesn't process while the sample rate changes, so the chip
+// and the register queue can be replaced directly.
 void OpulenzInstrument::reloadEmulator() {
-	delete theEmulator;
+	auto emulator = createEmulator();
 	emulatorMutex.lock();
-	theEmulator = new CTemuopl(Engine::audioEngine()->outputSampleRate(), true, false);
-	theEmulator->init();
-	theEmulator->write(0x01,0x20);
+	std::swap(theEmulator, emulator);
+	delete emulator;
 	emulatorMutex.unlock();
+
+	voiceMutex.lock();
+	// Pending writes were meant for the old chip and would only leave stuck notes
+	m_registerWrites.clear();
 	for(int i=0; i<OPL2_VOICES; ++i) {
 		voiceNote[i] = OPL2_VOICE_FREE;
 		voiceLRU[i] = i;
 	}
+	voiceMutex.unlock();
 	updatePatch();
 }
 
-// This shall only be called from code protected by the holy Mutex!
+// Queue a register write for the start of the next period
+void OpulenzInstrument::writeRegister(int reg, int value) {
+	if (m_registerWrites.push(reg, value)) { return; }
+
+	// The queue is full, so apply it to the chip right away if play() isn't using it
+	if (emulatorMutex.tryLock()) {
+		drainRegisterWrites();
+		theEmulator->write(reg, value);
+		emulatorMutex.unlock();
+		return;
+	}
+
+	// Frequency, key-on/off and rhythm writes decide whether and what a voice
+	// plays, so losing one leaves a note stuck or out of tune. play() only holds
+	// the lock for one period, so these wait for it; voice setup is dropped.
+	const bool keysVoice = (reg >= 0xA0 && reg <= 0xA8) || (reg >= 0xB0 && reg <= 0xB8) || reg == 0xBD;
+	if (!keysVoice) {
+#ifdef LMMS_DEBUG
+		printf("OpulenZ: register queue full, dropping write %02x %02x\n", reg, value);
+#endif
+		return;
+	}
+	emulatorMutex.lock();
+	drainRegisterWrites();
+	theEmulator->write(reg, value);
+	emulatorMutex.unlock();
+}
+
+// This shall only be called with emulatorMutex held!
+void OpulenzInstrument::drainRegisterWrites() {
+	m_registerWrites.drain([this](int reg, int value) { theEmulator->write(reg, value); });
+}
+
+// This shall only be called with voiceMutex held!
 void OpulenzInstrument::setVoiceVelocity(int voice, int vel) {
 	int vel_adjusted = !fm_mdl.value()
 		? 63 - (op1_lvl_mdl.value() * vel / 127.0)
@@ -250,14 +328,14 @@ void OpulenzInstrument::setVoiceVelocity(int voice, int vel) {
 
 	// Velocity calculation, some kind of approximation
 	// Only calculate for operator 1 if in adding mode, don't want to change timbre
-	theEmulator->write(0x40+adlib_opadd[voice],
+	writeRegister(0x40+adlib_opadd[voice],
 			   ((static_cast<int>(op1_scale_mdl.value()) & 0x03) << 6) +
 			   ( vel_adjusted & 0x3f ) );
 
 
 	vel_adjusted = 63 - ( op2_lvl_mdl.value() * vel/127.0 );
 	// vel_adjusted = 63 - op2_lvl_mdl.value();
-	theEmulator->write(0x43+adlib_opadd[voice],
+	writeRegister(0x43+adlib_opadd[voice],
 			   ((static_cast<int>(op2_scale_mdl.value()) & 0x03) << 6) +
 			   ( vel_adjusted & 0x3f ) );
 }
@@ -294,7 +372,7 @@ int OpulenzInstrument::pushVoice(int v) {
 
 bool OpulenzInstrument::handleMidiEvent( const MidiEvent& event, const TimePos& time, f_cnt_t offset )
 {
-	emulatorMutex.lock();
+	voiceMutex.lock();
 
 	int key = event.key();
 	int vel = event.velocity();
@@ -305,8 +383,8 @@ bool OpulenzInstrument::handleMidiEvent( const MidiEvent& event, const TimePos&
 		{
 			// Turn voice on, NB! the frequencies are straight by voice number,
 			// not by the adlib_opadd table!
-			theEmulator->write(0xA0 + voice, fnums[key] & 0xff);
-			theEmulator->write(0xB0 + voice, 32 + ((fnums[key] & 0x1f00) >> 8));
+			writeRegister(0xA0 + voice, fnums[key] & 0xff);
+			writeRegister(0xB0 + voice, 32 + ((fnums[key] & 0x1f00) >> 8));
 			setVoiceVelocity(voice, vel);
 			voiceNote[voice] = key;
 			velocities[key] = vel;
@@ -317,8 +395,8 @@ bool OpulenzInstrument::handleMidiEvent( const MidiEvent& event, const TimePos&
 		{
 			if (voiceNote[voice] == key)
 			{
-				theEmulator->write(0xA0 + voice, fnums[key] & 0xff);
-				theEmulator->write(0xB0 + voice, (fnums[key] & 0x1f00) >> 8);
+				writeRegister(0xA0 + voice, fnums[key] & 0xff);
+				writeRegister(0xB0 + voice, (fnums[key] & 0x1f00) >> 8);
 				voiceNote[voice] |= OPL2_VOICE_FREE;
 				pushVoice(voice);
 			}
@@ -345,8 +423,8 @@ bool OpulenzInstrument::handleMidiEvent( const MidiEvent& event, const TimePos&
 		{
 			int vn = (voiceNote[v] & ~OPL2_VOICE_FREE);			 // remove the flag bit
 			int playing = (voiceNote[v] & OPL2_VOICE_FREE) == 0; // just the flag bit
-			theEmulator->write(0xA0 + v, fnums[vn] & 0xff);
-			theEmulator->write(0xB0 + v, (playing ? 32 : 0) + ((fnums[vn] & 0x1f00) >> 8));
+			writeRegister(0xA0 + v, fnums[vn] & 0xff);
+			writeRegister(0xB0 + v, (playing ? 32 : 0) + ((fnums[vn] & 0x1f00) >> 8));
 		}
 		break;
 	case MidiControlChange:
@@ -375,7 +453,7 @@ bool OpulenzInstrument::handleMidiEvent( const MidiEvent& event, const TimePos&
 #endif
 		break;
 		}
-	emulatorMutex.unlock();
+	voiceMutex.unlock();
 	return true;
 }
 
@@ -393,7 +471,9 @@ gui::PluginView* OpulenzInstrument::instantiateView( QWidget * _parent )
 void OpulenzInstrument::play( SampleFrame* _working_buffer )
 {
 	emulatorMutex.lock();
+	drainRegisterWrites();
 	theEmulator->update(renderbuffer, frameCount);
+	emulatorMutex.unlock();
 
 	for( f_cnt_t frame = 0; frame < frameCount; ++frame )
         {
@@ -403,7 +483,6 @@ void OpulenzInstrument::play( SampleFrame* _working_buffer )
                         _working_buffer[frame][ch] = s;
                 }
 	}
-	emulatorMutex.unlock();
 }
 
 
@@ -489,21 +568,21 @@ void OpulenzInstrument::loadSettings( const QDomElement & _this )
 
 // Load a patch into the emulator
 void OpulenzInstrument::loadPatch(const unsigned char inst[14]) {
-	emulatorMutex.lock();
+	voiceMutex.lock();
 	for(int v=0; v<OPL2_VOICES; ++v) {
-		theEmulator->write(0x20+adlib_opadd[v],inst[0]); // op1 AM/VIB/EG/KSR/Multiplier
-		theEmulator->write(0x23+adlib_opadd[v],inst[1]); // op2
-		// theEmulator->write(0x40+adlib_opadd[v],inst[2]); // op1 KSL/Output Level - these are handled by noteon/aftertouch code
-		// theEmulator->write(0x43+adlib_opadd[v],inst[3]); // op2
-		theEmulator->write(0x60+adlib_opadd[v],inst[4]); // op1 A/D
-		theEmulator->write(0x63+adlib_opadd[v],inst[5]); // op2
-		theEmulator->write(0x80+adlib_opadd[v],inst[6]); // op1 S/R
-		theEmulator->write(0x83+adlib_opadd[v],inst[7]); // op2
-		theEmulator->write(0xe0+adlib_opadd[v],inst[8]); // op1 waveform
-		theEmulator->write(0xe3+adlib_opadd[v],inst[9]); // op2
-		theEmulator->write(0xc0+v,inst[10]);             // feedback/algorithm
+		writeRegister(0x20+adlib_opadd[v],inst[0]); // op1 AM/VIB/EG/KSR/Multiplier
+		writeRegister(0x23+adlib_opadd[v],inst[1]); // op2
+		// writeRegister(0x40+adlib_opadd[v],inst[2]); // op1 KSL/Output Level - these are handled by noteon/aftertouch code
+		// writeRegister(0x43+adlib_opadd[v],inst[3]); // op2
+		writeRegister(0x60+adlib_opadd[v],inst[4]); // op1 A/D
+		writeRegister(0x63+adlib_opadd[v],inst[5]); // op2
+		writeRegister(0x80+adlib_opadd[v],inst[6]); // op1 S/R
+		writeRegister(0x83+adlib_opadd[v],inst[7]); // op2
+		writeRegister(0xe0+adlib_opadd[v],inst[8]); // op1 waveform
+		writeRegister(0xe3+adlib_opadd[v],inst[9]); // op2
+		writeRegister(0xc0+v,inst[10]);             // feedback/algorithm
 	}
-	emulatorMutex.unlock();
+	voiceMutex.unlock();
 }
 
 void OpulenzInstrument::tuneEqual(int center, float Hz) {
@@ -564,8 +643,9 @@ void OpulenzInstrument::updatePatch() {
 	inst[12] = 0;
 	inst[13] = 0;
 
+	voiceMutex.lock();
 	// Not part of the per-voice patch info
-	theEmulator->write(0xBD, (trem_depth_mdl.value() ? 128 : 0 ) +
+	writeRegister(0xBD, (trem_depth_mdl.value() ? 128 : 0 ) +
 			   (vib_depth_mdl.value() ? 64 : 0 ));
 
 	// have to do this, as the level knobs might've changed
@@ -574,6 +654,7 @@ void OpulenzInstrument::updatePatch() {
 			setVoiceVelocity(voice, velocities[voiceNote[voice]] );
 		}
 	}
+	voiceMutex.unlock();
 #ifdef false
 		printf("UPD: %02x %02x %02x %02x %02x -- %02x %02x %02x %02x %02x %02x\n",
 		       inst[0], inst[1], inst[2], inst[3], inst[4],
@@ -25,6 +25,10 @@
 #ifndef OPULENZ_H
 #define OPULENZ_H
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <QMutex>
 
 #include "AutomatableModel.h"
 #include "Instrument.h"
@@ -121,7 +125,41 @@ private slots:
 	void loadGMPatch();
 
 private:
+	//! Register writes made outside of play(), waiting to be applied to the
+	//! chip at the start of the next period. Producers are serialized by
+	//! voiceMutex and consumers by emulatorMutex, so the queue only has to be
+	//! single-producer/single-consumer.
+	class RegisterQueue
+	{
+	public:
+		//! @returns false if the queue is full, which only happens when
+		//! the audio engine stopped calling play() for a long time
+		bool push(int reg, int value);
+		//! Must only be called with emulatorMutex held
+		template<typename F>
+		void drain(F&& write);
+		//! Must only be called while play() can't run
+		void clear();
+
+	private:
+		static constexpr std::size_t Size = 8192; // must be a power of two
+
+		struct Write
+		{
+			std::uint8_t reg;
+			std::uint8_t value;
+		};
+
+		std::array<Write, Size> m_writes;
+		std::atomic<std::size_t> m_head = 0;
+		std::atomic<std::size_t> m_tail = 0;
+	};
+
 	Copl *theEmulator;
+	RegisterQueue m_registerWrites;
+	// Guards the voice allocation state below; MIDI events arrive from the
+	// audio worker threads and patch updates from the GUI thread
+	QMutex voiceMutex;
 	QString storedname;
 	f_cnt_t frameCount;
 	short *renderbuffer;
@@ -141,6 +179,9 @@ private:
 
 	int Hz2fnum(float Hz);
 	static QMutex emulatorMutex;
+	Copl* createEmulator();
+	void writeRegister(int reg, int value);
+	void drainRegisterWrites();
 	void setVoiceVelocity(int voice, int vel);
 
 	// Pitch bend range comes through RPNs.
@@ -73,8 +73,12 @@ ReverbSCEffect::~ReverbSCEffect()
 	sp_destroy(&sp);
 }
 
-Effect::ProcessStatus ReverbSCEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus ReverbSCEffect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
 {
+	const f_cnt_t frames = inOut.frames();
+	sample_t* left = inOut[0];
+	sample_t* right = inOut[1];
+
 	const float d = dryLevel();
 	const float w = wetLevel();
 
@@ -88,7 +92,7 @@ Effect::ProcessStatus ReverbSCEffect::processImpl(SampleFrame* buf, const f_cnt_
 
 	for( f_cnt_t f = 0; f < frames; ++f )
 	{
-		auto s = std::array{buf[f][0], buf[f][1]};
+		auto s = std::array{left[f], right[f]};
 
 		const auto inGain = fastPow10f<SPFLOAT>(
 			(inGainBuf ? inGainBuf->values()[f] : m_reverbSCControls.m_inputGainModel.value()) / 20.f);
@@ -109,8 +113,8 @@ Effect::ProcessStatus ReverbSCEffect::processImpl(SampleFrame* buf, const f_cnt_
 		sp_revsc_compute(sp, revsc, &s[0], &s[1], &tmpL, &tmpR);
 		sp_dcblock_compute(sp, dcblk[0], &tmpL, &dcblkL);
 		sp_dcblock_compute(sp, dcblk[1], &tmpR, &dcblkR);
-		buf[f][0] = d * buf[f][0] + w * dcblkL * outGain;
-		buf[f][1] = d * buf[f][1] + w * dcblkR * outGain;
+		left[f] = d * left[f] + w * dcblkL * outGain;
+		right[f] = d * right[f] + w * dcblkR * outGain;
 	}
 
 	return ProcessStatus::ContinueIfNotQuiet;
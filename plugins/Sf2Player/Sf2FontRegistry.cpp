@@ -0,0 +1,256 @@
+/*
+ * Sf2FontRegistry.cpp - process-wide cache of parsed SoundFonts shared by all
+ *                       Sf2Player instances
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Sf2FontRegistry.h"
+
+#include <fluidsynth.h>
+#include <QFileInfo>
+#include <QHash>
+#include <mutex>
+#include <vector>
+
+namespace lmms
+{
+
+
+namespace
+{
+
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+
+/**
+ * FluidSynth offers no public way to run its SoundFont parser without a synth,
+ * so all shared fonts are parsed by and owned by one silent host synth. Client
+ * synths only ever see per-synth wrappers around these fonts.
+ */
+struct Registry
+{
+	Registry()
+	{
+		settings = new_fluid_settings();
+		// Only load the samples of presets that are selected on some channel
+		fluid_settings_setint(settings, "synth.dynamic-sample-loading", 1);
+		fluid_settings_setint(settings, "synth.polyphony", 1);
+		fluid_settings_setint(settings, "synth.reverb.active", 0);
+		fluid_settings_setint(settings, "synth.chorus.active", 0);
+		host = new_fluid_synth(settings);
+	}
+
+	~Registry()
+	{
+		delete_fluid_synth(host);
+		delete_fluid_settings(settings);
+	}
+
+	QMutex mutex;
+	fluid_settings_t* settings;
+	fluid_synth_t* host;
+	QHash<QString, std::weak_ptr<Sf2SharedFont>> fonts;
+};
+
+Registry& registry()
+{
+	static Registry s_registry;
+	return s_registry;
+}
+
+
+
+
+using FontHandle = std::shared_ptr<Sf2SharedFont>;
+
+Sf2SharedFont& sharedFontOf(fluid_sfont_t* wrapper)
+{
+	return **static_cast<FontHandle*>(fluid_sfont_get_data(wrapper));
+}
+
+const char* wrapperGetName(fluid_sfont_t* wrapper)
+{
+	return fluid_sfont_get_name(sharedFontOf(wrapper).font());
+}
+
+fluid_preset_t* wrapperGetPreset(fluid_sfont_t* wrapper, int bank, int prenum)
+{
+	return fluid_sfont_get_preset(sharedFontOf(wrapper).font(), bank, prenum);
+}
+
+void wrapperIterationStart(fluid_sfont_t* wrapper)
+{
+	fluid_sfont_iteration_start(sharedFontOf(wrapper).font());
+}
+
+fluid_preset_t* wrapperIterationNext(fluid_sfont_t* wrapper)
+{
+	return fluid_sfont_iteration_next(sharedFontOf(wrapper).font());
+}
+
+int wrapperFree(fluid_sfont_t* wrapper)
+{
+	sharedFontOf(wrapper).removeSynth();
+	delete static_cast<FontHandle*>(fluid_sfont_get_data(wrapper));
+	delete_fluid_sfont(wrapper);
+	return 0;
+}
+
+fluid_sfont_t* loadWrapper(fluid_sfloader_t*, const char* filename)
+{
+	auto font = Sf2FontRegistry::acquire(QString::fromLocal8Bit(filename));
+	if (!font)
+	{
+		// Let the default loader report the error
+		return nullptr;
+	}
+
+	auto wrapper = new_fluid_sfont(wrapperGetName, wrapperGetPreset,
+		wrapperIterationStart, wrapperIterationNext, wrapperFree);
+	if (wrapper == nullptr) { return nullptr; }
+
+	font->addSynth();
+	fluid_sfont_set_data(wrapper, new FontHandle{std::move(font)});
+	return wrapper;
+}
+
+void freeLoader(fluid_sfloader_t* loader)
+{
+	delete_fluid_sfloader(loader);
+}
+
+#endif // FLUIDSYNTH_VERSION_MAJOR >= 2
+
+} // namespace
+
+
+
+
+Sf2SharedFont::Sf2SharedFont(fluid_sfont_t* font, const QString& path, qint64 fileSize) :
+	m_font(font),
+	m_path(path),
+	m_fileSize(fileSize)
+{
+}
+
+
+
+
+Sf2SharedFont::~Sf2SharedFont()
+{
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+	auto& reg = registry();
+	const auto guard = std::lock_guard{reg.mutex};
+	fluid_synth_sfunload(reg.host, fluid_sfont_get_id(m_font), false);
+
+	// A newer font for the same path may already be registered
+	const auto it = reg.fonts.find(m_path);
+	if (it != reg.fonts.end() && it->expired()) { reg.fonts.erase(it); }
+#endif
+}
+
+
+
+
+std::shared_ptr<Sf2SharedFont> Sf2FontRegistry::acquire(const QString& path)
+{
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+	const auto key = keyFor(path);
+	if (key.isEmpty()) { return nullptr; }
+
+	auto& reg = registry();
+	const auto guard = std::lock_guard{reg.mutex};
+
+	if (auto font = reg.fonts.value(key).lock()) { return font; }
+
+	const auto fileName = key.toLocal8Bit();
+	if (!fluid_is_soundfont(fileName.constData())) { return nullptr; }
+
+	const int id = fluid_synth_sfload(reg.host, fileName.constData(), false);
+	fluid_sfont_t* parsed = id >= 0 ? fluid_synth_get_sfont_by_id(reg.host, id) : nullptr;
+	if (parsed == nullptr) { return nullptr; }
+
+	auto font = std::make_shared<Sf2SharedFont>(parsed, key, QFileInfo{key}.size());
+	reg.fonts.insert(key, font);
+	return font;
+#else
+	Q_UNUSED(path)
+	return nullptr;
+#endif
+}
+
+
+
+
+void Sf2FontRegistry::installLoader(fluid_synth_t* synth)
+{
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+	if (auto loader = new_fluid_sfloader(loadWrapper, freeLoader))
+	{
+		// Added loaders are tried before the default one
+		fluid_synth_add_sfloader(synth, loader);
+	}
+#else
+	Q_UNUSED(synth)
+#endif
+}
+
+
+
+
+Sf2FontRegistry::Usage Sf2FontRegistry::usage()
+{
+	auto result = Usage{};
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+	// Collect strong references first: if one of them turns out to be the
+	// last one, the font must be released without the registry being locked
+	auto fonts = std::vector<std::shared_ptr<Sf2SharedFont>>{};
+	{
+		auto& reg = registry();
+		const auto guard = std::lock_guard{reg.mutex};
+		for (const auto& entry : reg.fonts)
+		{
+			if (auto font = entry.lock()) { fonts.push_back(std::move(font)); }
+		}
+	}
+
+	for (const auto& font : fonts)
+	{
+		++result.fonts;
+		result.synths += font->synthCount();
+		result.fileBytes += font->fileSize();
+	}
+#endif
+	return result;
+}
+
+
+
+
+QString Sf2FontRegistry::keyFor(const QString& path)
+{
+	const auto info = QFileInfo{path};
+	const auto canonical = info.canonicalFilePath();
+	return canonical.isEmpty() ? info.absoluteFilePath() : canonical;
+}
+
+
+} // namespace lmms
@@ -0,0 +1,111 @@
+/*
+ * Sf2FontRegistry.h - process-wide cache of parsed SoundFonts shared by all
+ *                     Sf2Player instances
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SF2_FONT_REGISTRY_H
+#define LMMS_SF2_FONT_REGISTRY_H
+
+#include <atomic>
+#include <fluidsynth/types.h>
+#include <memory>
+#include <QMutex>
+#include <QString>
+
+namespace lmms
+{
+
+
+/**
+ * A SoundFont parsed once and shared read-only by every synth that loads the
+ * same file. Each synth gets its own lightweight fluid_sfont_t that forwards
+ * to the shared one, so font IDs stay per-synth.
+ */
+class Sf2SharedFont
+{
+public:
+	Sf2SharedFont(fluid_sfont_t* font, const QString& path, qint64 fileSize);
+	~Sf2SharedFont();
+
+	Sf2SharedFont(const Sf2SharedFont&) = delete;
+	Sf2SharedFont& operator=(const Sf2SharedFont&) = delete;
+
+	fluid_sfont_t* font() const { return m_font; }
+	const QString& path() const { return m_path; }
+	//! Size of the file on disk, see Sf2FontRegistry::Usage::fileBytes
+	qint64 fileSize() const { return m_fileSize; }
+
+	//! Number of synths the font is currently loaded into
+	int synthCount() const { return m_synthCount; }
+	void addSynth() { ++m_synthCount; }
+	void removeSynth() { --m_synthCount; }
+
+	//! Selecting or deselecting a preset (un)loads its samples when dynamic
+	//! sample loading is enabled, which FluidSynth does not synchronize
+	//! between synths. Hold this while changing programs on a synth that
+	//! uses this font.
+	QMutex& presetMutex() { return m_presetMutex; }
+
+private:
+	fluid_sfont_t* m_font;
+	QString m_path;
+	qint64 m_fileSize;
+	std::atomic<int> m_synthCount = 0;
+	QMutex m_presetMutex;
+};
+
+
+
+
+class Sf2FontRegistry
+{
+public:
+	struct Usage
+	{
+		int fonts = 0;         //!< Number of distinct SoundFonts currently loaded
+		int synths = 0;        //!< Number of synths sharing those fonts
+		//! Total size of the loaded files on disk. This is not the memory in
+		//! use: samples are loaded on demand and SF3 samples are decompressed,
+		//! and FluidSynth does not report the size of the loaded sample data.
+		qint64 fileBytes = 0;
+	};
+
+	//! Return the shared font for `path`, parsing it if no one holds it yet.
+	//! Returns nullptr if the file is not a valid SoundFont or sharing is
+	//! unsupported by the FluidSynth version in use.
+	static std::shared_ptr<Sf2SharedFont> acquire(const QString& path);
+
+	//! Install a SoundFont loader on `synth` that serves fluid_synth_sfload()
+	//! from the registry. The synth takes ownership of the loader.
+	static void installLoader(fluid_synth_t* synth);
+
+	static Usage usage();
+
+private:
+	static QString keyFor(const QString& path);
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_SF2_FONT_REGISTRY_H
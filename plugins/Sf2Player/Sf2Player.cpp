@@ -38,10 +38,13 @@
 #include "InstrumentTrack.h"
 #include "InstrumentPlayHandle.h"
 #include "Knob.h"
+#include "LedCheckBox.h"
 #include "NotePlayHandle.h"
 #include "PathUtil.h"
 #include "PixmapButton.h"
 #include "Song.h"
+#include "Sf2FontRegistry.h"
+#include "Sf2SharedEngine.h"
 #include "fluidsynthshims.h"
 
 #include "PatchesDialog.h"
@@ -143,7 +146,9 @@ Sf2Instrument::Sf2Instrument( InstrumentTrack * _instrument_track ) :
 	m_chorusNum( FLUID_CHORUS_DEFAULT_N, 0, 10.0, 1.0, this, tr( "Chorus voices" ) ),
 	m_chorusLevel(FLUID_CHORUS_DEFAULT_LEVEL, 0, 10.f, 0.01f, this, tr("Chorus level")),
 	m_chorusSpeed(FLUID_CHORUS_DEFAULT_SPEED, 0.29f, 5.f, 0.01f, this, tr("Chorus speed")),
-	m_chorusDepth(FLUID_CHORUS_DEFAULT_DEPTH, 0, 46.f, 0.05f, this, tr("Chorus depth"))
+	m_chorusDepth(FLUID_CHORUS_DEFAULT_DEPTH, 0, 46.f, 0.05f, this, tr("Chorus depth")),
+	m_sharedEngineModel(false, this, tr("Shared engine")),
+	m_sharedChannel(-1)
 {
 
 
@@ -211,6 +216,8 @@ Sf2Instrument::Sf2Instrument( InstrumentTrack * _instrument_track ) :
 	connect( &m_chorusLevel, SIGNAL( dataChanged() ), this, SLOT( updateChorus() ) );
 	connect( &m_chorusSpeed, SIGNAL( dataChanged() ), this, SLOT( updateChorus() ) );
 	connect( &m_chorusDepth, SIGNAL( dataChanged() ), this, SLOT( updateChorus() ) );
+
+	connect(&m_sharedEngineModel, SIGNAL(dataChanged()), this, SLOT(updateSharedEngine()));
 	
 	// Microtuning
 	connect(Engine::getSong(), &Song::scaleListChanged, this, &Sf2Instrument::updateTuning);
@@ -232,6 +239,8 @@ Sf2Instrument::~Sf2Instrument()
 	Engine::audioEngine()->removePlayHandlesOfTypes( instrumentTrack(),
 				PlayHandle::Type::NotePlayHandle
 				| PlayHandle::Type::InstrumentPlayHandle );
+	if (m_sharedEngine) { m_sharedEngine->leave(m_sharedChannel); }
+	m_sharedEngine.reset();
 	freeFont();
 	delete_fluid_synth( m_synth );
 	delete_fluid_settings( m_settings );
@@ -258,6 +267,8 @@ void Sf2Instrument::saveSettings( QDomDocument & _doc, QDomElement & _this )
 	m_chorusLevel.saveSettings( _doc, _this, "chorusLevel" );
 	m_chorusSpeed.saveSettings( _doc, _this, "chorusSpeed" );
 	m_chorusDepth.saveSettings( _doc, _this, "chorusDepth" );
+
+	m_sharedEngineModel.saveSettings(_doc, _this, "sharedEngine");
 }
 
 
@@ -283,6 +294,7 @@ void Sf2Instrument::loadSettings( const QDomElement & _this )
 	m_chorusSpeed.loadSettings( _this, "chorusSpeed" );
 	m_chorusDepth.loadSettings( _this, "chorusDepth" );
 
+	m_sharedEngineModel.loadSettings(_this, "sharedEngine");
 }
 
 
@@ -323,6 +335,7 @@ void Sf2Instrument::loadFile( const QString & _file )
 				iBank += iBankOff;
 #endif
 
+				const auto presetLock = lockPresets();
 				::fluid_synth_bank_select( m_synth, 1, iBank );
 				::fluid_synth_program_change( m_synth, 1, iProg );
 				m_bankNum.setValue( iBank );
@@ -366,15 +379,46 @@ void Sf2Instrument::freeFont()
 
 	if (m_font != nullptr)
 	{
+		const auto presetLock = lockPresets();
 		fluid_synth_sfunload(m_synth, m_fontId, true);
 		m_font = nullptr;
 	}
+	m_sharedFont.reset();
 
 	m_synthMutex.unlock();
 }
 
 
 
+std::unique_lock<QMutex> Sf2Instrument::lockPresets()
+{
+	return m_sharedFont ? std::unique_lock{m_sharedFont->presetMutex()} : std::unique_lock<QMutex>{};
+}
+
+
+
+fluid_synth_t* Sf2Instrument::activeSynth() const
+{
+	return m_sharedEngine ? m_sharedEngine->synth() : m_synth;
+}
+
+
+
+int Sf2Instrument::activeChannel() const
+{
+	return m_sharedEngine ? m_sharedChannel : m_channel;
+}
+
+
+
+std::pair<fluid_synth_t*, int> Sf2Instrument::effectGroup() const
+{
+	// Each member of a shared engine has an effects group of its own
+	return m_sharedEngine ? std::pair{m_sharedEngine->synth(), m_sharedChannel} : std::pair{m_synth, -1};
+}
+
+
+
 void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
 {
 	emit fileLoading();
@@ -391,6 +435,11 @@ void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
 	bool loaded = false;
 	if (fluid_is_soundfont(sf2Ascii))
 	{
+		// Only parses the file if no other instance has it loaded already.
+		// The synth's loader then picks the shared font up from the registry.
+		m_sharedFont = Sf2FontRegistry::acquire(PathUtil::toAbsolute(_sf2File));
+
+		const auto presetLock = lockPresets();
 		m_fontId = fluid_synth_sfload(m_synth, sf2Ascii, true);
 
 		if (fluid_synth_sfcount(m_synth) > 0)
@@ -427,6 +476,7 @@ void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
 	}
 
 	updatePatch();
+	updateSharedEngine();
 }
 
 
@@ -436,8 +486,14 @@ void Sf2Instrument::updatePatch()
 {
 	if( m_bankNum.value() >= 0 && m_patchNum.value() >= 0 )
 	{
+		const auto presetLock = lockPresets();
 		fluid_synth_program_select( m_synth, m_channel, m_fontId,
 				m_bankNum.value(), m_patchNum.value() );
+		if (m_sharedEngine)
+		{
+			fluid_synth_program_select(m_sharedEngine->synth(), m_sharedChannel, m_sharedEngine->fontId(),
+				m_bankNum.value(), m_patchNum.value());
+		}
 	}
 }
 
@@ -502,7 +558,8 @@ void Sf2Instrument::updateGain()
 void Sf2Instrument::updateReverbOn()
 {
 #if USE_NEW_EFFECT_API
-	fluid_synth_reverb_on(m_synth, -1, m_reverbOn.value() ? 1 : 0);
+	const auto [synth, group] = effectGroup();
+	fluid_synth_reverb_on(synth, group, m_reverbOn.value() ? 1 : 0);
 #else
 	fluid_synth_set_reverb_on(m_synth, m_reverbOn.value() ? 1 : 0);
 #endif
@@ -511,10 +568,11 @@ void Sf2Instrument::updateReverbOn()
 void Sf2Instrument::updateReverb()
 {
 #if USE_NEW_EFFECT_API
-	fluid_synth_set_reverb_group_roomsize(m_synth, -1, m_reverbRoomSize.value());
-	fluid_synth_set_reverb_group_damp(m_synth, -1, m_reverbDamping.value());
-	fluid_synth_set_reverb_group_width(m_synth, -1, m_reverbWidth.value());
-	fluid_synth_set_reverb_group_level(m_synth, -1, m_reverbLevel.value());
+	const auto [synth, group] = effectGroup();
+	fluid_synth_set_reverb_group_roomsize(synth, group, m_reverbRoomSize.value());
+	fluid_synth_set_reverb_group_damp(synth, group, m_reverbDamping.value());
+	fluid_synth_set_reverb_group_width(synth, group, m_reverbWidth.value());
+	fluid_synth_set_reverb_group_level(synth, group, m_reverbLevel.value());
 #else
 	fluid_synth_set_reverb(m_synth, m_reverbRoomSize.value(),
 			m_reverbDamping.value(), m_reverbWidth.value(),
@@ -525,7 +583,8 @@ void Sf2Instrument::updateReverb()
 void Sf2Instrument::updateChorusOn()
 {
 #if USE_NEW_EFFECT_API
-	fluid_synth_chorus_on(m_synth, -1, m_chorusOn.value() ? 1 : 0);
+	const auto [synth, group] = effectGroup();
+	fluid_synth_chorus_on(synth, group, m_chorusOn.value() ? 1 : 0);
 #else
 	fluid_synth_set_chorus_on(m_synth, m_chorusOn.value() ? 1 : 0);
 #endif
@@ -534,11 +593,12 @@ void Sf2Instrument::updateChorusOn()
 void Sf2Instrument::updateChorus()
 {
 #if USE_NEW_EFFECT_API
-	fluid_synth_set_chorus_group_nr(m_synth, -1, static_cast<int>(m_chorusNum.value()));
-	fluid_synth_set_chorus_group_level(m_synth, -1, m_chorusLevel.value());
-	fluid_synth_set_chorus_group_speed(m_synth, -1, m_chorusSpeed.value());
-	fluid_synth_set_chorus_group_depth(m_synth, -1, m_chorusDepth.value());
-	fluid_synth_set_chorus_group_type(m_synth, -1, FLUID_CHORUS_MOD_SINE);
+	const auto [synth, group] = effectGroup();
+	fluid_synth_set_chorus_group_nr(synth, group, static_cast<int>(m_chorusNum.value()));
+	fluid_synth_set_chorus_group_level(synth, group, m_chorusLevel.value());
+	fluid_synth_set_chorus_group_speed(synth, group, m_chorusSpeed.value());
+	fluid_synth_set_chorus_group_depth(synth, group, m_chorusDepth.value());
+	fluid_synth_set_chorus_group_type(synth, group, FLUID_CHORUS_MOD_SINE);
 #else
 	fluid_synth_set_chorus(m_synth, static_cast<int>(m_chorusNum.value()),
 			m_chorusLevel.value(), m_chorusSpeed.value(),
@@ -548,9 +608,10 @@ void Sf2Instrument::updateChorus()
 
 void Sf2Instrument::updateTuning()
 {
-	if (instrumentTrack()->microtuner()->enabledModel()->value())
+	auto centArray = std::array<double, 128>{};
+	const bool enabled = instrumentTrack()->microtuner()->enabledModel()->value();
+	if (enabled)
 	{
-		auto centArray = std::array<double, 128>{};
 		double lowestHz = std::exp2(-69. / 12.) * 440.; // Frequency of MIDI note 0, which is approximately 8.175798916 Hz
 		for (int i = 0; i < 128; ++i)
 		{
@@ -559,20 +620,21 @@ void Sf2Instrument::updateTuning()
 			// Convert Hz to cents
 			centArray[i] = noteHz == 0. ? 0. : 1200. * log2(noteHz / lowestHz);
 		}
+	}
+	const double* cents = enabled ? centArray.data() : nullptr;
 
-		fluid_synth_activate_key_tuning(m_synth, 0, 0, "", centArray.data(), true);
-		for (int chan = 0; chan < 16; chan++)
-		{
-		    fluid_synth_activate_tuning(m_synth, chan, 0, 0, true);
-		}
+	if (m_sharedEngine)
+	{
+		// The members of a shared engine each use the tuning program of their channel
+		fluid_synth_activate_key_tuning(m_sharedEngine->synth(), 0, m_sharedChannel, "", cents, true);
+		fluid_synth_activate_tuning(m_sharedEngine->synth(), m_sharedChannel, 0, m_sharedChannel, true);
+		return;
 	}
-	else
+
+	fluid_synth_activate_key_tuning(m_synth, 0, 0, "", cents, true);
+	for (int chan = 0; chan < 16; chan++)
 	{
-		fluid_synth_activate_key_tuning(m_synth, 0, 0, "", nullptr, true);
-		for (int chan = 0; chan < 16; chan++)
-		{
-		    fluid_synth_activate_tuning(m_synth, chan, 0, 0, true);
-		}
+	    fluid_synth_activate_tuning(m_synth, chan, 0, 0, true);
 	}
 }
 
@@ -593,12 +655,27 @@ void Sf2Instrument::reloadSynth()
 	{
 		// Now, delete the old one and replace
 		m_synthMutex.lock();
-		fluid_synth_remove_sfont( m_synth, m_font );
-		delete_fluid_synth( m_synth );
+		if (m_sharedFont)
+		{
+			// We still hold the parsed font, so loading it into the new synth
+			// only creates another reference to it
+			const auto presetLock = lockPresets();
+			delete_fluid_synth(m_synth);
+			m_synth = new_fluid_synth(m_settings);
+			Sf2FontRegistry::installLoader(m_synth);
+			m_fontId = fluid_synth_sfload(m_synth, qPrintable(m_sharedFont->path()), false);
+			m_font = fluid_synth_get_sfont_by_id(m_synth, m_fontId);
+		}
+		else
+		{
+			fluid_synth_remove_sfont( m_synth, m_font );
+			delete_fluid_synth( m_synth );
 
-		// New synth
-		m_synth = new_fluid_synth( m_settings );
-		m_fontId = fluid_synth_add_sfont( m_synth, m_font );
+			// New synth
+			m_synth = new_fluid_synth( m_settings );
+			Sf2FontRegistry::installLoader(m_synth);
+			m_fontId = fluid_synth_add_sfont( m_synth, m_font );
+		}
 		m_synthMutex.unlock();
 
 		// synth program change (set bank and patch)
@@ -613,6 +690,7 @@ void Sf2Instrument::reloadSynth()
 			delete_fluid_synth(m_synth);
 		}
 		m_synth = new_fluid_synth( m_settings );
+		Sf2FontRegistry::installLoader(m_synth);
 		m_synthMutex.unlock();
 	}
 
@@ -641,6 +719,46 @@ void Sf2Instrument::reloadSynth()
 	// upon playing the next note
 	m_lastMidiPitch = -1;
 	m_lastMidiPitchRange = -1;
+
+	updateSharedEngine();
+}
+
+
+
+
+void Sf2Instrument::updateSharedEngine()
+{
+	// Sharing needs a loaded font, and the engine renders without resampling
+	const bool share = m_sharedEngineModel.value() && m_sharedFont
+		&& m_internalSampleRate == Engine::audioEngine()->outputSampleRate();
+	if (!share && !m_sharedEngine) { return; }
+
+	// Running notes hold voices of the synth they were started on
+	Engine::audioEngine()->removePlayHandlesOfTypes(instrumentTrack(), PlayHandle::Type::NotePlayHandle);
+
+	Engine::audioEngine()->requestChangeInModel();
+	if (m_sharedEngine)
+	{
+		m_sharedEngine->leave(m_sharedChannel);
+		m_sharedEngine.reset();
+		m_sharedChannel = -1;
+	}
+	if (share)
+	{
+		m_sharedEngine = Sf2SharedEngine::join(m_sharedFont->path(), m_internalSampleRate, this, m_sharedChannel);
+	}
+	Engine::audioEngine()->doneChangeInModel();
+
+	// Bring the synth we play on now up to date
+	updatePatch();
+	updateReverb();
+	updateChorus();
+	updateReverbOn();
+	updateChorusOn();
+	updateTuning();
+
+	m_lastMidiPitch = -1;
+	m_lastMidiPitchRange = -1;
 }
 
 
@@ -713,23 +831,25 @@ void Sf2Instrument::noteOn( Sf2PluginData * n )
 
 	// get list of current voice IDs so we can easily spot the new
 	// voice after the fluid_synth_noteon() call
-	const int poly = fluid_synth_get_polyphony( m_synth );
+	fluid_synth_t* synth = activeSynth();
+	const int channel = activeChannel();
+	const int poly = fluid_synth_get_polyphony( synth );
 #ifndef _MSC_VER
 	fluid_voice_t* voices[poly];
 #else
 	const auto voices = static_cast<fluid_voice_t**>(_alloca(poly * sizeof(fluid_voice_t*)));
 #endif
 
-	fluid_synth_noteon( m_synth, m_channel, n->midiNote, n->lastVelocity );
+	fluid_synth_noteon( synth, channel, n->midiNote, n->lastVelocity );
 
 	// Get any new voices and store them in the plugin data
-	fluid_synth_get_voicelist(m_synth, voices, poly, -1);
+	fluid_synth_get_voicelist(synth, voices, poly, -1);
 	for (int i = 0; i < poly && voices[i] && !n->fluidVoices.full(); ++i)
 	{
 		const auto voice = voices[i];
 		// FluidSynth stops voices with the same channel and pitch upon note-on,
 		// so voices with the current channel and pitch are playing this note.
-		if (fluid_voice_get_channel(voice) == m_channel
+		if (fluid_voice_get_channel(voice) == channel
 			&& fluid_voice_get_key(voice) == n->midiNote
 			&& fluid_voice_is_on(voice)
 		) {
@@ -775,23 +895,21 @@ void Sf2Instrument::noteOff( Sf2PluginData * n )
 	if( notes <= 0 )
 	{
 		m_synthMutex.lock();
-		fluid_synth_noteoff( m_synth, m_channel, n->midiNote );
+		fluid_synth_noteoff( activeSynth(), activeChannel(), n->midiNote );
 		m_synthMutex.unlock();
 	}
 }
 
 
-void Sf2Instrument::play( SampleFrame* _working_buffer )
+void Sf2Instrument::updatePitch()
 {
-	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
-
 	// set midi pitch for this period
 	const int currentMidiPitch = instrumentTrack()->midiPitch();
 	if( m_lastMidiPitch != currentMidiPitch )
 	{
 		m_lastMidiPitch = currentMidiPitch;
 		m_synthMutex.lock();
-		fluid_synth_pitch_bend( m_synth, m_channel, m_lastMidiPitch );
+		fluid_synth_pitch_bend( activeSynth(), activeChannel(), m_lastMidiPitch );
 		m_synthMutex.unlock();
 	}
 
@@ -800,9 +918,71 @@ void Sf2Instrument::play( SampleFrame* _working_buffer )
 	{
 		m_lastMidiPitchRange = currentMidiPitchRange;
 		m_synthMutex.lock();
-		fluid_synth_pitch_wheel_sens( m_synth, m_channel, m_lastMidiPitchRange );
+		fluid_synth_pitch_wheel_sens( activeSynth(), activeChannel(), m_lastMidiPitchRange );
 		m_synthMutex.unlock();
 	}
+}
+
+
+bool Sf2Instrument::startPlay()
+{
+	if (!m_sharedEngine)
+	{
+		return false;
+	}
+
+	updatePitch();
+
+	// Hand this period's note ons and offs to the shared engine, which sends
+	// them at their offsets while it renders all of its members at once
+	m_playingNotesMutex.lock();
+	for (const auto note : m_playingNotes)
+	{
+		auto data = static_cast<Sf2PluginData*>(note->m_pluginData);
+		if (data->isNew)
+		{
+			m_sharedEngine->queueNoteEvent(this, data, data->offset, true);
+			if (!note->isReleased()) { continue; }
+			// if the note is released during the same period, it needs a noteoff too
+			data->isNew = false;
+			data->offset = note->framesBeforeRelease();
+		}
+		m_sharedEngine->queueNoteEvent(this, data, data->offset, false);
+	}
+	m_playingNotes.clear();
+	m_playingNotesMutex.unlock();
+
+	return true;
+}
+
+
+void Sf2Instrument::queueJobs( std::vector<ThreadableJob*>& _jobs )
+{
+	m_sharedEngine->queueJob(_jobs);
+}
+
+
+void Sf2Instrument::finishPlay( SampleFrame* _working_buffer )
+{
+	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
+	const float* left = m_sharedEngine->output(m_sharedChannel, 0);
+	const float* right = m_sharedEngine->output(m_sharedChannel, 1);
+
+	// The engine renders at unity gain, so every member can have its own
+	const float gain = m_gain.value();
+	for (f_cnt_t f = 0; f < frames; ++f)
+	{
+		_working_buffer[f] = SampleFrame{left[f] * gain, right[f] * gain};
+	}
+}
+
+
+void Sf2Instrument::play( SampleFrame* _working_buffer )
+{
+	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
+
+	updatePitch();
+
 	// if we have no new noteons/noteoffs, just render a period and call it a day
 	if( m_playingNotes.isEmpty() )
 	{
@@ -912,6 +1092,7 @@ void Sf2Instrument::deleteNotePluginData( NotePlayHandle * _n )
 	if( ! pluginData->noteOffSent ) // if we for some reason haven't noteoffed the note before it gets deleted,
 									// do it here
 	{
+		if (m_sharedEngine) { m_sharedEngine->dropNoteEvents(pluginData); }
 		noteOff( pluginData );
 		m_playingNotesMutex.lock();
 		if( m_playingNotes.indexOf( _n ) >= 0 )
@@ -1082,6 +1263,19 @@ Sf2InstrumentView::Sf2InstrumentView( Instrument * _instrument, QWidget * _paren
 	m_chorusDepthKnob = new Sf2Knob( this );
 	m_chorusDepthKnob->setHintText( tr("Depth:"), "" );
 	m_chorusDepthKnob->move( 204 , 206 );
+
+	m_sharedEngineCheckBox = new LedCheckBox(tr("Shared engine"), this);
+	m_sharedEngineCheckBox->move(14, 142);
+	if (Sf2SharedEngine::isSupported())
+	{
+		m_sharedEngineCheckBox->setToolTip(tr("Render together with other instances using the same SoundFont. "
+			"Saves CPU when many tracks use one SoundFont."));
+	}
+	else
+	{
+		m_sharedEngineCheckBox->setEnabled(false);
+		m_sharedEngineCheckBox->setToolTip(tr("Requires FluidSynth 2.2 or newer"));
+	}
 /*
 	hl->addWidget( m_chorusOnLed );
 	hl->addWidget( m_chorusNumKnob);
@@ -1122,6 +1316,8 @@ void Sf2InstrumentView::modelChanged()
 	m_chorusSpeedKnob->setModel( &k->m_chorusSpeed );
 	m_chorusDepthKnob->setModel( &k->m_chorusDepth );
 
+	m_sharedEngineCheckBox->setModel(&k->m_sharedEngineModel);
+
 
 	connect( k, SIGNAL( fileChanged() ), this, SLOT( updateFilename() ) );
 
@@ -1145,6 +1341,22 @@ void Sf2InstrumentView::updateFilename()
 
 	m_patchDialogButton->setEnabled( !i->m_filename.isEmpty() );
 
+	if (i->m_sharedFont)
+	{
+		const auto usage = Sf2FontRegistry::usage();
+		m_filenameLabel->setToolTip(tr("%1\nShared by %2 instrument(s), file size %3 MiB\n"
+				"All SoundFonts: %4 loaded, total file size %5 MiB")
+			.arg(i->m_sharedFont->path())
+			.arg(i->m_sharedFont->synthCount())
+			.arg(i->m_sharedFont->fileSize() / (1024. * 1024.), 0, 'f', 1)
+			.arg(usage.fonts)
+			.arg(usage.fileBytes / (1024. * 1024.), 0, 'f', 1));
+	}
+	else
+	{
+		m_filenameLabel->setToolTip(i->m_filename);
+	}
+
 	updatePatchName();
 
 	update();
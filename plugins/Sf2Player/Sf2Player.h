@@ -29,8 +29,11 @@
 
 #include <array>
 #include <fluidsynth/types.h>
+#include <memory>
+#include <mutex>
 #include <QMutex>
 #include <samplerate.h>
+#include <utility>
 
 #include "AudioEngine.h"
 #include "AudioResampler.h"
@@ -47,10 +50,13 @@ namespace lmms
 
 struct Sf2PluginData;
 class NotePlayHandle;
+class Sf2SharedEngine;
+class Sf2SharedFont;
 
 namespace gui
 {
 class Knob;
+class LedCheckBox;
 class PixmapButton;
 class Sf2InstrumentView;
 class PatchesDialog;
@@ -68,6 +74,9 @@ public:
 	~Sf2Instrument() override;
 
 	void play( SampleFrame* _working_buffer ) override;
+	bool startPlay() override;
+	void queueJobs( std::vector<ThreadableJob*>& _jobs ) override;
+	void finishPlay( SampleFrame* _working_buffer ) override;
 
 	void playNote( NotePlayHandle * _n,
 						SampleFrame* _working_buffer ) override;
@@ -104,6 +113,7 @@ public slots:
 	void updateChorus();
 	void updateGain();
 	void updateTuning();
+	void updateSharedEngine();
 
 private:
 	AudioResampler m_resampler;
@@ -114,6 +124,8 @@ private:
 	fluid_synth_t* m_synth;
 
 	fluid_sfont_t* m_font;
+	//! Keeps the parsed font alive while the synth is being re-created
+	std::shared_ptr<Sf2SharedFont> m_sharedFont;
 
 	int m_fontId;
 	QString m_filename;
@@ -148,16 +160,30 @@ private:
 	FloatModel m_chorusSpeed;
 	FloatModel m_chorusDepth;
 
+	//! Render through a FluidSynth shared with other instances using the same font
+	BoolModel m_sharedEngineModel;
+	std::shared_ptr<Sf2SharedEngine> m_sharedEngine;
+	//! MIDI channel and effects group of this instance in m_sharedEngine
+	int m_sharedChannel;
+
 	QVector<NotePlayHandle *> m_playingNotes;
 	QMutex m_playingNotesMutex;
 
 private:
 	void freeFont();
+	std::unique_lock<QMutex> lockPresets();
+	//! The synth notes are played on, which is the shared one if there is one
+	fluid_synth_t* activeSynth() const;
+	int activeChannel() const;
+	//! The synth and effects group the reverb and chorus settings apply to
+	std::pair<fluid_synth_t*, int> effectGroup() const;
+	void updatePitch();
 	void noteOn( Sf2PluginData * n );
 	void noteOff( Sf2PluginData * n );
 	void renderFrames( f_cnt_t frames, SampleFrame* buf );
 
 	friend class gui::Sf2InstrumentView;
+	friend class Sf2SharedEngine;
 
 signals:
 	void fileLoading();
@@ -205,6 +231,8 @@ private:
 	Knob * m_chorusSpeedKnob;
 	Knob * m_chorusDepthKnob;
 
+	LedCheckBox * m_sharedEngineCheckBox;
+
 	static PatchesDialog * s_patchDialog;
 
 protected slots:
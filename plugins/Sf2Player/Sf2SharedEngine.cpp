@@ -0,0 +1,274 @@
+/*
+ * Sf2SharedEngine.cpp - one FluidSynth instance shared by several Sf2Players
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Sf2SharedEngine.h"
+
+#include <algorithm>
+#include <fluidsynth.h>
+#include <QHash>
+#include <QMutex>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "Sf2FontRegistry.h"
+#include "Sf2Player.h"
+
+// Rendering MIDI channels to separate outputs and configuring effects per
+// group needs the FluidSynth 2.2 API
+#define LMMS_SF2_SHARED_ENGINE_SUPPORTED (FLUIDSYNTH_VERSION_MAJOR > 2 \
+	|| (FLUIDSYNTH_VERSION_MAJOR == 2 && FLUIDSYNTH_VERSION_MINOR >= 2))
+
+namespace lmms
+{
+
+
+namespace
+{
+
+struct EngineRegistry
+{
+	QMutex mutex;
+	//! engines by font path and sample rate
+	QHash<QString, std::vector<std::weak_ptr<Sf2SharedEngine>>> engines;
+};
+
+EngineRegistry& engineRegistry()
+{
+	static EngineRegistry s_registry;
+	return s_registry;
+}
+
+} // namespace
+
+
+
+
+bool Sf2SharedEngine::isSupported()
+{
+#if LMMS_SF2_SHARED_ENGINE_SUPPORTED
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+
+std::shared_ptr<Sf2SharedEngine> Sf2SharedEngine::join(const QString& path, sample_rate_t sampleRate,
+	Sf2Instrument* member, int& channel)
+{
+	channel = -1;
+	if (!isSupported()) { return nullptr; }
+
+	auto& reg = engineRegistry();
+	const auto guard = std::lock_guard{reg.mutex};
+
+	auto& engines = reg.engines[path + QLatin1Char('@') + QString::number(sampleRate)];
+	std::erase_if(engines, [](const auto& engine) { return engine.expired(); });
+
+	for (const auto& weakEngine : engines)
+	{
+		if (auto engine = weakEngine.lock())
+		{
+			channel = engine->addMember(member);
+			if (channel >= 0) { return engine; }
+		}
+	}
+
+	auto engine = std::make_shared<Sf2SharedEngine>(path, sampleRate);
+	if (engine->m_fontId < 0) { return nullptr; }
+	channel = engine->addMember(member);
+	engines.push_back(engine);
+	return engine;
+}
+
+
+
+
+Sf2SharedEngine::Sf2SharedEngine(const QString& path, sample_rate_t sampleRate) :
+	m_path(path),
+	m_sampleRate(sampleRate),
+	m_frames(Engine::audioEngine()->framesPerPeriod()),
+	m_buffer(2 * MaxMembers * m_frames),
+	m_job(this)
+{
+	m_settings = new_fluid_settings();
+	fluid_settings_setnum(m_settings, "synth.sample-rate", sampleRate);
+	// one MIDI channel, stereo output and effects group per member
+	fluid_settings_setint(m_settings, "synth.midi-channels", MaxMembers);
+	fluid_settings_setint(m_settings, "synth.audio-channels", MaxMembers);
+	fluid_settings_setint(m_settings, "synth.audio-groups", MaxMembers);
+	fluid_settings_setint(m_settings, "synth.effects-groups", MaxMembers);
+	// the voice pool is shared by all members
+	fluid_settings_setint(m_settings, "synth.polyphony", 1024);
+	m_synth = new_fluid_synth(m_settings);
+
+	// The members apply their gain to their own outputs, and turn the effects
+	// of their groups on themselves
+	fluid_synth_set_gain(m_synth, 1.f);
+#if LMMS_SF2_SHARED_ENGINE_SUPPORTED
+	fluid_synth_reverb_on(m_synth, -1, 0);
+	fluid_synth_chorus_on(m_synth, -1, 0);
+#endif
+
+	// The font is parsed only once for all synths, see Sf2FontRegistry
+	Sf2FontRegistry::installLoader(m_synth);
+	m_font = Sf2FontRegistry::acquire(path);
+	if (m_font) { m_fontId = fluid_synth_sfload(m_synth, path.toLocal8Bit().constData(), false); }
+
+	m_events.reserve(1024);
+}
+
+
+
+
+Sf2SharedEngine::~Sf2SharedEngine()
+{
+	delete_fluid_synth(m_synth);
+	delete_fluid_settings(m_settings);
+}
+
+
+
+
+int Sf2SharedEngine::addMember(Sf2Instrument* member)
+{
+	const auto guard = std::lock_guard{m_mutex};
+	const auto it = std::find(m_members.begin(), m_members.end(), nullptr);
+	if (it == m_members.end()) { return -1; }
+	*it = member;
+	return static_cast<int>(it - m_members.begin());
+}
+
+
+
+
+void Sf2SharedEngine::leave(int channel)
+{
+	const auto guard = std::lock_guard{m_mutex};
+	std::erase_if(m_events, [this, channel](const NoteEvent& e) { return e.member == m_members[channel]; });
+	m_members[channel] = nullptr;
+
+	// the next member on this channel must start from a clean state
+	fluid_synth_all_sounds_off(m_synth, channel);
+	fluid_synth_cc(m_synth, channel, 121, 0); // reset all controllers
+	fluid_synth_pitch_bend(m_synth, channel, 8192);
+}
+
+
+
+
+void Sf2SharedEngine::queueNoteEvent(Sf2Instrument* member, Sf2PluginData* data, f_cnt_t offset, bool noteOn)
+{
+	const auto guard = std::lock_guard{m_mutex};
+	m_events.push_back(NoteEvent{offset, member, data, noteOn});
+}
+
+
+
+
+void Sf2SharedEngine::dropNoteEvents(const Sf2PluginData* data)
+{
+	const auto guard = std::lock_guard{m_mutex};
+	std::erase_if(m_events, [data](const NoteEvent& e) { return e.data == data; });
+}
+
+
+
+
+void Sf2SharedEngine::queueJob(std::vector<ThreadableJob*>& jobs)
+{
+	if (!m_jobQueued.exchange(true)) { jobs.push_back(&m_job); }
+}
+
+
+
+
+void Sf2SharedEngine::RenderJob::doProcessing()
+{
+	m_engine->render();
+}
+
+
+
+
+void Sf2SharedEngine::render()
+{
+	const auto guard = std::lock_guard{m_mutex};
+
+	std::fill(m_buffer.begin(), m_buffer.end(), 0.f);
+
+	// Members queued their events in parallel, so bring them into time order.
+	// The sort is stable to keep the order of events of one member.
+	std::stable_sort(m_events.begin(), m_events.end(),
+		[](const NoteEvent& a, const NoteEvent& b) { return a.offset < b.offset; });
+
+	f_cnt_t currentFrame = 0;
+	for (const auto& event : m_events)
+	{
+		if (event.offset > currentFrame)
+		{
+			renderFrames(currentFrame, event.offset);
+			currentFrame = event.offset;
+		}
+		if (event.noteOn) { event.member->noteOn(event.data); }
+		else { event.member->noteOff(event.data); }
+	}
+	m_events.clear();
+
+	if (currentFrame < m_frames) { renderFrames(currentFrame, m_frames); }
+
+	m_jobQueued = false;
+}
+
+
+
+
+void Sf2SharedEngine::renderFrames(f_cnt_t from, f_cnt_t to)
+{
+	fluid_synth_get_gain(m_synth); // This flushes voice updates as a side effect
+
+	std::array<float*, 2 * MaxMembers> out;
+	for (std::size_t i = 0; i < out.size(); ++i)
+	{
+		out[i] = m_buffer.data() + i * m_frames + from;
+	}
+
+	// Reverb and chorus of each group are mixed into the output of the
+	// group's member, in the order FluidSynth expects: for each group,
+	// reverb left/right, then chorus left/right
+	std::array<float*, 4 * MaxMembers> fx;
+	for (int group = 0; group < MaxMembers; ++group)
+	{
+		fx[4 * group + 0] = fx[4 * group + 2] = out[2 * group];
+		fx[4 * group + 1] = fx[4 * group + 3] = out[2 * group + 1];
+	}
+
+	fluid_synth_process(m_synth, static_cast<int>(to - from),
+		static_cast<int>(fx.size()), fx.data(), static_cast<int>(out.size()), out.data());
+}
+
+
+} // namespace lmms
@@ -0,0 +1,151 @@
+/*
+ * Sf2SharedEngine.h - one FluidSynth instance shared by several Sf2Players
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SF2_SHARED_ENGINE_H
+#define LMMS_SF2_SHARED_ENGINE_H
+
+#include <array>
+#include <atomic>
+#include <fluidsynth/types.h>
+#include <memory>
+#include <mutex>
+#include <QString>
+#include <vector>
+
+#include "LmmsTypes.h"
+#include "ThreadableJob.h"
+
+namespace lmms
+{
+
+
+class Sf2Instrument;
+class Sf2SharedFont;
+struct Sf2PluginData;
+
+
+/**
+ * A multi-channel FluidSynth shared by up to MaxMembers Sf2Player instruments
+ * that play the same SoundFont at the same sample rate.
+ *
+ * Each member owns one MIDI channel, which FluidSynth renders into its own
+ * stereo output and its own reverb/chorus group. All members thereby share
+ * one voice pool, and the whole engine is rendered by a single job per period
+ * instead of one fluid_synth_write_float() call per instrument.
+ *
+ * Members hand their note events for a period to the engine from
+ * Instrument::startPlay(); the job dispatches them at their frame offsets
+ * while rendering, and the members pick up their outputs in finishPlay().
+ */
+class Sf2SharedEngine
+{
+public:
+	static constexpr int MaxMembers = 16;
+
+	//! Whether the FluidSynth version in use can render channels separately
+	static bool isSupported();
+
+	//! Join an engine for the font at @p path, creating one if all engines
+	//! for it are full. Sets @p channel to the MIDI channel of the member.
+	//! Returns nullptr if sharing is unsupported or the font can not be loaded.
+	static std::shared_ptr<Sf2SharedEngine> join(const QString& path, sample_rate_t sampleRate,
+		Sf2Instrument* member, int& channel);
+
+	Sf2SharedEngine(const QString& path, sample_rate_t sampleRate);
+	~Sf2SharedEngine();
+
+	Sf2SharedEngine(const Sf2SharedEngine&) = delete;
+	Sf2SharedEngine& operator=(const Sf2SharedEngine&) = delete;
+
+	//! Silence and release @p channel
+	void leave(int channel);
+
+	fluid_synth_t* synth() const { return m_synth; }
+	int fontId() const { return m_fontId; }
+
+	//! Queue a note on or off of @p member, to be sent at frame @p offset of this period
+	void queueNoteEvent(Sf2Instrument* member, Sf2PluginData* data, f_cnt_t offset, bool noteOn);
+	//! Forget queued events of a note that is about to be deleted
+	void dropNoteEvents(const Sf2PluginData* data);
+	//! Add the render job of this period, unless another member already did
+	void queueJob(std::vector<ThreadableJob*>& jobs);
+
+	//! Left (@p side 0) or right output of @p channel rendered in this period
+	const float* output(int channel, int side) const
+	{
+		return m_buffer.data() + (2 * channel + side) * m_frames;
+	}
+
+private:
+	class RenderJob : public ThreadableJob
+	{
+	public:
+		explicit RenderJob(Sf2SharedEngine* engine) : m_engine(engine) {}
+		bool requiresProcessing() const override { return true; }
+
+	protected:
+		void doProcessing() override;
+
+	private:
+		Sf2SharedEngine* m_engine;
+	};
+
+	struct NoteEvent
+	{
+		f_cnt_t offset;
+		Sf2Instrument* member;
+		Sf2PluginData* data;
+		bool noteOn;
+	};
+
+	//! Claim a free channel for @p member, or return -1
+	int addMember(Sf2Instrument* member);
+	void render();
+	void renderFrames(f_cnt_t from, f_cnt_t to);
+
+	QString m_path;
+	sample_rate_t m_sampleRate;
+
+	fluid_settings_t* m_settings;
+	fluid_synth_t* m_synth;
+	std::shared_ptr<Sf2SharedFont> m_font;
+	int m_fontId = -1;
+
+	//! guards m_members and m_events
+	std::mutex m_mutex;
+	std::array<Sf2Instrument*, MaxMembers> m_members = {};
+	std::vector<NoteEvent> m_events;
+
+	f_cnt_t m_frames;
+	//! planar outputs, two channels per member
+	std::vector<float> m_buffer;
+
+	RenderJob m_job;
+	std::atomic<bool> m_jobQueued = false;
+};
+
+
+} // namespace lmms
+
+#endif // LMMS_SF2_SHARED_ENGINE_H
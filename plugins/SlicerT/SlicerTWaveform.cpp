@@ -88,6 +88,9 @@ SlicerTWaveform::SlicerTWaveform(int totalWidth, int totalHeight, SlicerT* instr
 
 	connect(instrument, &SlicerT::isPlaying, this, &SlicerTWaveform::isPlaying);
 	connect(instrument, &SlicerT::dataChanged, this, &SlicerTWaveform::updateUI);
+	connect(SampleThumbnail::notifier(), &SampleThumbnailNotifier::thumbnailReady, this, [this] {
+		if (m_thumbnailPending && m_sampleThumbnail.isReady()) { updateUI(); }
+	});
 
 	m_emptySampleIcon = m_emptySampleIcon.createMaskFromColor(QColor(255, 255, 255), Qt::MaskMode::MaskOutColor);
 
@@ -120,6 +123,7 @@ void SlicerTWaveform::drawSeekerWaveform()
 	const auto& sample = m_slicerTParent->m_originalSample;
 
 	m_sampleThumbnail = SampleThumbnail{sample};
+	m_thumbnailPending = !m_sampleThumbnail.isReady();
 
 	const auto param = SampleThumbnail::VisualizeParameters{
 		.sampleRect = m_seekerWaveform.rect(),
@@ -188,6 +192,7 @@ void SlicerTWaveform::drawEditorWaveform()
 	const auto& sample = m_slicerTParent->m_originalSample;
 
 	m_sampleThumbnail = SampleThumbnail{sample};
+	m_thumbnailPending = !m_sampleThumbnail.isReady();
 
 	const auto param = SampleThumbnail::VisualizeParameters{
 		.sampleRect = QRect(0, zoomOffset, m_editorWidth, static_cast<long>(m_zoomLevel * m_editorHeight)),
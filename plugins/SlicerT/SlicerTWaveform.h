@@ -108,6 +108,7 @@ private:
 	QPixmap m_emptySampleIcon;
 	
 	SampleThumbnail m_sampleThumbnail;
+	bool m_thumbnailPending = false;
 
 	SlicerT* m_slicerTParent;
 
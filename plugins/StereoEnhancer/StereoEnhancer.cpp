@@ -82,8 +82,12 @@ StereoEnhancerEffect::~StereoEnhancerEffect()
 
 
 
-Effect::ProcessStatus StereoEnhancerEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus StereoEnhancerEffect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
 {
+	const f_cnt_t frames = inOut.frames();
+	sample_t* left = inOut[0];
+	sample_t* right = inOut[1];
+
 	m_delayBufferCleared = false;
 	const float d = dryLevel();
 	const float w = wetLevel();
@@ -92,8 +96,8 @@ Effect::ProcessStatus StereoEnhancerEffect::processImpl(SampleFrame* buf, const
 	{
 
 		// copy samples into the delay buffer
-		m_delayBuffer[m_currFrame][0] = buf[f][0];
-		m_delayBuffer[m_currFrame][1] = buf[f][1];
+		m_delayBuffer[m_currFrame][0] = left[f];
+		m_delayBuffer[m_currFrame][1] = right[f];
 
 		// Get the width knob value from the Stereo Enhancer effect
 		float width = m_seFX.wideCoeff();
@@ -107,13 +111,13 @@ Effect::ProcessStatus StereoEnhancerEffect::processImpl(SampleFrame* buf, const
 			frameIndex += DEFAULT_BUFFER_SIZE;
 		}
 
-		//sample_t s[2] = { buf[f][0], buf[f][1] };	//Vanilla
-		auto s = std::array{buf[f][0], m_delayBuffer[frameIndex][1]};	//Chocolate
+		//sample_t s[2] = { left[f], right[f] };	//Vanilla
+		auto s = std::array{left[f], m_delayBuffer[frameIndex][1]};	//Chocolate
 
 		m_seFX.nextSample( s[0], s[1] );
 
-		buf[f][0] = d * buf[f][0] + w * s[0];
-		buf[f][1] = d * buf[f][1] + w * s[1];
+		left[f] = d * left[f] + w * s[0];
+		right[f] = d * right[f] + w * s[1];
 
 		// Update currFrame
 		m_currFrame += 1;
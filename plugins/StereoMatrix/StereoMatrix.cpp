@@ -64,25 +64,29 @@ StereoMatrixEffect::StereoMatrixEffect(
 
 
 
-Effect::ProcessStatus StereoMatrixEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus StereoMatrixEffect::processPlanarImpl(PlanarBufferView<float, 2> inOut)
 {
+	const f_cnt_t frames = inOut.frames();
+	sample_t* left = inOut[0];
+	sample_t* right = inOut[1];
+
 	for (f_cnt_t f = 0; f < frames; ++f)
 	{	
 		const float d = dryLevel();
 		const float w = wetLevel();
 		
-		sample_t l = buf[f][0];
-		sample_t r = buf[f][1];
+		sample_t l = left[f];
+		sample_t r = right[f];
 
 		// Init with dry-mix
-		buf[f][0] = l * d;
-		buf[f][1] = r * d;
+		left[f] = l * d;
+		right[f] = r * d;
 
 		// Add it wet
-		buf[f][0] += ( m_smControls.m_llModel.value( f ) * l  +
+		left[f] += ( m_smControls.m_llModel.value( f ) * l  +
 					m_smControls.m_rlModel.value( f ) * r ) * w;
 
-		buf[f][1] += ( m_smControls.m_lrModel.value( f ) * l  +
+		right[f] += ( m_smControls.m_lrModel.value( f ) * l  +
 					m_smControls.m_rrModel.value( f ) * r ) * w;
 	}
 
@@ -26,6 +26,7 @@
 
 #include "Mallets.h"
 
+#include <algorithm>
 #include <QDir>
 #include <QDomElement>
 #include <QMessageBox>
@@ -49,6 +50,65 @@ namespace lmms
 {
 
 
+namespace
+{
+
+// The STK models don't offer a way to return to their initial state, which
+// pooled voices need before every note. These reach into the protected
+// members to do what a fresh object would start with.
+
+class ResettableModalBar : public ModalBar
+{
+public:
+	void reset()
+	{
+		clear();
+		envelope_.setValue( 0.0 );
+		vibrato_.reset();
+	}
+};
+
+
+class ResettableTubeBell : public TubeBell
+{
+public:
+	void reset()
+	{
+		for( auto wave : waves_ )
+		{
+			wave->reset();
+		}
+		// all TubeBell envelopes have a sustain level of 0
+		for( auto adsr : adsr_ )
+		{
+			adsr->setValue( 0.0 );
+		}
+		vibrato_.reset();
+		twozero_.clear();
+	}
+};
+
+
+class ResettableBandedWG : public BandedWG
+{
+public:
+	void reset()
+	{
+		clear();
+		// setValue() also changes the sustain level; restore the
+		// one the BandedWG constructor sets
+		adsr_.setValue( 0.0 );
+		adsr_.setSustainLevel( 0.9 );
+		velocityInput_ = 0.0;
+		bowVelocity_ = 0.0;
+		bowTarget_ = 0.0;
+		strikeAmp_ = 0.0;
+	}
+};
+
+} // namespace
+
+
 extern "C"
 {
 
@@ -127,6 +187,21 @@ MalletsInstrument::MalletsInstrument( InstrumentTrack * _instrument_track ):
 	m_scalers.append( 16.0 );
 	m_presetsModel.addItem( tr( "Tibetan bowl" ) );
 	m_scalers.append( 7.0 );
+
+	connect( &m_presetsModel, SIGNAL( dataChanged() ),
+		this, SLOT( updateVoicePools() ) );
+	connect( Engine::audioEngine(), SIGNAL( sampleRateChanged() ),
+		this, SLOT( rebuildVoicePools() ) );
+	updateVoicePools();
+}
+
+
+
+
+MalletsInstrument::~MalletsInstrument()
+{
+	QMutexLocker lock( &MalletsSynth::stkMutex() );
+	m_ownedVoicePools.clear();
 }
 
 
@@ -330,12 +405,10 @@ void MalletsInstrument::playNote( NotePlayHandle * _n,
 			speed = std::clamp(speed, 0.0f, 128.0f);
 		}
 
-		// critical section as STK is not thread-safe
-		static QMutex m;
-		m.lock();
+		auto ps = acquireVoice( modelForPreset( p ) );
 		if( p < 9 )
 		{
-			_n->m_pluginData = new MalletsSynth( freq,
+			ps->startModalBar( freq,
 						vel,
 						m_stickModel.value(),
 						hardness,
@@ -343,25 +416,22 @@ void MalletsInstrument::playNote( NotePlayHandle * _n,
 						m_vibratoGainModel.value(),
 						m_vibratoFreqModel.value(),
 						p,
-						(uint8_t) m_spreadModel.value(),
-				Engine::audioEngine()->outputSampleRate() );
+						(uint8_t) m_spreadModel.value() );
 		}
 		else if( p == 9 )
 		{
-			_n->m_pluginData = new MalletsSynth( freq,
+			ps->startTubeBell( freq,
 						vel,
-						p,
 						m_lfoDepthModel.value(),
 						modulator,
 						crossfade,
 						m_lfoSpeedModel.value(),
 						m_adsrModel.value(),
-						(uint8_t) m_spreadModel.value(),
-				Engine::audioEngine()->outputSampleRate() );
+						(uint8_t) m_spreadModel.value() );
 		}
 		else
 		{
-			_n->m_pluginData = new MalletsSynth( freq,
+			ps->startBandedWG( freq,
 						vel,
 						pressure,
 						m_motionModel.value(),
@@ -369,11 +439,10 @@ void MalletsInstrument::playNote( NotePlayHandle * _n,
 						p - 10,
 						m_strikeModel.value() * 128.0,
 						speed,
-						(uint8_t) m_spreadModel.value(),
-				Engine::audioEngine()->outputSampleRate() );
+						(uint8_t) m_spreadModel.value() );
 		}
-		m.unlock();
-		static_cast<MalletsSynth *>(_n->m_pluginData)->setPresetIndex(p);
+		ps->setPresetIndex(p);
+		_n->m_pluginData = ps;
 	}
 
 	const f_cnt_t frames = _n->framesLeftForCurrentPeriod();
@@ -415,7 +484,138 @@ void MalletsInstrument::playNote( NotePlayHandle * _n,
 
 void MalletsInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<MalletsSynth *>( _n->m_pluginData );
+	auto ps = static_cast<MalletsSynth *>( _n->m_pluginData );
+	if( ps->isPooled() )
+	{
+		ps->release();
+		return;
+	}
+
+	QMutexLocker lock( &MalletsSynth::stkMutex() );
+	delete ps;
+}
+
+
+
+
+MalletsSynth::Model MalletsInstrument::modelForPreset( int _preset )
+{
+	if( _preset < 9 )
+	{
+		return MalletsSynth::Model::ModalBar;
+	}
+	return _preset == 9 ? MalletsSynth::Model::TubeBell
+				: MalletsSynth::Model::BandedWG;
+}
+
+
+
+
+MalletsInstrument::VoicePool * MalletsInstrument::createVoicePool(
+						MalletsSynth::Model _model )
+{
+	const auto sampleRate = Engine::audioEngine()->outputSampleRate();
+
+	auto pool = std::make_unique<VoicePool>();
+	pool->reserve( VoicePoolSize );
+
+	QMutexLocker lock( &MalletsSynth::stkMutex() );
+	for( std::size_t i = 0; i < VoicePoolSize; ++i )
+	{
+		auto voice = std::make_unique<MalletsSynth>( _model, sampleRate );
+		voice->setPooled();
+		pool->push_back( std::move( voice ) );
+	}
+
+	m_ownedVoicePools.push_back( std::move( pool ) );
+	return m_ownedVoicePools.back().get();
+}
+
+
+
+
+MalletsSynth * MalletsInstrument::acquireVoice( MalletsSynth::Model _model )
+{
+	const auto pool = m_voicePools[static_cast<std::size_t>( _model )]
+					.load( std::memory_order_acquire );
+	if( pool != nullptr )
+	{
+		for( const auto & voice : *pool )
+		{
+			if( voice->tryAcquire() )
+			{
+				return voice.get();
+			}
+		}
+	}
+
+	// More notes than pooled voices, or the preset just switched to a
+	// model whose pool isn't built yet: fall back to a voice of our own
+	QMutexLocker lock( &MalletsSynth::stkMutex() );
+	return new MalletsSynth( _model, Engine::audioEngine()->outputSampleRate() );
+}
+
+
+
+
+// Builds the pool for the model of the current preset, unless we have one already
+void MalletsInstrument::updateVoicePools()
+{
+	if( m_filesMissing )
+	{
+		return;
+	}
+
+	const auto model = modelForPreset( m_presetsModel.value() );
+	auto & slot = m_voicePools[static_cast<std::size_t>( model )];
+	if( slot.load( std::memory_order_relaxed ) == nullptr )
+	{
+		slot.store( createVoicePool( model ), std::memory_order_release );
+	}
+}
+
+
+
+
+// STK models compute most of their coefficients at construction, so pooled
+// voices have to be built again when the sample rate changes
+void MalletsInstrument::rebuildVoicePools()
+{
+	for( std::size_t i = 0; i < MalletsSynth::ModelCount; ++i )
+	{
+		auto & slot = m_voicePools[i];
+		if( slot.load( std::memory_order_relaxed ) != nullptr )
+		{
+			slot.store( createVoicePool( static_cast<MalletsSynth::Model>( i ) ),
+						std::memory_order_release );
+		}
+	}
+
+	releaseUnusedVoicePools();
+}
+
+
+
+
+// Frees the pools replaced before whose voices are all back. Pools with
+// voices still playing are kept until the next rebuild or destruction.
+void MalletsInstrument::releaseUnusedVoicePools()
+{
+	// No note can acquire or release a voice while the model is being
+	// changed, nor can an audio thread still be walking a replaced pool
+	Engine::audioEngine()->requestChangeInModel();
+	{
+		QMutexLocker lock( &MalletsSynth::stkMutex() );
+		std::erase_if( m_ownedVoicePools, [this]( const std::unique_ptr<VoicePool> & pool )
+		{
+			const auto current = std::any_of( m_voicePools.begin(), m_voicePools.end(),
+				[&]( const std::atomic<VoicePool *> & slot ) {
+					return slot.load( std::memory_order_relaxed ) == pool.get(); } );
+			return !current && std::none_of( pool->begin(), pool->end(),
+				[]( const std::unique_ptr<MalletsSynth> & voice ) { return voice->inUse(); } );
+		} );
+	}
+	Engine::audioEngine()->doneChangeInModel();
 }
 
 
@@ -637,18 +837,24 @@ void MalletsInstrumentView::changePreset()
 } // namespace gui
 
 
-// ModalBar
-MalletsSynth::MalletsSynth( const StkFloat _pitch,
-				const StkFloat _velocity,
-				const StkFloat _control1,
-				const StkFloat _control2,
-				const StkFloat _control4,
-				const StkFloat _control8,
-				const StkFloat _control11,
-				const int _control16,
-				const uint8_t _delay,
-				const sample_rate_t _sample_rate ) :
-	m_presetIndex(0)
+QMutex & MalletsSynth::stkMutex()
+{
+	static QMutex s_mutex;
+	return s_mutex;
+}
+
+
+
+
+MalletsSynth::MalletsSynth( const Model _model, const sample_rate_t _sample_rate ) :
+	m_model( _model ),
+	m_pooled( false ),
+	m_inUse( false ),
+	m_presetIndex( 0 ),
+	m_voice( nullptr ),
+	m_delay{},
+	m_delayRead( 0 ),
+	m_delayWrite( 0 )
 {
 	try
 	{
@@ -659,86 +865,112 @@ MalletsSynth::MalletsSynth( const StkFloat _pitch,
 		Stk::showWarnings( false );
 #endif
 
-		m_voice = new ModalBar();
-	
-		m_voice->controlChange( 16, _control16 );
-		m_voice->controlChange( 1, _control1 );
-		m_voice->controlChange( 2, _control2 );
-		m_voice->controlChange( 4, _control4 );
-		m_voice->controlChange( 8, _control8 );
-		m_voice->controlChange( 11, _control11 );
-		m_voice->controlChange( 128, 128.0f );
-		
-		m_voice->noteOn( _pitch, _velocity );
+		switch( _model )
+		{
+			case Model::ModalBar:
+				m_voice = new ResettableModalBar();
+				break;
+			case Model::TubeBell:
+				m_voice = new ResettableTubeBell();
+				break;
+			case Model::BandedWG:
+				m_voice = new ResettableBandedWG();
+				break;
+		}
 	}
 	catch( ... )
 	{
 		m_voice = nullptr;
 	}
-	
-	m_delay = new StkFloat[256];
+}
+
+
+
+
+void MalletsSynth::reset( const uint8_t _delay )
+{
+	if( m_voice != nullptr )
+	{
+		switch( m_model )
+		{
+			case Model::ModalBar:
+				static_cast<ResettableModalBar *>( m_voice )->reset();
+				break;
+			case Model::TubeBell:
+				static_cast<ResettableTubeBell *>( m_voice )->reset();
+				break;
+			case Model::BandedWG:
+				static_cast<ResettableBandedWG *>( m_voice )->reset();
+				break;
+		}
+	}
+
+	m_delay.fill( 0.0 );
 	m_delayRead = 0;
 	m_delayWrite = _delay;
-	for( int i = 0; i < 256; i++ )
+}
+
+
+
+
+void MalletsSynth::startModalBar( const StkFloat _pitch,
+				const StkFloat _velocity,
+				const StkFloat _control1,
+				const StkFloat _control2,
+				const StkFloat _control4,
+				const StkFloat _control8,
+				const StkFloat _control11,
+				const int _control16,
+				const uint8_t _delay )
+{
+	reset( _delay );
+	if( m_voice == nullptr )
 	{
-		m_delay[i] = 0.0;
+		return;
 	}
+
+	m_voice->controlChange( 16, _control16 );
+	m_voice->controlChange( 1, _control1 );
+	m_voice->controlChange( 2, _control2 );
+	m_voice->controlChange( 4, _control4 );
+	m_voice->controlChange( 8, _control8 );
+	m_voice->controlChange( 11, _control11 );
+	m_voice->controlChange( 128, 128.0f );
+
+	m_voice->noteOn( _pitch, _velocity );
 }
 
 
 
 
-// TubeBell
-MalletsSynth::MalletsSynth( const StkFloat _pitch,
+void MalletsSynth::startTubeBell( const StkFloat _pitch,
 				const StkFloat _velocity,
-				const int _preset,
 				const StkFloat _control1,
 				const StkFloat _control2,
 				const StkFloat _control4,
 				const StkFloat _control11,
 				const StkFloat _control128,
-				const uint8_t _delay,
-				const sample_rate_t _sample_rate ) :
-	m_presetIndex(0)
+				const uint8_t _delay )
 {
-	try
-	{
-		Stk::setSampleRate( _sample_rate );
-		Stk::setRawwavePath( QDir( ConfigManager::inst()->stkDir() ).absolutePath()
-						.toLocal8Bit().constData() );
-#ifndef LMMS_DEBUG
-		Stk::showWarnings( false );
-#endif
-
-		m_voice = new TubeBell();
-	
-		m_voice->controlChange( 1, _control1 );
-		m_voice->controlChange( 2, _control2 );
-		m_voice->controlChange( 4, _control4 );
-		m_voice->controlChange( 11, _control11 );
-		m_voice->controlChange( 128, _control128 );
-	
-		m_voice->noteOn( _pitch, _velocity );
-	}
-	catch( ... )
-	{
-		m_voice = nullptr;
-	}
-	
-	m_delay = new StkFloat[256];
-	m_delayRead = 0;
-	m_delayWrite = _delay;
-	for( int i = 0; i < 256; i++ )
+	reset( _delay );
+	if( m_voice == nullptr )
 	{
-		m_delay[i] = 0.0;
+		return;
 	}
+
+	m_voice->controlChange( 1, _control1 );
+	m_voice->controlChange( 2, _control2 );
+	m_voice->controlChange( 4, _control4 );
+	m_voice->controlChange( 11, _control11 );
+	m_voice->controlChange( 128, _control128 );
+
+	m_voice->noteOn( _pitch, _velocity );
 }
 
 
 
 
-// BandedWG
-MalletsSynth::MalletsSynth( const StkFloat _pitch,
+void MalletsSynth::startBandedWG( const StkFloat _pitch,
 				const StkFloat _velocity,
 				const StkFloat _control2,
 				const StkFloat _control4,
@@ -746,43 +978,23 @@ MalletsSynth::MalletsSynth( const StkFloat _pitch,
 				const int _control16,
 				const StkFloat _control64,
 				const StkFloat _control128,
-				const uint8_t _delay,
-				const sample_rate_t _sample_rate ) :
-	m_presetIndex(0)
+				const uint8_t _delay )
 {
-	try
-	{
-		Stk::setSampleRate( _sample_rate );
-		Stk::setRawwavePath( QDir( ConfigManager::inst()->stkDir() ).absolutePath()
-						.toLocal8Bit().constData() );
-#ifndef LMMS_DEBUG
-		Stk::showWarnings( false );
-#endif
-
-		m_voice = new BandedWG();
-	
-		m_voice->controlChange( 1, 128.0 );
-		m_voice->controlChange( 2, _control2 );
-		m_voice->controlChange( 4, _control4 );
-		m_voice->controlChange( 11, _control11 );
-		m_voice->controlChange( 16, _control16 );
-		m_voice->controlChange( 64, _control64 );
-		m_voice->controlChange( 128, _control128 );
-	
-		m_voice->noteOn( _pitch, _velocity );
-	}
-	catch( ... )
-	{
-		m_voice = nullptr;
-	}
-	
-	m_delay = new StkFloat[256];
-	m_delayRead = 0;
-	m_delayWrite = _delay;
-	for( int i = 0; i < 256; i++ )
+	reset( _delay );
+	if( m_voice == nullptr )
 	{
-		m_delay[i] = 0.0;
+		return;
 	}
+
+	m_voice->controlChange( 1, 128.0 );
+	m_voice->controlChange( 2, _control2 );
+	m_voice->controlChange( 4, _control4 );
+	m_voice->controlChange( 11, _control11 );
+	m_voice->controlChange( 16, _control16 );
+	m_voice->controlChange( 64, _control64 );
+	m_voice->controlChange( 128, _control128 );
+
+	m_voice->noteOn( _pitch, _velocity );
 }
 
 
@@ -27,6 +27,13 @@
 #ifndef _MALLET_H
 #define _MALLET_H
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QMutex>
+
 #include <stk/Instrmnt.h>
 
 #include "ComboBox.h"
@@ -59,8 +66,29 @@ class MalletsInstrumentView;
 class MalletsSynth
 {
 public:
+	enum class Model
+	{
+		ModalBar,
+		TubeBell,
+		BandedWG
+	};
+
+	static constexpr std::size_t ModelCount = 3;
+
+	//! Builds the STK voice. STK keeps global state (sample rate, rawwave
+	//! path, sample rate alert list), so constructing and destroying
+	//! voices must only happen with stkMutex() held.
+	MalletsSynth( const Model _model, const sample_rate_t _sample_rate );
+
+	inline ~MalletsSynth()
+	{
+		delete m_voice;
+	}
+
+	static QMutex & stkMutex();
+
 	// ModalBar
-	MalletsSynth( const StkFloat _pitch,
+	void startModalBar( const StkFloat _pitch,
 			const StkFloat _velocity,
 			const StkFloat _control1,
 			const StkFloat _control2,
@@ -68,23 +96,20 @@ public:
 			const StkFloat _control8,
 			const StkFloat _control11,
 			const int _control16,
-			const uint8_t _delay,
-			const sample_rate_t _sample_rate );
+			const uint8_t _delay );
 
 	// TubeBell
-	MalletsSynth( const StkFloat _pitch,
+	void startTubeBell( const StkFloat _pitch,
 			const StkFloat _velocity,
-			const int _preset,
 			const StkFloat _control1,
 			const StkFloat _control2,
 			const StkFloat _control4,
 			const StkFloat _control11,
 			const StkFloat _control128,
-			const uint8_t _delay,
-			const sample_rate_t _sample_rate );
+			const uint8_t _delay );
 
 	// BandedWG
-	MalletsSynth( const StkFloat _pitch,
+	void startBandedWG( const StkFloat _pitch,
 			const StkFloat _velocity,
 			const StkFloat _control2,
 			const StkFloat _control4,
@@ -92,14 +117,40 @@ public:
 			const int _control16,
 			const StkFloat _control64,
 			const StkFloat _control128,
-			const uint8_t _delay,
-			const sample_rate_t _sample_rate );
+			const uint8_t _delay );
 
-	inline ~MalletsSynth()
+	inline Model model() const
 	{
-		if (m_voice) {m_voice->noteOff(0.0);}
-		delete[] m_delay;
-		delete m_voice;
+		return m_model;
+	}
+
+	//! Pooled voices are handed out by tryAcquire() and given back with
+	//! release(); all others belong to a single note
+	inline bool isPooled() const
+	{
+		return m_pooled;
+	}
+
+	inline void setPooled()
+	{
+		m_pooled = true;
+	}
+
+	inline bool tryAcquire()
+	{
+		bool expected = false;
+		return m_inUse.compare_exchange_strong( expected, true,
+						std::memory_order_acquire );
+	}
+
+	inline void release()
+	{
+		m_inUse.store( false, std::memory_order_release );
+	}
+
+	inline bool inUse() const
+	{
+		return m_inUse.load( std::memory_order_acquire );
 	}
 
 	inline sample_t nextSampleLeft()
@@ -170,10 +221,16 @@ public:
 
 
 protected:
+	//! Brings the voice back to the state of a freshly constructed one
+	void reset( const uint8_t _delay );
+
+	const Model m_model;
+	bool m_pooled;
+	std::atomic<bool> m_inUse;
 	int m_presetIndex;
 	Instrmnt * m_voice;
 
-	StkFloat * m_delay;
+	std::array<StkFloat, 256> m_delay;
 	uint8_t m_delayRead;
 	uint8_t m_delayWrite;
 };
@@ -186,7 +243,7 @@ class MalletsInstrument : public Instrument
 	Q_OBJECT
 public:
 	MalletsInstrument( InstrumentTrack * _instrument_track );
-	~MalletsInstrument() override = default;
+	~MalletsInstrument() override;
 
 	void playNote( NotePlayHandle * _n,
 						SampleFrame* _working_buffer ) override;
@@ -201,7 +258,22 @@ public:
 	gui::PluginView* instantiateView( QWidget * _parent ) override;
 
 
+private slots:
+	void updateVoicePools();
+	void rebuildVoicePools();
+
+
 private:
+	//! Voices built ahead of time, so starting a note neither allocates
+	//! nor reads rawwave files on the audio thread
+	using VoicePool = std::vector<std::unique_ptr<MalletsSynth>>;
+	static constexpr std::size_t VoicePoolSize = 16;
+
+	static MalletsSynth::Model modelForPreset( int _preset );
+	VoicePool * createVoicePool( MalletsSynth::Model _model );
+	void releaseUnusedVoicePools();
+	MalletsSynth * acquireVoice( MalletsSynth::Model _model );
+
 	FloatModel m_hardnessModel;
 	FloatModel m_positionModel;
 	FloatModel m_vibratoGainModel;
@@ -231,6 +303,12 @@ private:
 
 	bool m_filesMissing;
 
+	// Read by the audio threads; only replaced from the GUI thread
+	std::array<std::atomic<VoicePool *>, MalletsSynth::ModelCount> m_voicePools;
+	// Pools replaced after a sample rate change stay alive while notes
+	// still use their voices, see releaseUnusedVoicePools()
+	std::vector<std::unique_ptr<VoicePool>> m_ownedVoicePools;
+
 
 	friend class gui::MalletsInstrumentView;
 
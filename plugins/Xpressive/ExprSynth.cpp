@@ -25,15 +25,19 @@
 
 #include "ExprSynth.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <cmath>
 #include <random>
 #include <numbers>
 
+#include "Engine.h"
+#include "InstrumentTrack.h"
 #include "lmms_math.h"
 #include "NotePlayHandle.h"
 #include "SampleFrame.h"
+#include "Song.h"
 
 
 #include <exprtk.hpp>
@@ -75,69 +79,29 @@ struct IntegrateFunction : public exprtk::ifunction<T>
 {
 
 	using exprtk::ifunction<T>::operator();
-	~IntegrateFunction() override
-	{
-		delete [] m_counters;
-	}
 
-	IntegrateFunction(const unsigned int* frame, unsigned int sample_rate,unsigned int max_counters) :
+	IntegrateFunction(unsigned int sample_rate) :
 	exprtk::ifunction<T>(1),
-	m_firstValue(0),
-	m_frame(frame),
 	m_sampleRate(sample_rate),
-	m_maxCounters(max_counters),
-	m_nCounters(0),
-	m_nCountersCalls(0),
-	m_cc(0)
+	m_state(nullptr)
 	{
-		m_counters=new double[max_counters];
-		clearArray(m_counters,max_counters);
 	}
 
 	inline T operator()(const T& x) override
 	{
-		if (m_frame)
-		{
-			if (m_nCountersCalls == 0)
-			{
-				m_firstValue = *m_frame;
-			}
-			if (m_firstValue == *m_frame)
-			{
-				++m_nCountersCalls;
-				if (m_nCountersCalls > m_maxCounters)
-				{
-					return 0;
-				}
-				m_cc = m_nCounters;
-				++m_nCounters;
-			}
-			else // we moved to the next frame
-			{
-				m_frame = 0; // this will indicate that we are no longer in init phase.
-			}
-		}
-
-		T res = 0;
-		if (m_cc < m_nCounters)
+		// every call site gets its own counter, numbered in evaluation order;
+		// ExprFront::evaluate() restarts the numbering for each sample
+		if (m_state->integratorCall >= m_state->integrators.size())
 		{
-			res = m_counters[m_cc];
-			m_counters[m_cc] += x;
+			return 0;
 		}
-		m_cc = (m_cc + 1) % m_nCountersCalls;
+		double& counter = m_state->integrators[m_state->integratorCall++];
+		const T res = counter;
+		counter += x;
 		return res / m_sampleRate;
 	}
-	unsigned int m_firstValue;
-	const unsigned int* m_frame;
 	const unsigned int m_sampleRate;
-	// number of counters allocated
-	const unsigned int m_maxCounters;
-	// number of integrate instances that has counters allocated
-	unsigned int m_nCounters;
-	// real number of integrate instances
-	unsigned int m_nCountersCalls;
-	unsigned int m_cc;
-	double *m_counters;
+	ExprState* m_state;
 };
 
 template <typename T>
@@ -145,44 +109,38 @@ struct LastSampleFunction : public exprtk::ifunction<T>
 {
 
 	using exprtk::ifunction<T>::operator();
-	~LastSampleFunction() override
-	{
-		delete [] m_samples;
-	}
 
-	LastSampleFunction(unsigned int history_size) :
+	LastSampleFunction() :
 	exprtk::ifunction<T>(1),
-	m_history_size(history_size),
-	m_pivot_last(history_size - 1)
+	m_state(nullptr)
 	{
-		m_samples = new T[history_size];
-		clearArray(m_samples, history_size);
 	}
 
 	inline T operator()(const T& x) override
 	{
-		if (!std::isnan(x) && x >= 1 && x <= m_history_size) {
-			return m_samples[(static_cast<std::size_t>(x) + m_pivot_last) % m_history_size];
+		const std::size_t size = m_state->history.size();
+		if (!std::isnan(x) && x >= 1 && x <= size) {
+			return m_state->history[(static_cast<std::size_t>(x) + m_state->historyPivot) % size];
 		}
 		return 0;
 	}
 	void setLastSample(const T& sample)
 	{
+		const auto size = static_cast<unsigned int>(m_state->history.size());
+		if (size == 0) { return; }
 		if (!std::isnan(sample) && !std::isinf(sample))
 		{
-			m_samples[m_pivot_last] = sample;
+			m_state->history[m_state->historyPivot] = sample;
 		}
-		if (m_pivot_last == 0)
+		if (m_state->historyPivot == 0)
 		{
-			m_pivot_last = m_history_size - 1;
+			m_state->historyPivot = size - 1;
 		}
 		else {
-			--m_pivot_last;
+			--m_state->historyPivot;
 		}
 	}
-	unsigned int m_history_size;
-	unsigned int m_pivot_last;
-	T *m_samples;
+	ExprState* m_state;
 };
 
 template <typename T>
@@ -344,17 +302,19 @@ struct RandomVectorFunction : public exprtk::ifunction<float>
 {
 	using exprtk::ifunction<float>::operator();
 
-	RandomVectorFunction(const unsigned int seed) :
+	// the seed belongs to the bound voice, so calls must not be folded at
+	// compile time
+	RandomVectorFunction() :
 	exprtk::ifunction<float>(1),
-	m_rseed(seed)
-	{ exprtk::disable_has_side_effects(*this); }
+	m_state(nullptr)
+	{}
 
 	inline float operator()(const float& index) override
 	{
-		return RandomVectorSeedFunction::randv(index,m_rseed);
+		return RandomVectorSeedFunction::randv(index, m_state->randSeed);
 	}
 
-	const unsigned int m_rseed;
+	ExprState* m_state;
 };
 
 namespace SimpleRandom {
@@ -374,10 +334,10 @@ static freefunc0<float,SimpleRandom::float_random_with_engine,false> simple_rand
 class ExprFrontData
 {
 public:
-	ExprFrontData(int last_func_samples):
-	m_rand_vec(SimpleRandom::generator()),
+	ExprFrontData():
 	m_integ_func(nullptr),
-	m_last_func(last_func_samples)
+	m_state(nullptr),
+	m_seed(0)
 	{}
 	~ExprFrontData()
 	{
@@ -403,6 +363,9 @@ public:
 	RandomVectorFunction m_rand_vec;
 	IntegrateFunction<float> *m_integ_func;
 	LastSampleFunction<float> m_last_func;
+	ExprState m_own_state;
+	ExprState* m_state;
+	float m_seed;
 
 };
 
@@ -529,14 +492,16 @@ ExprFront::ExprFront(const char * expr, int last_func_samples)
 	m_valid = false;
 	try
 	{
-		m_data = new ExprFrontData(last_func_samples);
+		m_data = new ExprFrontData;
 
 		m_data->m_expression_string = expr;
+		m_data->m_own_state = createState(last_func_samples);
+		bind(m_data->m_own_state);
 		m_data->m_symbol_table.add_pi();
 
 		m_data->m_symbol_table.add_constant("e", std::numbers::e_v<float>);
 
-		m_data->m_symbol_table.add_constant("seed", SimpleRandom::generator() & max_float_integer_mask);
+		m_data->m_symbol_table.add_variable("seed", m_data->m_seed);
 
 		m_data->m_symbol_table.add_function("sinew", sin_wave_func);
 		m_data->m_symbol_table.add_function("squarew", square_wave_func);
@@ -595,6 +560,7 @@ float ExprFront::evaluate()
 	try
 	{
 		if (!m_valid) return 0;
+		m_data->m_state->integratorCall = 0;
 		float res = m_data->m_expression.value();
 		m_data->m_last_func.setLastSample(res);
 		return res;
@@ -674,14 +640,15 @@ size_t find_occurances(const std::string& haystack, const char* const needle)
 	return count;
 }
 
-void ExprFront::setIntegrate(const unsigned int* const frameCounter, const unsigned int sample_rate)
+void ExprFront::setIntegrate(const unsigned int sample_rate)
 {
 	if (m_data->m_integ_func == nullptr)
 	{
 		const unsigned int ointeg = find_occurances(m_data->m_expression_string,"integrate");
 		if ( ointeg > 0 )
 		{
-			m_data->m_integ_func = new IntegrateFunction<float>(frameCounter,sample_rate,ointeg);
+			m_data->m_integ_func = new IntegrateFunction<float>(sample_rate);
+			m_data->m_integ_func->m_state = m_data->m_state;
 			try
 			{
 				m_data->m_symbol_table.add_function("integrate",*m_data->m_integ_func);
@@ -694,140 +661,218 @@ void ExprFront::setIntegrate(const unsigned int* const frameCounter, const unsig
 	}
 }
 
-ExprSynth::ExprSynth(const WaveSample *gW1, const WaveSample *gW2, const WaveSample *gW3,
-	ExprFront *exprO1, ExprFront *exprO2,
-	NotePlayHandle *nph, const sample_rate_t sample_rate,
-	const FloatModel* pan1, const FloatModel* pan2, float rel_trans):
-	m_exprO1(exprO1),
-	m_exprO2(exprO2),
-	m_W1(gW1),
-	m_W2(gW2),
-	m_W3(gW3),
-	m_nph(nph),
-	m_sample_rate(sample_rate),
-	m_pan1(pan1),
-	m_pan2(pan2),
-	m_rel_transition(rel_trans)
+ExprState ExprFront::createState(const unsigned int last_func_samples) const
 {
-	m_note_sample = 0;
-	m_note_rel_sample = 0;
-	m_note_rel_sec = 0;
-	m_note_sample_sec = 0;
-	m_released = 0;
-	m_frequency = m_nph->frequency();
-	m_rel_inc = 1000.0 / (m_sample_rate * m_rel_transition);//rel_transition in ms. compute how much increment in each frame
+	ExprState state;
+	// only keep a history when the expression can look at it
+	if (find_occurances(m_data->m_expression_string, "last") > 0)
+	{
+		state.history.resize(last_func_samples, 0.f);
+		state.historyPivot = last_func_samples - 1;
+	}
+	state.integrators.resize(find_occurances(m_data->m_expression_string, "integrate"), 0.);
+	state.randSeed = SimpleRandom::generator();
+	state.seed = SimpleRandom::generator() & max_float_integer_mask;
+	return state;
+}
 
-	auto init_expression_step2 = [this](ExprFront * e) {
-		e->add_cyclic_vector("W1", m_W1->m_samples,m_W1->m_length, m_W1->m_interpolate);
-		e->add_cyclic_vector("W2", m_W2->m_samples,m_W2->m_length, m_W2->m_interpolate);
-		e->add_cyclic_vector("W3", m_W3->m_samples,m_W3->m_length, m_W3->m_interpolate);
-		e->add_variable("t", m_note_sample_sec);
-		e->add_variable("f", m_frequency);
-		e->add_variable("rel",m_released);
-		e->add_variable("trel",m_note_rel_sec);
-		e->setIntegrate(&m_note_sample,m_sample_rate);
+void ExprFront::bind(ExprState& state)
+{
+	m_data->m_state = &state;
+	m_data->m_seed = state.seed;
+	m_data->m_last_func.m_state = &state;
+	m_data->m_rand_vec.m_state = &state;
+	if (m_data->m_integ_func)
+	{
+		m_data->m_integ_func->m_state = &state;
+	}
+}
+
+
+
+
+ExprProgram::ExprProgram(const ExprProgramSource& source, unsigned int generation) :
+	m_o1(source.expressions[0].c_str(), source.sampleRate),
+	m_o2(source.expressions[1].c_str(), source.sampleRate),
+	m_generation(generation)
+{
+	for (auto e : {&m_o1, &m_o2})
+	{
+		e->add_variable("key", m_variables.key);
+		e->add_variable("bnote", m_variables.bnote);
+		e->add_constant("srate", source.sampleRate);
+		e->add_variable("v", m_variables.v);
+		e->add_variable("tempo", m_variables.tempo);
+		e->add_variable("A1", *source.parameters[0]);
+		e->add_variable("A2", *source.parameters[1]);
+		e->add_variable("A3", *source.parameters[2]);
+		e->add_cyclic_vector("W1", source.waves[0]->m_samples, source.waves[0]->m_length, source.waves[0]->m_interpolate);
+		e->add_cyclic_vector("W2", source.waves[1]->m_samples, source.waves[1]->m_length, source.waves[1]->m_interpolate);
+		e->add_cyclic_vector("W3", source.waves[2]->m_samples, source.waves[2]->m_length, source.waves[2]->m_interpolate);
+		e->add_variable("t", m_variables.t);
+		e->add_variable("f", m_variables.f);
+		e->add_variable("rel", m_variables.rel);
+		e->add_variable("trel", m_variables.trel);
+		e->setIntegrate(source.sampleRate);
 		e->compile();
-	};
-	init_expression_step2(m_exprO1);
-	init_expression_step2(m_exprO2);
+	}
+}
+
+
 
+
+void ExprProgramPool::setSource(ExprProgramSource source)
+{
+	auto stale = std::vector<std::unique_ptr<ExprProgram>>{};
+	unsigned int generation;
+	std::size_t count;
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		m_source = source;
+		generation = ++m_generation;
+		stale.swap(m_free);
+		count = m_highWater;
+	}
+
+	// compile outside the lock so voices can keep rendering meanwhile
+	auto fresh = std::vector<std::unique_ptr<ExprProgram>>{};
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		fresh.push_back(std::make_unique<ExprProgram>(source, generation));
+	}
+
+	const auto lock = std::lock_guard{m_mutex};
+	if (generation != m_generation) { return; }
+	for (auto& program : fresh)
+	{
+		m_free.push_back(std::move(program));
+	}
 }
 
-ExprSynth::~ExprSynth()
+
+
+
+std::unique_ptr<ExprProgram> ExprProgramPool::acquire()
 {
-	if (m_exprO1)
+	auto source = ExprProgramSource{};
+	unsigned int generation;
 	{
-		delete m_exprO1;
+		const auto lock = std::lock_guard{m_mutex};
+		m_highWater = std::max(m_highWater, ++m_inUse);
+		if (!m_free.empty())
+		{
+			auto program = std::move(m_free.back());
+			m_free.pop_back();
+			return program;
+		}
+		source = m_source;
+		generation = m_generation;
 	}
-	if (m_exprO2)
+	// more voices render at once than ever before
+	return std::make_unique<ExprProgram>(source, generation);
+}
+
+
+
+
+void ExprProgramPool::release(std::unique_ptr<ExprProgram> program)
+{
+	const auto lock = std::lock_guard{m_mutex};
+	--m_inUse;
+	if (program->generation() == m_generation)
 	{
-		delete m_exprO2;
+		m_free.push_back(std::move(program));
+		return;
 	}
+	// outdated program: destroyed when we return
+}
+
+ExprSynth::ExprSynth(ExprProgramPool* programs, NotePlayHandle *nph, const sample_rate_t sample_rate,
+	const FloatModel* pan1, const FloatModel* pan2, float rel_trans):
+	m_programs(programs),
+	m_nph(nph),
+	m_sample_rate(sample_rate),
+	m_pan1(pan1),
+	m_pan2(pan2),
+	m_rel_transition(rel_trans)
+{
+	m_note_sample = 0;
+	m_note_rel_sample = 0;
+	m_variables.f = m_nph->frequency();
+	m_variables.key = nph->key();
+	m_variables.bnote = nph->instrumentTrack()->baseNote();
+	m_variables.v = nph->getVolume() / 255.0;
+	m_variables.tempo = Engine::getSong()->getTempo();
+	m_rel_inc = 1000.0 / (m_sample_rate * m_rel_transition);//rel_transition in ms. compute how much increment in each frame
+
+	auto program = m_programs->acquire();
+	m_stateO1 = program->output(0).createState(m_sample_rate); // give the "last" function a whole second
+	m_stateO2 = program->output(1).createState(m_sample_rate);
+	m_programs->release(std::move(program));
 }
 
 void ExprSynth::renderOutput(f_cnt_t frames, SampleFrame* buf)
 {
+	// borrow a compiled program for this block and point it at our voice
+	auto program = m_programs->acquire();
+	ExprFront* exprO1 = &program->output(0);
+	ExprFront* exprO2 = &program->output(1);
+	ExprVariables& vars = program->variables();
+	vars = m_variables;
+	exprO1->bind(m_stateO1);
+	exprO2->bind(m_stateO2);
+
 	try
 	{
-		bool o1_valid = m_exprO1->isValid();
-		bool o2_valid = m_exprO2->isValid();
-		if (!o1_valid && !o2_valid)
+		bool o1_valid = exprO1->isValid();
+		bool o2_valid = exprO2->isValid();
+		if (o1_valid || o2_valid)
 		{
-			return;
-		}
-		float o1 = 0, o2 = 0;
-		float pn1 = m_pan1->value() * 0.5;
-		float pn2 = m_pan2->value() * 0.5;
-		const float new_freq = m_nph->frequency();
-		const float freq_inc = (new_freq - m_frequency) / frames;
-		const bool is_released = m_nph->isReleased();
-
-		expression_t *o1_rawExpr = &(m_exprO1->getData()->m_expression);
-		expression_t *o2_rawExpr = &(m_exprO2->getData()->m_expression);
-		LastSampleFunction<float> * last_func1 = &m_exprO1->getData()->m_last_func;
-		LastSampleFunction<float> * last_func2 = &m_exprO2->getData()->m_last_func;
-		if (is_released && m_note_rel_sample == 0)
-		{
-			m_note_rel_sample = m_note_sample;
-		}
-		if (o1_valid && o2_valid)
-		{
-			for (f_cnt_t frame = 0; frame < frames ; ++frame)
+			float o1 = 0, o2 = 0;
+			float pn1 = m_pan1->value() * 0.5;
+			float pn2 = m_pan2->value() * 0.5;
+			const float new_freq = m_nph->frequency();
+			const float freq_inc = (new_freq - vars.f) / frames;
+			const bool is_released = m_nph->isReleased();
+
+			if (is_released && m_note_rel_sample == 0)
 			{
-				if (is_released && m_released < 1)
-				{
-					m_released = fmin(m_released+m_rel_inc, 1);
-				}
-				o1 = o1_rawExpr->value();
-				o2 = o2_rawExpr->value();
-				last_func1->setLastSample(o1);//put result in the circular buffer for the "last" function.
-				last_func2->setLastSample(o2);
-				buf[frame][0] = (-pn1 + 0.5) * o1 + (-pn2 + 0.5) * o2;
-				buf[frame][1] = ( pn1 + 0.5) * o1 + ( pn2 + 0.5) * o2;
-				m_note_sample++;
-				m_note_sample_sec = m_note_sample / (float)m_sample_rate;
-				if (is_released)
-				{
-					m_note_rel_sec = (m_note_sample - m_note_rel_sample) / (float)m_sample_rate;
-				}
-				m_frequency += freq_inc;
+				m_note_rel_sample = m_note_sample;
 			}
-		}
-		else
-		{
-
-			if (o2_valid)
+			if (!o1_valid)
 			{
-				o1_rawExpr = o2_rawExpr;
-				last_func1 = last_func2;
+				exprO1 = exprO2;
 				pn1 = pn2;
 			}
+			const bool both = o1_valid && o2_valid;
 			for (f_cnt_t frame = 0; frame < frames ; ++frame)
 			{
-				if (is_released && m_released < 1)
+				if (is_released && vars.rel < 1)
 				{
-					m_released = fmin(m_released+m_rel_inc, 1);
+					vars.rel = fmin(vars.rel + m_rel_inc, 1);
 				}
-				o1 = o1_rawExpr->value();
-				last_func1->setLastSample(o1);
-				buf[frame][0] = (-pn1 + 0.5) * o1;
-				buf[frame][1] = ( pn1 + 0.5) * o1;
+				o1 = exprO1->evaluate();
+				o2 = both ? exprO2->evaluate() : 0;
+				buf[frame][0] = (-pn1 + 0.5) * o1 + (-pn2 + 0.5) * o2;
+				buf[frame][1] = ( pn1 + 0.5) * o1 + ( pn2 + 0.5) * o2;
 				m_note_sample++;
-				m_note_sample_sec = m_note_sample / (float)m_sample_rate;
+				vars.t = m_note_sample / (float)m_sample_rate;
 				if (is_released)
 				{
-					m_note_rel_sec = (m_note_sample - m_note_rel_sample) / (float)m_sample_rate;
+					vars.trel = (m_note_sample - m_note_rel_sample) / (float)m_sample_rate;
 				}
-				m_frequency += freq_inc;
+				vars.f += freq_inc;
 			}
+			vars.f = new_freq;
 		}
-		m_frequency = new_freq;
 	}
 	catch(...)
 	{
 		WARN_EXPRTK;
 	}
-}
 
+	m_variables = vars;
+	m_programs->release(std::move(program));
+}
 
 } // namespace lmms
@@ -28,6 +28,10 @@
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "Graph.h"
 
 namespace lmms
@@ -38,8 +42,23 @@ class ExprFrontData;
 class FloatModel;
 class NotePlayHandle;
 class SampleFrame;
+class WaveSample;
 
 
+//! What the stateful functions of one expression (last, integrate, randv)
+//! remember from sample to sample. A compiled ExprFront can be shared by
+//! several voices, so each voice keeps its own state and binds it before
+//! evaluating.
+struct ExprState
+{
+	std::vector<float> history;
+	unsigned int historyPivot = 0;
+	std::vector<double> integrators;
+	unsigned int integratorCall = 0;
+	unsigned int randSeed = 0;
+	float seed = 0;
+};
+
 class ExprFront
 {
 public:
@@ -47,12 +66,16 @@ public:
 	ExprFront(const char* expr, int last_func_samples);
 	~ExprFront();
 	bool compile();
-	inline bool isValid() { return m_valid; }
+	inline bool isValid() const { return m_valid; }
 	float evaluate();
 	bool add_variable(const char* name, float & ref);
 	bool add_constant(const char* name, float  ref);
 	bool add_cyclic_vector(const char* name, const float* data, size_t length, bool interp = false);
-	void setIntegrate(const unsigned int* frameCounter, unsigned int sample_rate);
+	void setIntegrate(unsigned int sample_rate);
+	//! Fresh state sized for this expression, with new random seeds
+	ExprState createState(unsigned int last_func_samples) const;
+	//! Makes the stateful functions use @p state until the next bind()
+	void bind(ExprState& state);
 	ExprFrontData* getData() { return m_data; }
 private:
 	ExprFrontData *m_data;
@@ -62,6 +85,69 @@ private:
 
 };
 
+//! Per-voice inputs of the output expressions. The expressions of an
+//! ExprProgram are compiled against one instance of this, which the voice
+//! being rendered fills in.
+struct ExprVariables
+{
+	float t = 0;
+	float f = 0;
+	float rel = 0;
+	float trel = 0;
+	float key = 0;
+	float bnote = 0;
+	float v = 0;
+	float tempo = 0;
+};
+
+//! Everything needed to compile the output expressions of an instrument
+struct ExprProgramSource
+{
+	std::string expressions[2];
+	const WaveSample* waves[3] = {};
+	float* parameters[3] = {}; // A1, A2, A3
+	sample_rate_t sampleRate = 0;
+};
+
+//! Both output expressions of an instrument, compiled once
+class ExprProgram
+{
+public:
+	ExprProgram(const ExprProgramSource& source, unsigned int generation);
+
+	ExprVariables& variables() { return m_variables; }
+	ExprFront& output(int i) { return i == 0 ? m_o1 : m_o2; }
+	unsigned int generation() const { return m_generation; }
+
+private:
+	ExprVariables m_variables;
+	ExprFront m_o1;
+	ExprFront m_o2;
+	const unsigned int m_generation;
+};
+
+//! Compiled programs of one instrument, handed to voices while they render.
+//! Voices on different worker threads render at the same time, so there is
+//! one program per concurrently rendering voice. Programs are compiled when
+//! the source changes, as many as were needed at the same time before;
+//! only a rise in concurrency compiles on the audio thread.
+class ExprProgramPool
+{
+public:
+	void setSource(ExprProgramSource source);
+
+	std::unique_ptr<ExprProgram> acquire();
+	void release(std::unique_ptr<ExprProgram> program);
+
+private:
+	std::mutex m_mutex;
+	ExprProgramSource m_source;
+	unsigned int m_generation = 0;
+	std::vector<std::unique_ptr<ExprProgram>> m_free;
+	std::size_t m_inUse = 0;
+	std::size_t m_highWater = 1;
+};
+
 class WaveSample
 {
 public:
@@ -95,22 +181,19 @@ public:
 class ExprSynth
 {
 public:
-	ExprSynth(const WaveSample* gW1, const WaveSample* gW2, const WaveSample* gW3, ExprFront* exprO1, ExprFront* exprO2, NotePlayHandle* nph,
+	ExprSynth(ExprProgramPool* programs, NotePlayHandle* nph,
 			const sample_rate_t sample_rate, const FloatModel* pan1, const FloatModel* pan2, float rel_trans);
-	virtual ~ExprSynth();
+	virtual ~ExprSynth() = default;
 
 	void renderOutput(f_cnt_t frames, SampleFrame* buf );
 
 
 private:
-	ExprFront *m_exprO1, *m_exprO2;
-	const WaveSample *m_W1, *m_W2, *m_W3;
+	ExprProgramPool* m_programs;
+	ExprState m_stateO1, m_stateO2;
+	ExprVariables m_variables;
 	unsigned int m_note_sample;
 	unsigned int m_note_rel_sample;
-	float m_note_sample_sec;
-	float m_note_rel_sec;
-	float m_frequency;
-	float m_released;
 	NotePlayHandle* m_nph;
 	const sample_rate_t m_sample_rate;
 	const FloatModel *m_pan1,*m_pan2;
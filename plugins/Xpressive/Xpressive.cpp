@@ -107,6 +107,32 @@ Xpressive::Xpressive(InstrumentTrack* instrument_track) :
 {
 	m_outputExpression[0]="sinew(integrate(f*(1+0.05sinew(12t))))*(2^(-(1.1+A2)*t)*(0.4+0.1(1+A3)+0.4sinew((2.5+2A1)t))^2)";
 	m_outputExpression[1]="expw(integrate(f*atan(500t)*2/pi))*0.5+0.12";
+
+	connect(&m_interpolateW1, SIGNAL(dataChanged()), this, SLOT(updatePrograms()));
+	connect(&m_interpolateW2, SIGNAL(dataChanged()), this, SLOT(updatePrograms()));
+	connect(&m_interpolateW3, SIGNAL(dataChanged()), this, SLOT(updatePrograms()));
+	connect(Engine::audioEngine(), SIGNAL(sampleRateChanged()), this, SLOT(updatePrograms()));
+	updatePrograms();
+}
+
+void Xpressive::updatePrograms()
+{
+	// the wave functions pick their lookup at compile time
+	m_W1.setInterpolate(m_interpolateW1.value());
+	m_W2.setInterpolate(m_interpolateW2.value());
+	m_W3.setInterpolate(m_interpolateW3.value());
+
+	auto source = ExprProgramSource{};
+	source.expressions[0] = m_outputExpression[0].toStdString();
+	source.expressions[1] = m_outputExpression[1].toStdString();
+	source.waves[0] = &m_W1;
+	source.waves[1] = &m_W2;
+	source.waves[2] = &m_W3;
+	source.parameters[0] = &m_A1;
+	source.parameters[1] = &m_A2;
+	source.parameters[2] = &m_A3;
+	source.sampleRate = Engine::audioEngine()->outputSampleRate();
+	m_programs.setSource(std::move(source));
 }
 
 void Xpressive::saveSettings(QDomDocument & _doc, QDomElement & _this) {
@@ -187,6 +213,7 @@ void Xpressive::loadSettings(const QDomElement & _this) {
 	m_W1.copyFrom(&m_graphW1);
 	m_W2.copyFrom(&m_graphW2);
 	m_W3.copyFrom(&m_graphW3);
+	updatePrograms();
 }
 
 
@@ -200,29 +227,7 @@ void Xpressive::playNote(NotePlayHandle* nph, SampleFrame* working_buffer) {
 	m_A3=m_parameterA3.value();
 
 	if (!nph->m_pluginData) {
-
-		auto exprO1 = new ExprFront(m_outputExpression[0].constData(),
-			Engine::audioEngine()->outputSampleRate()); // give the "last" function a whole second
-		auto exprO2 = new ExprFront(m_outputExpression[1].constData(), Engine::audioEngine()->outputSampleRate());
-
-		auto init_expression_step1 = [this, nph](ExprFront* e) { //lambda function to init exprO1 and exprO2
-			//add the constants and the variables to the expression.
-			e->add_constant("key", nph->key());//the key that was pressed.
-			e->add_constant("bnote", nph->instrumentTrack()->baseNote()); // the base note
-			e->add_constant("srate", Engine::audioEngine()->outputSampleRate());// sample rate of the audio engine
-			e->add_constant("v", nph->getVolume() / 255.0); //volume of the note.
-			e->add_constant("tempo", Engine::getSong()->getTempo());//tempo of the song.
-			e->add_variable("A1", m_A1);//A1,A2,A3: general purpose input controls.
-			e->add_variable("A2", m_A2);
-			e->add_variable("A3", m_A3);
-		};
-		init_expression_step1(exprO1);
-		init_expression_step1(exprO2);
-
-		m_W1.setInterpolate(m_interpolateW1.value());//set interpolation according to the user selection.
-		m_W2.setInterpolate(m_interpolateW2.value());
-		m_W3.setInterpolate(m_interpolateW3.value());
-		nph->m_pluginData = new ExprSynth(&m_W1, &m_W2, &m_W3, exprO1, exprO2, nph,
+		nph->m_pluginData = new ExprSynth(&m_programs, nph,
 				Engine::audioEngine()->outputSampleRate(), &m_panning1, &m_panning2, m_relTransition.value());
 	}
 
@@ -538,9 +543,11 @@ void XpressiveView::expressionChanged() {
 			break;
 		case O1_EXPR:
 			e->outputExpression(0) = text;
+			e->updatePrograms();
 			break;
 		case O2_EXPR:
 			e->outputExpression(1) = text;
+			e->updatePrograms();
 			break;
 	}
 	if (m_wave_expr)
@@ -571,7 +578,7 @@ void XpressiveView::expressionChanged() {
 			expr.add_cyclic_vector("W2",e->graphW2().samples(),e->graphW2().length());
 			expr.add_cyclic_vector("W3",e->graphW3().samples(),e->graphW3().length());
 		}
-		expr.setIntegrate(&frame_counter,sample_rate);
+		expr.setIntegrate(sample_rate);
 		expr.add_constant("srate",sample_rate);
 
 		const bool parse_ok=expr.compile();
@@ -580,7 +587,6 @@ void XpressiveView::expressionChanged() {
 			e->exprValid().setValue(0);
 			const unsigned int length = static_cast<unsigned int>(m_raw_graph->length());
 			auto const samples = new float[length];
-			// frame_counter's reference is used in the integrate function.
 			for (frame_counter = 0; frame_counter < length; ++frame_counter)
 			{
 				t = frame_counter / (float) length;
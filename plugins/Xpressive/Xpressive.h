@@ -109,7 +109,9 @@ public:
 	static void smooth(float smoothness,const graphModel* in,graphModel* out);
 protected:
 	
-protected slots:
+public slots:
+	//! Recompiles the output expressions for new voices
+	void updatePrograms();
 
 
 private:
@@ -138,6 +140,7 @@ private:
 	FloatModel m_relTransition;
 	float m_A1,m_A2,m_A3;
 	WaveSample m_W1, m_W2, m_W3;
+	ExprProgramPool m_programs;
 
 	BoolModel m_exprValid;
 	
@@ -266,6 +266,42 @@ void LocalZynAddSubFx::processMidiEvent( const MidiEvent& event )
 
 
 
+void LocalZynAddSubFx::PartJob::doProcessing()
+{
+	m_part->ComputePartSmps();
+}
+
+
+
+
+void LocalZynAddSubFx::queuePartJobs( std::vector<ThreadableJob*>& _jobs )
+{
+	// The very first GetAudioOutSamples() call runs Master::AudioOut() twice
+	// to fill its buffer, which would mix our part outputs twice
+	if( !m_primed )
+	{
+		return;
+	}
+
+	for( int npart = 0; npart < NUM_MIDI_PARTS; ++npart )
+	{
+		Part * part = m_master->part[npart];
+		// Master::AudioOut() skips computing parts whose load_mutex it can't
+		// get and mixes whatever they have in their output buffers. Holding
+		// it until processAudio() is done therefore makes the master use
+		// the output computed by our job instead of rendering the part itself.
+		if( part->Penabled == 0 || pthread_mutex_trylock( &part->load_mutex ) != 0 )
+		{
+			continue;
+		}
+		m_partJobs[npart].m_part = part;
+		_jobs.push_back( &m_partJobs[npart] );
+	}
+}
+
+
+
+
 void LocalZynAddSubFx::processAudio( SampleFrame* _out )
 {
 #ifdef _MSC_VER
@@ -277,6 +313,16 @@ void LocalZynAddSubFx::processAudio( SampleFrame* _out )
 #endif
 
 	m_master->GetAudioOutSamples( synth->buffersize, synth->samplerate, outputl, outputr );
+	m_primed = true;
+
+	for( auto & job : m_partJobs )
+	{
+		if( job.m_part != nullptr )
+		{
+			pthread_mutex_unlock( &job.m_part->load_mutex );
+			job.m_part = nullptr;
+		}
+	}
 
 	// TODO: move to MixHelpers
 	for( int f = 0; f < synth->buffersize; ++f )
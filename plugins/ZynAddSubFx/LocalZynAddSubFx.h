@@ -26,11 +26,16 @@
 #define LOCAL_ZYNADDSUBFX_H
 
 #include <array>
+#include <vector>
+
+#include <globals.h>
 
 #include "Note.h"
+#include "ThreadableJob.h"
 
 class Master;
 class NulEngine;
+class Part;
 
 namespace lmms
 {
@@ -63,6 +68,12 @@ public:
 
 	void processMidiEvent( const MidiEvent& event );
 
+	//! Queues one job per enabled part, which computes that part's output
+	//! ahead of the next processAudio() call. processAudio() then only runs
+	//! the effects and the mix, so the parts of one instance can be spread
+	//! over several threads.
+	void queuePartJobs( std::vector<ThreadableJob*>& _jobs );
+
 	void processAudio( SampleFrame* _out );
 
 	inline Master * master()
@@ -72,6 +83,20 @@ public:
 
 
 protected:
+	class PartJob : public ThreadableJob
+	{
+	public:
+		bool requiresProcessing() const override
+		{
+			return m_part != nullptr;
+		}
+
+		Part * m_part = nullptr;
+
+	protected:
+		void doProcessing() override;
+	} ;
+
 	static int s_instanceCount;
 
 	std::string m_presetsDir;
@@ -80,6 +105,9 @@ protected:
 	Master * m_master;
 	NulEngine* m_ioEngine;
 
+	std::array<PartJob, NUM_MIDI_PARTS> m_partJobs;
+	bool m_primed = false;
+
 } ;
 
 
@@ -59,6 +59,7 @@ public:
 		Nio::start();
 
 		setInputCount( 0 );
+		enableProcessChannel();
 		sendMessage( IdInitDone );
 		waitForMessage( IdInitDone );
 
@@ -67,6 +68,7 @@ public:
 
 	~RemoteZynAddSubFx() override
 	{
+		disableProcessChannel();
 		m_messageThread.join();
 		Nio::stop();
 	}
@@ -146,6 +148,12 @@ public:
 		LocalZynAddSubFx::processAudio( _out );
 	}
 
+	void processChannelRequest() override
+	{
+		const auto lock = std::lock_guard{m_master->mutex};
+		RemotePluginClient::processChannelRequest();
+	}
+
 	void guiLoop();
 
 private:
@@ -109,6 +109,8 @@ ZynAddSubFxInstrument::ZynAddSubFxInstrument(
 	m_hasGUI( false ),
 	m_plugin( nullptr ),
 	m_remotePlugin( nullptr ),
+	m_renderPartsInJobs( false ),
+	m_remoteProcessing( false ),
 	m_portamentoModel( 0, 0, 127, 1, this, tr( "Portamento" ) ),
 	m_filterFreqModel( 64, 0, 127, 1, this, tr( "Filter frequency" ) ),
 	m_filterQModel( 64, 0, 127, 1, this, tr( "Filter resonance" ) ),
@@ -116,7 +118,8 @@ ZynAddSubFxInstrument::ZynAddSubFxInstrument(
 	m_fmGainModel( 127, 0, 127, 1, this, tr( "FM gain" ) ),
 	m_resCenterFreqModel( 64, 0, 127, 1, this, tr( "Resonance center frequency" ) ),
 	m_resBandwidthModel( 64, 0, 127, 1, this, tr( "Resonance bandwidth" ) ),
-	m_forwardMidiCcModel( true, this, tr( "Forward MIDI control change events" ) )
+	m_forwardMidiCcModel( true, this, tr( "Forward MIDI control change events" ) ),
+	m_parallelPartsModel( false, this, tr( "Render parts in parallel" ) )
 {
 	initPlugin();
 
@@ -156,6 +159,7 @@ ZynAddSubFxInstrument::~ZynAddSubFxInstrument()
 				| PlayHandle::Type::InstrumentPlayHandle );
 
 	m_pluginMutex.lock();
+	finishPendingPeriod();
 	delete m_plugin;
 	delete m_remotePlugin;
 	m_plugin = nullptr;
@@ -189,6 +193,7 @@ void ZynAddSubFxInstrument::saveSettings( QDomDocument & _doc,
 	_this.setAttribute( "modifiedcontrollers", modifiedControllers );
 
 	m_forwardMidiCcModel.saveSettings( _doc, _this, "forwardmidicc" );
+	m_parallelPartsModel.saveSettings( _doc, _this, "parallelparts" );
 
 	QTemporaryFile tf;
 	if( tf.open() )
@@ -236,6 +241,7 @@ void ZynAddSubFxInstrument::loadSettings( const QDomElement & _this )
 	m_resCenterFreqModel.loadSettings( _this, "rescenterfreq" );
 	m_resBandwidthModel.loadSettings( _this, "resbandwidth" );
 	m_forwardMidiCcModel.loadSettings( _this, "forwardmidicc" );
+	m_parallelPartsModel.loadSettings( _this, "parallelparts" );
 
 	QDomDocument doc;
 	QDomElement data = _this.firstChildElement( "ZynAddSubFX-data" );
@@ -347,6 +353,92 @@ void ZynAddSubFxInstrument::play( SampleFrame* _buf )
 
 
 
+bool ZynAddSubFxInstrument::startPlay()
+{
+	if (!m_pluginMutex.tryLock(Engine::getSong()->isExporting() ? -1 : 0)) { return false; }
+	// finishPlay() may have been unable to collect the previous period
+	finishPendingPeriod();
+	const bool remote = m_remotePlugin != nullptr;
+	if( remote )
+	{
+		m_remotePlugin->startProcessing( nullptr );
+	}
+	m_remoteProcessing = remote;
+	m_pluginMutex.unlock();
+
+	// the in-process engine renders right away in play(), unless its parts
+	// are handed out as jobs in queueJobs()
+	m_renderPartsInJobs = !remote && m_parallelPartsModel.value();
+	return remote || m_renderPartsInJobs;
+}
+
+
+
+
+void ZynAddSubFxInstrument::queueJobs( std::vector<ThreadableJob*>& _jobs )
+{
+	if( !m_renderPartsInJobs )
+	{
+		return;
+	}
+
+	// The audio engine calls finishPlay() from this thread as well, after
+	// the jobs are done; keep the engine locked until then
+	if (!m_pluginMutex.tryLock(Engine::getSong()->isExporting() ? -1 : 0))
+	{
+		m_renderPartsInJobs = false;
+		return;
+	}
+	if( m_plugin )
+	{
+		m_plugin->queuePartJobs( _jobs );
+	}
+}
+
+
+
+
+void ZynAddSubFxInstrument::finishPlay( SampleFrame* _buf )
+{
+	if( m_renderPartsInJobs )
+	{
+		// locked in queueJobs()
+		m_renderPartsInJobs = false;
+		if( m_plugin )
+		{
+			m_plugin->processAudio( _buf );
+		}
+		m_pluginMutex.unlock();
+		return;
+	}
+
+	// The GUI thread may hold the mutex for long, e.g. while loading a
+	// preset, so the period is skipped then. It stays pending and is
+	// finished by the next startPlay() or before the plugin is replaced.
+	if (!m_pluginMutex.tryLock(Engine::getSong()->isExporting() ? -1 : 0)) { return; }
+	if( m_remoteProcessing && m_remotePlugin )
+	{
+		m_remotePlugin->finishProcessing( _buf );
+	}
+	m_remoteProcessing = false;
+	m_pluginMutex.unlock();
+}
+
+
+
+
+void ZynAddSubFxInstrument::finishPendingPeriod()
+{
+	if( m_remoteProcessing && m_remotePlugin )
+	{
+		m_remotePlugin->finishProcessing( nullptr );
+	}
+	m_remoteProcessing = false;
+}
+
+
+
+
 bool ZynAddSubFxInstrument::handleMidiEvent( const MidiEvent& event, const TimePos& time, f_cnt_t offset )
 {
 	// do not forward external MIDI Control Change events if the according
@@ -430,6 +522,9 @@ GEN_CC_SLOT(updateResBandwidth,C_resonance_bandwidth,m_resBandwidthModel);
 void ZynAddSubFxInstrument::initPlugin()
 {
 	m_pluginMutex.lock();
+	// every startProcessing() must be followed by exactly one
+	// finishProcessing() on the same process
+	finishPendingPeriod();
 	delete m_plugin;
 	delete m_remotePlugin;
 	m_plugin = nullptr;
@@ -531,6 +626,10 @@ ZynAddSubFxView::ZynAddSubFxView( Instrument * _instrument, QWidget * _parent )
 
 	m_forwardMidiCC = new LedCheckBox( tr( "Forward MIDI control changes" ), this );
 
+	m_parallelParts = new LedCheckBox( tr( "Render parts in parallel" ), this );
+	m_parallelParts->setToolTip( tr( "Spread the parts of this instance over several "
+						"CPU cores. Has no effect while the GUI is shown." ) );
+
 	m_toggleUIButton = new QPushButton( tr( "Show GUI" ), this );
 	m_toggleUIButton->setCheckable( true );
 	m_toggleUIButton->setChecked( false );
@@ -551,8 +650,9 @@ ZynAddSubFxView::ZynAddSubFxView( Instrument * _instrument, QWidget * _parent )
 	l->addWidget( m_resCenterFreq, 3, 1 );
 	l->addWidget( m_resBandwidth, 3, 2 );
 	l->addWidget( m_forwardMidiCC, 4, 0, 1, 4 );
+	l->addWidget( m_parallelParts, 5, 0, 1, 4 );
 
-	l->setRowStretch( 5, 10 );
+	l->setRowStretch( 6, 10 );
 	l->setColumnStretch( 4, 10 );
 
 	setAcceptDrops( true );
@@ -618,6 +718,7 @@ void ZynAddSubFxView::modelChanged()
 	m_resBandwidth->setModel( &m->m_resBandwidthModel );
 
 	m_forwardMidiCC->setModel( &m->m_forwardMidiCcModel );
+	m_parallelParts->setModel( &m->m_parallelPartsModel );
 
 	m_toggleUIButton->setChecked( m->m_hasGUI );
 }
@@ -75,6 +75,9 @@ public:
 	~ZynAddSubFxInstrument() override;
 
 	void play( SampleFrame* _working_buffer ) override;
+	bool startPlay() override;
+	void queueJobs( std::vector<ThreadableJob*>& _jobs ) override;
+	void finishPlay( SampleFrame* _working_buffer ) override;
 
 	bool handleMidiEvent( const MidiEvent& event, const TimePos& time = TimePos(), f_cnt_t offset = 0 ) override;
 
@@ -106,11 +109,20 @@ private slots:
 private:
 	void initPlugin();
 	void sendControlChange( MidiControllers midiCtl, float value );
+	//! Finish the period the remote plugin is still processing, if any,
+	//! discarding its output. m_pluginMutex must be held.
+	void finishPendingPeriod();
 
 	bool m_hasGUI;
 	QMutex m_pluginMutex;
 	LocalZynAddSubFx * m_plugin;
 	ZynAddSubFxRemotePlugin * m_remotePlugin;
+	// set by startPlay() when the parts of the local instance are rendered
+	// through jobs; m_pluginMutex is then held from queueJobs() to finishPlay()
+	bool m_renderPartsInJobs;
+	// set by startPlay() when the remote plugin started processing a period
+	// which is not collected yet, see finishPendingPeriod()
+	bool m_remoteProcessing;
 
 	FloatModel m_portamentoModel;
 	FloatModel m_filterFreqModel;
@@ -120,6 +132,7 @@ private:
 	FloatModel m_resCenterFreqModel;
 	FloatModel m_resBandwidthModel;
 	BoolModel m_forwardMidiCcModel;
+	BoolModel m_parallelPartsModel;
 
 	QMap<int, bool> m_modifiedControllers;
 
@@ -160,6 +173,7 @@ private:
 	Knob * m_resCenterFreq;
 	Knob * m_resBandwidth;
 	LedCheckBox * m_forwardMidiCC;
+	LedCheckBox * m_parallelParts;
 
 
 private slots:
@@ -0,0 +1,235 @@
+/*
+ * RemoteProcessChannel.cpp - shared-memory fast path for remote plugin processing
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RemoteProcessChannel.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+#	include <cerrno>
+#	include <ctime>
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace lmms
+{
+
+namespace
+{
+
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+
+// The block is mapped into two processes, so the non-private futex
+// operations have to be used
+
+void futexWait(std::uint32_t* word, std::uint32_t expected, std::chrono::nanoseconds timeout)
+{
+	const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+	auto ts = timespec{};
+	ts.tv_sec = static_cast<std::time_t>(seconds.count());
+	ts.tv_nsec = static_cast<long>((timeout - seconds).count());
+	// EAGAIN (value already changed), EINTR and ETIMEDOUT are all handled
+	// by the caller re-checking the word
+	syscall(SYS_futex, word, FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void futexWake(std::uint32_t* word)
+{
+	syscall(SYS_futex, word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+#else
+
+void futexWait(std::uint32_t*, std::uint32_t, std::chrono::nanoseconds)
+{
+	std::this_thread::yield();
+}
+
+void futexWake(std::uint32_t*)
+{
+}
+
+#endif
+
+} // namespace
+
+
+
+
+void RemoteProcessChannel::create()
+{
+	m_data.create();
+	*m_data = Data{};
+	m_request = 0;
+}
+
+
+
+
+void RemoteProcessChannel::attach(const std::string& key)
+{
+	m_data.attach(key);
+	// resume after the last completed request, so one issued before we
+	// attached is still picked up
+	m_request = std::atomic_ref{m_data->doneSeq}.load(std::memory_order_acquire);
+}
+
+
+
+
+void RemoteProcessChannel::detach() noexcept
+{
+	m_data.detach();
+}
+
+
+
+
+bool RemoteProcessChannel::pushMidiEvent(const MidiEntry& entry)
+{
+	auto head = std::atomic_ref{m_data->midiHead};
+	const auto pos = head.load(std::memory_order_relaxed);
+	const auto tail = std::atomic_ref{m_data->midiTail}.load(std::memory_order_acquire);
+	if (pos - tail >= Data::MidiRingSize) { return false; }
+
+	m_data->midi[pos & (Data::MidiRingSize - 1)] = entry;
+	head.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+
+
+
+void RemoteProcessChannel::requestProcessing()
+{
+	std::atomic_ref{m_data->requestSeq}.store(++m_request, std::memory_order_seq_cst);
+	wake(m_data->requestSeq, m_data->clientWaiting);
+}
+
+
+
+
+bool RemoteProcessChannel::waitForProcessingDone(std::chrono::milliseconds timeout)
+{
+	// After an earlier timeout the client may still be finishing an older
+	// request, so wait for the exact sequence number rather than any change
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (true)
+	{
+		const auto done = std::atomic_ref{m_data->doneSeq}.load(std::memory_order_acquire);
+		if (done == m_request) { return true; }
+
+		const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+			deadline - std::chrono::steady_clock::now());
+		if (left.count() <= 0
+			|| !m_spinner.wait(m_data->doneSeq, done, m_data->hostWaiting, left))
+		{
+			return false;
+		}
+	}
+}
+
+
+
+
+bool RemoteProcessChannel::waitForRequest(std::chrono::milliseconds timeout)
+{
+	if (!m_spinner.wait(m_data->requestSeq, m_request, m_data->clientWaiting, timeout))
+	{
+		return false;
+	}
+	m_request = std::atomic_ref{m_data->requestSeq}.load(std::memory_order_acquire);
+	return true;
+}
+
+
+
+
+void RemoteProcessChannel::signalProcessingDone()
+{
+	std::atomic_ref{m_data->doneSeq}.store(m_request, std::memory_order_seq_cst);
+	wake(m_data->doneSeq, m_data->hostWaiting);
+}
+
+
+
+
+void RemoteProcessChannel::wake(std::uint32_t& word, std::uint32_t& waiting)
+{
+	// Pairs with the seq_cst store of the waiting flag in Spinner::wait():
+	// either we see the flag, or the waiter sees the new value of the word
+	if (std::atomic_ref{waiting}.load(std::memory_order_seq_cst) != 0)
+	{
+		futexWake(&word);
+	}
+}
+
+
+
+
+bool RemoteProcessChannel::Spinner::wait(std::uint32_t& word, std::uint32_t old,
+	std::uint32_t& waiting, std::chrono::milliseconds timeout)
+{
+	auto value = std::atomic_ref{word};
+
+	for (int i = 0; i < m_spins; ++i)
+	{
+		if (value.load(std::memory_order_acquire) != old)
+		{
+			// The answer tends to arrive within the spin window; allow a little
+			// more spinning next time so we keep avoiding the syscall
+			m_spins = std::min(m_spins * 2, MaxSpins);
+			return true;
+		}
+		busyWaitHint();
+	}
+
+	// Spinning did not pay off, so spin less next time
+	m_spins = std::max(m_spins / 2, MinSpins);
+
+	auto flag = std::atomic_ref{waiting};
+	flag.store(1, std::memory_order_seq_cst);
+
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	bool changed = true;
+	while (value.load(std::memory_order_seq_cst) == old)
+	{
+		const auto left = deadline - std::chrono::steady_clock::now();
+		if (left.count() <= 0)
+		{
+			changed = false;
+			break;
+		}
+		futexWait(&word, old, left);
+	}
+
+	flag.store(0, std::memory_order_relaxed);
+	return changed;
+}
+
+
+} // namespace lmms
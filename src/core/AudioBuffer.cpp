@@ -24,6 +24,8 @@
 
 #include "AudioBuffer.h"
 
+#include <cmath>
+
 #include "ConfigManager.h"
 #include "MixHelpers.h"
 #include "SharedMemory.h"
@@ -81,6 +83,21 @@ AudioBuffer::AudioBuffer(f_cnt_t frames, ch_cnt_t channels,
 void AudioBuffer::allocateInterleavedBuffer()
 {
 	m_interleavedBuffer.resize(2 * m_frames);
+	m_interleavedInSync = false;
+}
+
+void AudioBuffer::syncInterleavedBuffer()
+{
+	if (m_interleavedInSync) { return; }
+
+	toInterleaved(groupBuffers(0), interleavedBuffer());
+	m_interleavedInSync = true;
+}
+
+void AudioBuffer::syncFromInterleavedBuffer()
+{
+	toPlanar(interleavedBuffer(), groupBuffers(0));
+	m_interleavedInSync = true;
 }
 
 auto AudioBuffer::allocationSize(f_cnt_t frames, ch_cnt_t channels, bool withInterleavedBuffer) -> std::size_t
@@ -143,6 +160,7 @@ auto AudioBuffer::addGroup(ch_cnt_t channels) -> ChannelGroup*
 	if (usesInterleavedBuffer)
 	{
 		m_interleavedBuffer.resize(2 * m_frames);
+		m_interleavedInSync = false;
 	}
 
 	// Fix channel buffers
@@ -221,10 +239,10 @@ auto AudioBuffer::sanitize(const ChannelFlags& channels, ch_cnt_t upperBound) ->
 		}
 	}
 
-	if (changesMade && hasInterleavedBuffer() && (channels[0] || channels[1]))
+	if (changesMade && (channels[0] || channels[1]))
 	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
+		// The temporary interleaved buffer is brought up to date when it is needed
+		invalidateInterleavedBuffer();
 	}
 
 	return changesMade;
@@ -244,10 +262,10 @@ auto AudioBuffer::sanitizeAll() -> bool
 		}
 	}
 
-	if (changesMade && hasInterleavedBuffer())
+	if (changesMade)
 	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
+		// The temporary interleaved buffer is brought up to date when it is needed
+		invalidateInterleavedBuffer();
 	}
 
 	return changesMade;
@@ -331,10 +349,10 @@ void AudioBuffer::silenceChannels(const ChannelFlags& channels, ch_cnt_t upperBo
 		}
 	}
 
-	if (hasInterleavedBuffer() && (needSilenced[0] || needSilenced[1]))
+	if (needSilenced[0] || needSilenced[1])
 	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
+		// The temporary interleaved buffer is brought up to date when it is needed
+		invalidateInterleavedBuffer();
 	}
 
 	m_silenceFlags |= channels;
@@ -344,6 +362,7 @@ void AudioBuffer::silenceAllChannels()
 {
 	std::ranges::fill(m_sourceBuffer, 0);
 	std::ranges::fill(m_interleavedBuffer, 0);
+	m_interleavedInSync = true;
 
 	m_silenceFlags.set();
 }
@@ -359,4 +378,19 @@ auto AudioBuffer::absPeakValue(ch_cnt_t channel) const -> float
 	return std::abs(std::ranges::max(buffer(channel), {}, static_cast<float(&)(float)>(std::abs)));
 }
 
+auto AudioBuffer::rmsValue(ch_cnt_t channel) const -> float
+{
+	if (m_silenceFlags[channel] || m_frames == 0)
+	{
+		return 0;
+	}
+
+	float sum = 0.f;
+	for (const float sample : buffer(channel))
+	{
+		sum += sample * sample;
+	}
+	return std::sqrt(sum / m_frames);
+}
+
 } // namespace lmms
@@ -130,8 +130,8 @@ void AudioBusHandle::doProcessing()
 			{
 				m_bufferUsage = true;
 
-				// Writing to temporary interleaved buffer until PlayHandle and MixHelpers switch to planar
-				MixHelpers::add(m_buffer.interleavedBuffer().asSampleFrames().data(), ph->buffer(), fpp);
+				// PlayHandle buffers are still interleaved, so they are converted while mixing
+				MixHelpers::add(m_buffer.groupBuffers(0), ph->buffer());
 			}
 			ph->releaseBuffer(); 	// gets rid of playhandle's buffer and sets
 									// pointer to null, so if it doesn't get re-acquired we know to skip it next time
@@ -140,8 +140,8 @@ void AudioBusHandle::doProcessing()
 
 	if (m_bufferUsage)
 	{
-		// PlayHandle buffers were written to the temporary interleaved buffer
-		auto buffer = m_buffer.interleavedBuffer();
+		float* left = m_buffer.buffer(0).data();
+		float* right = m_buffer.buffer(1).data();
 
 		// handle volume and panning
 		// has both vol and pan models
@@ -157,8 +157,8 @@ void AudioBusHandle::doProcessing()
 				{
 					float v = volBuf->values()[f] * 0.01f;
 					float p = panBuf->values()[f] * 0.01f;
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 
@@ -171,8 +171,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float v = volBuf->values()[f] * 0.01f;
-					buffer[f][0] *= v * l;
-					buffer[f][1] *= v * r;
+					left[f] *= v * l;
+					right[f] *= v * r;
 				}
 			}
 
@@ -183,8 +183,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float p = panBuf->values()[f] * 0.01f;
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 
@@ -195,8 +195,8 @@ void AudioBusHandle::doProcessing()
 				float v = m_volumeModel->value() * 0.01f;
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 		}
@@ -211,8 +211,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float v = volBuf->values()[f] * 0.01f;
-					buffer[f][0] *= v;
-					buffer[f][1] *= v;
+					left[f] *= v;
+					right[f] *= v;
 				}
 			}
 			else
@@ -220,16 +220,12 @@ void AudioBusHandle::doProcessing()
 				float v = m_volumeModel->value() * 0.01f;
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
-					buffer[f][0] *= v;
-					buffer[f][1] *= v;
+					left[f] *= v;
+					right[f] *= v;
 				}
 			}
 		}
 
-		// Copy from temporary interleaved buffer to the main planar buffer
-		// so they stay in sync
-		toPlanar(buffer, m_buffer.groupBuffers(0));
-
 		const auto sanitized = Engine::audioEngine()->sanitizationEnabled() ? m_buffer.sanitizeAll() : false;
 		m_corrupted.store(sanitized, std::memory_order_relaxed);
 
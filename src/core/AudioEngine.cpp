@@ -34,6 +34,7 @@
 #include "Mixer.h"
 #include "Song.h"
 #include "EnvelopeAndLfoParameters.h"
+#include "InstrumentPlayHandle.h"
 #include "NotePlayHandle.h"
 #include "ConfigManager.h"
 
@@ -88,6 +89,7 @@ AudioEngine::AudioEngine(bool renderOnly)
 	, m_oldAudioDev(nullptr)
 	, m_audioDevStartFailed(false)
 	, m_profiler()
+	, m_telemetry(m_framesPerPeriod)
 	, m_clearSignal(false)
 	, m_sanitizationEnabled(ConfigManager::inst()->value("audioengine", "sanitizemix", "1").toInt())
 {
@@ -257,6 +259,32 @@ void AudioEngine::renderStageInstruments()
 
 	AudioEngineWorkerThread::fillJobQueue(m_playHandles);
 	AudioEngineWorkerThread::startAndWaitForJobs();
+
+	// instruments that split up their rendering can only hand out their jobs
+	// once their play handle has processed the notes of this period
+	m_instrumentJobs.clear();
+	for (const auto& handle : m_playHandles)
+	{
+		if (handle->type() == PlayHandle::Type::InstrumentPlayHandle)
+		{
+			static_cast<InstrumentPlayHandle*>(handle)->queueJobs(m_instrumentJobs);
+		}
+	}
+	if (!m_instrumentJobs.empty())
+	{
+		AudioEngineWorkerThread::fillJobQueue(m_instrumentJobs);
+		AudioEngineWorkerThread::startAndWaitForJobs();
+	}
+
+	// collect instruments that rendered out of process or through their own
+	// jobs while the other play handles were being processed
+	for (const auto& handle : m_playHandles)
+	{
+		if (handle->type() == PlayHandle::Type::InstrumentPlayHandle)
+		{
+			static_cast<InstrumentPlayHandle*>(handle)->finishPlay();
+		}
+	}
 }
 
 
@@ -307,8 +335,6 @@ void AudioEngine::renderStageMix()
 
 	MixHelpers::multiply(m_outputBufferWrite.get(), m_masterGain, m_framesPerPeriod);
 
-	emit nextAudioBuffer(m_outputBufferRead.get());
-
 	// and trigger LFOs
 	EnvelopeAndLfoParameters::instances()->trigger();
 	Controller::triggerFrameCounter();
@@ -331,11 +357,36 @@ std::span<const SampleFrame> AudioEngine::renderNextPeriod()
 
 	s_renderingThread = false;
 	m_profiler.finishPeriod(outputSampleRate(), m_framesPerPeriod);
+	publishTelemetry();
 	m_outputBufferReadIndex = 0;
 
 	return {m_outputBufferRead.get(), m_framesPerPeriod};
 }
 
+void AudioEngine::publishTelemetry()
+{
+	auto& snapshot = m_telemetry.beginWrite();
+
+	snapshot.period = m_telemetry.published();
+	snapshot.cpuLoad = m_profiler.cpuLoad();
+	for (std::size_t i = 0; i < AudioEngineProfiler::DetailCount; ++i)
+	{
+		snapshot.detailLoad[i] = m_profiler.detailLoad(static_cast<AudioEngineProfiler::DetailType>(i));
+	}
+
+	Mixer* mixer = Engine::mixer();
+	const auto channels = mixer ? std::min<std::size_t>(mixer->numChannels(), snapshot.channels.size()) : 0;
+	for (std::size_t i = 0; i < channels; ++i)
+	{
+		snapshot.channels[i] = mixer->mixerChannel(i)->m_levels;
+	}
+	snapshot.channelCount = channels;
+
+	std::copy_n(m_outputBufferRead.get(), m_framesPerPeriod, snapshot.output.begin());
+
+	m_telemetry.endWrite();
+}
+
 void AudioEngine::swapBuffers()
 {
 	m_inputBufferWrite = (m_inputBufferWrite + 1) % 2;
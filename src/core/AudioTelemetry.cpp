@@ -0,0 +1,58 @@
+/*
+ * AudioTelemetry.cpp - lock-free channel for levels and statistics of the
+ *                      audio processing
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AudioTelemetry.h"
+
+namespace lmms
+{
+
+
+AudioTelemetry::AudioTelemetry(f_cnt_t framesPerPeriod)
+{
+	// Everything the audio thread writes is allocated up front
+	for (auto& snapshot : m_ring)
+	{
+		snapshot.output.resize(framesPerPeriod);
+	}
+}
+
+
+
+
+void AudioTelemetry::reserveChannels(std::size_t count)
+{
+	if (count <= m_channelCapacity) { return; }
+
+	// grow in steps, as channels are usually added one by one
+	m_channelCapacity = (count + 31) / 32 * 32;
+	for (auto& snapshot : m_ring)
+	{
+		snapshot.channels.resize(m_channelCapacity);
+		snapshot.channelCount = std::min(snapshot.channelCount, m_channelCapacity);
+	}
+}
+
+
+} // namespace lmms
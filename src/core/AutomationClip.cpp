@@ -53,7 +53,8 @@ AutomationClip::AutomationClip( AutomationTrack * _auto_track ) :
 	m_progressionType( ProgressionType::Discrete ),
 	m_dragging( false ),
 	m_isRecording( false ),
-	m_lastRecordedValue( 0 )
+	m_lastRecordedValue( 0 ),
+	m_dragPos( 0 )
 {
 	changeLength( TimePos( 1, 0 ) );
 }
@@ -69,7 +70,8 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 	m_progressionType(_clip_to_copy.m_progressionType),
 	m_dragging(false),
 	m_isRecording(_clip_to_copy.m_isRecording),
-	m_lastRecordedValue(0)
+	m_lastRecordedValue(0),
+	m_dragPos(0)
 {
 	// Locks the mutex of the copied AutomationClip to make sure it
 	// doesn't change while it's being copied
@@ -125,6 +127,7 @@ void AutomationClip::setProgressionType(
 		_new_progression_type == ProgressionType::CubicHermite )
 	{
 		m_progressionType = _new_progression_type;
+		m_levelsOfDetail.invalidateAll();
 		emit dataChanged();
 	}
 }
@@ -142,6 +145,7 @@ void AutomationClip::setTension( QString _new_tension )
 	if( ok && nt > -0.01 && nt < 1.01 )
 	{
 		m_tension = nt;
+		m_levelsOfDetail.invalidateAll();
 	}
 }
 
@@ -469,6 +473,7 @@ TimePos AutomationClip::setDragValue(
 {
 	QMutexLocker m(&m_clipMutex);
 
+	const bool wasDragging = m_dragging;
 	if (m_dragging == false)
 	{
 		TimePos newTime = quantPos ? Note::quantized(time, quantization()) : time;
@@ -512,7 +517,12 @@ TimePos AutomationClip::setDragValue(
 	//Restore to the state before it the point were being dragged
 	m_timeMap = m_oldTimeMap;
 
-	generateTangents();
+	computeTangents(m_timeMap.begin(), m_timeMap.size());
+	if (wasDragging)
+	{
+		// This only undid the changes around where the node was put last time
+		invalidateCurve(m_dragPos, m_dragPos + quantization());
+	}
 
 	TimePos returnedPos;
 
@@ -535,9 +545,12 @@ TimePos AutomationClip::setDragValue(
 			it.value().setInTangent(m_dragInTan);
 			it.value().setOutTangent(m_dragOutTan);
 			it.value().setLockedTangents(true);
+			invalidateCurve(returnedPos, returnedPos);
 		}
 	}
 
+	m_dragPos = returnedPos;
+
 	return returnedPos;
 }
 
@@ -648,6 +661,47 @@ float AutomationClip::valueAt( timeMap::const_iterator v, int offset ) const
 
 
 
+void AutomationClip::sampleValues(tick_t from, tick_t to, float* out) const
+{
+	QMutexLocker m(&m_clipMutex);
+
+	// Start at the node at or before the first tick
+	auto it = m_timeMap.upperBound(from);
+	if (it != m_timeMap.begin()) { --it; }
+
+	for (tick_t tick = from; tick < to; ++tick)
+	{
+		for (auto next = std::next(it); next != m_timeMap.end() && POS(next) <= tick; next = std::next(it))
+		{
+			it = next;
+		}
+		*out++ = valueAt(it, tick - POS(it));
+	}
+}
+
+
+
+
+const AutomationLod& AutomationClip::levelsOfDetail() const
+{
+	QMutexLocker m(&m_clipMutex);
+
+	if (m_timeMap.isEmpty())
+	{
+		m_levelsOfDetail.clear();
+	}
+	else
+	{
+		m_levelsOfDetail.update(m_timeMap.firstKey(), m_timeMap.lastKey() + 1,
+			[this](tick_t from, tick_t to, float* out) { sampleValues(from, to, out); });
+	}
+
+	return m_levelsOfDetail;
+}
+
+
+
+
 float *AutomationClip::valuesAfter( const TimePos & _time ) const
 {
 	QMutexLocker m(&m_clipMutex);
@@ -902,6 +956,8 @@ void AutomationClip::loadSettings( const QDomElement & _this )
 	}
 
 	if (shouldGenerateTangents) { generateTangents(); }
+
+	m_levelsOfDetail.invalidateAll();
 }
 
 
@@ -1086,6 +1142,7 @@ void AutomationClip::clear()
 	QMutexLocker m(&m_clipMutex);
 
 	m_timeMap.clear();
+	m_levelsOfDetail.invalidateAll();
 
 	emit dataChanged();
 }
@@ -1148,11 +1205,27 @@ void AutomationClip::generateTangents()
 
 
 
+void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
+{
+	QMutexLocker m(&m_clipMutex);
+
+	computeTangents(it, numToGenerate);
+
+	if (it == m_timeMap.end() || numToGenerate <= 0) { return; }
+
+	auto last = it;
+	for (int i = 1; i < numToGenerate && std::next(last) != m_timeMap.end(); ++i) { ++last; }
+	invalidateCurve(POS(it), POS(last));
+}
+
+
+
+
 // We have two tangents, one for the left side of the node and one for the right side
 // of the node (in case we have discrete value jumps in the middle of a curve).
 // If the inValue and outValue of a node are the same, consequently the inTangent and
 // outTangent values of the node will be the same too.
-void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
+void AutomationClip::computeTangents(timeMap::iterator it, int numToGenerate)
 {
 	QMutexLocker m(&m_clipMutex);
 
@@ -1213,6 +1286,25 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 	}
 }
 
+void AutomationClip::invalidateCurve(tick_t from, tick_t to)
+{
+	QMutexLocker m(&m_clipMutex);
+
+	// The tangents of the neighbours depend on the changed nodes, and they
+	// shape the segments up to the next node beyond them
+	auto first = m_timeMap.lowerBound(from);
+	for (int i = 0; i < 2 && first != m_timeMap.begin(); ++i) { --first; }
+	auto last = m_timeMap.upperBound(to);
+	if (last != m_timeMap.end()) { ++last; }
+
+	m_levelsOfDetail.invalidate(
+		first == m_timeMap.begin() ? std::numeric_limits<tick_t>::min() : POS(first),
+		last == m_timeMap.end() ? std::numeric_limits<tick_t>::max() : POS(last));
+}
+
+
+
+
 std::vector<Track*> AutomationClip::combineAllTracks()
 {
 	std::vector<Track*> combinedTrackList;
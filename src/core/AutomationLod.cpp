@@ -0,0 +1,131 @@
+/*
+ * AutomationLod.cpp - min/max pyramid of an automation curve for drawing it
+ *                     at any zoom level
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AutomationLod.h"
+
+#include <cmath>
+
+namespace lmms
+{
+
+
+void AutomationLod::clear()
+{
+	m_begin = m_end = 0;
+	m_levels.clear();
+	invalidateAll();
+}
+
+
+
+
+void AutomationLod::update(tick_t begin, tick_t end, const Sampler& sample)
+{
+	if (begin >= end)
+	{
+		clear();
+		return;
+	}
+
+	if (begin != m_begin || m_levels.empty())
+	{
+		// All buckets are relative to the first tick
+		invalidateAll();
+	}
+	else if (end != m_end)
+	{
+		// The last buckets of each level covered only a part of the old extent
+		invalidate(std::min(end, m_end) - 1, std::max(end, m_end));
+	}
+	m_begin = begin;
+	m_end = end;
+	resize(end - begin);
+
+	const tick_t from = std::max(m_dirtyFrom, begin);
+	const tick_t to = std::min(m_dirtyTo, end - 1) + 1;
+	m_dirtyFrom = std::numeric_limits<tick_t>::max();
+	m_dirtyTo = std::numeric_limits<tick_t>::min();
+	if (from >= to) { return; }
+
+	m_samples.resize(to - from);
+	sample(from, to, m_samples.data());
+
+	auto first = static_cast<std::size_t>(from - begin);
+	auto last = static_cast<std::size_t>(to - 1 - begin);
+	for (auto i = first; i <= last; ++i)
+	{
+		const float value = m_samples[i - first];
+		m_levels[0][i] = Bucket{value, value};
+	}
+
+	for (std::size_t level = 1; level < m_levels.size(); ++level)
+	{
+		first >>= 1;
+		last >>= 1;
+
+		const auto& below = m_levels[level - 1];
+		auto& buckets = m_levels[level];
+		for (auto i = first; i <= last; ++i)
+		{
+			auto bucket = below[2 * i];
+			if (2 * i + 1 < below.size())
+			{
+				bucket.min = std::min(bucket.min, below[2 * i + 1].min);
+				bucket.max = std::max(bucket.max, below[2 * i + 1].max);
+			}
+			buckets[i] = bucket;
+		}
+	}
+}
+
+
+
+
+int AutomationLod::levelFor(float ticksPerPixel) const
+{
+	if (m_levels.empty() || ticksPerPixel < 2.f) { return 0; }
+
+	const auto level = static_cast<int>(std::log2(ticksPerPixel));
+	return std::min(level, levelCount() - 1);
+}
+
+
+
+
+void AutomationLod::resize(std::size_t ticks)
+{
+	std::size_t levels = 1;
+	for (auto size = ticks; size > 1; size = (size + 1) / 2) { ++levels; }
+
+	m_levels.resize(levels);
+	for (auto& buckets : m_levels)
+	{
+		buckets.resize(ticks);
+		ticks = (ticks + 1) / 2;
+	}
+}
+
+
+} // namespace lmms
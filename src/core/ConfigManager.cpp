@@ -227,6 +227,14 @@ bool ConfigManager::hasWorkingDir() const
 }
 
 
+QString ConfigManager::cacheDir(const QString& subdir)
+{
+	const auto dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/lmms/" + subdir + "/";
+	QDir().mkpath(dir);
+	return dir;
+}
+
+
 void ConfigManager::setWorkingDir(const QString & workingDir)
 {
 	m_workingDir = ensureTrailingSlash(QDir::cleanPath(workingDir));
@@ -321,6 +329,7 @@ void ConfigManager::addRecentlyOpenedProject(const QString & file)
 	QFileInfo recentFile(file);
 	if(recentFile.suffix().toLower() == "mmp" ||
 		recentFile.suffix().toLower() == "mmpz" ||
+		recentFile.suffix().toLower() == "mmpx" ||
 		recentFile.suffix().toLower() == "mpt")
 	{
 		m_recentlyOpenedProjects.removeAll(file);
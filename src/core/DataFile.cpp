@@ -30,11 +30,16 @@
 #include <cmath>
 #include <map>
 
+#include <mutex>
+#include <tuple>
+
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <QHash>
 #include <QMessageBox>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QSaveFile>
 
@@ -47,6 +52,7 @@
 #include "LocaleHelper.h"
 #include "Note.h"
 #include "PluginFactory.h"
+#include "ProjectContainer.h"
 #include "ProjectVersion.h"
 #include "SongEditor.h"
 #include "TextFloat.h"
@@ -69,6 +75,13 @@ const DataFile::ResourcesMap DataFile::ELEMENTS_WITH_RESOURCES = {
 { "audiofileprocessor", {"src"} },
 };
 
+// QMap with the DOM elements that embed binary data
+const DataFile::ResourcesMap DataFile::ELEMENTS_WITH_EMBEDDED_DATA = {
+{ "sampleclip", {"data"} },
+{ "audiofileprocessor", {"sampledata"} },
+{ "slicert", {"sampledata"} },
+};
+
 // Vector with all the upgrade methods
 const std::vector<DataFile::UpgradeMethod> DataFile::UPGRADE_METHODS = {
 	&DataFile::upgrade_0_2_1_20070501   ,   &DataFile::upgrade_0_2_1_20070508,
@@ -119,11 +132,45 @@ namespace
 		TypeDescStruct{ DataFile::Type::EffectSettings, "effectsettings" },
 		TypeDescStruct{ DataFile::Type::MidiClip, "midiclip" }
 	};
+
+	//! Attribute values starting with this refer to a blob section of a
+	//! project container instead of holding base64 data
+	const auto BlobReferencePrefix = QStringLiteral("lmms-blob:");
+
+	//! Blobs of all project containers that are currently loaded, keyed by
+	//! the references their attributes have been rewritten to
+	struct BlobRegistry
+	{
+		QMutex mutex;
+		QHash<QString, QByteArray> blobs;
+		quint64 nextSerial = 0;
+	};
+
+	BlobRegistry& blobRegistry()
+	{
+		static BlobRegistry s_registry;
+		return s_registry;
+	}
 }
 
 
 
 
+struct DataFile::EmbeddedBlobs
+{
+	QStringList keys;
+
+	~EmbeddedBlobs()
+	{
+		auto& registry = blobRegistry();
+		const auto guard = std::lock_guard{registry.mutex};
+		for (const auto& key : keys) { registry.blobs.remove(key); }
+	}
+};
+
+
+
+
 DataFile::DataFile( Type type ) :
 	QDomDocument( "lmms-project" ),
 	m_fileName(""),
@@ -177,6 +224,12 @@ DataFile::DataFile( const QString & _fileName ) :
 		return;
 	}
 
+	if (ProjectContainer::isContainer(inFile))
+	{
+		loadContainer(inFile, _fileName);
+		return;
+	}
+
 	loadData( inFile.readAll(), _fileName );
 }
 
@@ -202,7 +255,7 @@ bool DataFile::validate( QString extension )
 	switch( m_type )
 	{
 	case Type::SongProject:
-		if( extension == "mmp" || extension == "mmpz" )
+		if( extension == "mmp" || extension == "mmpz" || extension == ProjectContainer::Extension )
 		{
 			return true;
 		}
@@ -227,6 +280,7 @@ bool DataFile::validate( QString extension )
 		break;
 	case Type::Unknown:
 		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" ||
+				extension == ProjectContainer::Extension ||
 				extension == "xpf" || extension == "xml" ||
 				( extension == "xiz" && ! getPluginFactory()->pluginSupportingExtension(extension).isNull()) ||
 				extension == "sf2" || extension == "sf3" || extension == "pat" || extension == "mid" ||
@@ -268,7 +322,8 @@ QString DataFile::nameWithExtension( const QString & _fn ) const
 		case Type::SongProject:
 			if( extension != "mmp" &&
 					extension != "mpt" &&
-					extension != "mmpz" )
+					extension != "mmpz" &&
+					extension != ProjectContainer::Extension )
 			{
 				if( ConfigManager::inst()->value( "app",
 						"nommpz" ).toInt() == 0 )
@@ -343,8 +398,6 @@ bool DataFile::writeFile(const QString& filename, bool withResources)
 	const QString fullName = withResources
 		? nameWithExtension(bundleDir + "/" + fInfo.fileName())
 		: nameWithExtension(filename);
-	const QString fullNameTemp = fullName + ".new";
-	const QString fullNameBak = fullName + ".bak";
 
 	using gui::SongEditor;
 
@@ -389,20 +442,63 @@ bool DataFile::writeFile(const QString& filename, bool withResources)
 		}
 	}
 
-	QSaveFile outfile(fullNameTemp);
-
-	if (!outfile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	switch (writeToDisk(fullName, !ConfigManager::inst()->value("app", "disablebackup").toInt()))
 	{
+	case WriteResult::OpenFailed:
 		showError(SongEditor::tr("Could not write file"),
 			SongEditor::tr("Could not open %1 for writing. You probably are not permitted to "
 				"write to this file. Please make sure you have write-access to "
 				"the file and try again.").arg(fullName));
+		return false;
+	case WriteResult::WriteFailed:
+		showError(SongEditor::tr("Could not write file"),
+			SongEditor::tr("An unknown error has occurred and the file could not be saved."));
+		return false;
+	default:
+		return true;
+	}
+}
+
+
+
 
+bool DataFile::writeFileQuietly(const QString& filename, bool keepBackup)
+{
+	const QString fullName = nameWithExtension(filename);
+	switch (writeToDisk(fullName, keepBackup))
+	{
+	case WriteResult::OpenFailed:
+		qWarning() << "Could not open" << fullName << "for writing";
 		return false;
+	case WriteResult::WriteFailed:
+		qWarning() << "Could not write" << fullName;
+		return false;
+	default:
+		return true;
+	}
+}
+
+
+
+
+DataFile::WriteResult DataFile::writeToDisk(const QString& fullName, bool keepBackup)
+{
+	// QSaveFile writes to a temporary file and renames it over the target on
+	// commit, so the file always holds either the old or the complete new
+	// version, even if writing fails or LMMS crashes meanwhile
+	QSaveFile outfile(fullName);
+
+	if (!outfile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		return WriteResult::OpenFailed;
 	}
 
 	const QString extension = fullName.section('.', -1);
-	if (extension == "mmpz" || extension == "xptz")
+	if (extension == ProjectContainer::Extension)
+	{
+		if (!writeContainer(outfile)) { return WriteResult::WriteFailed; }
+	}
+	else if (extension == "mmpz" || extension == "xptz")
 	{
 		QString xml;
 		QTextStream ts( &xml );
@@ -415,29 +511,76 @@ bool DataFile::writeFile(const QString& filename, bool withResources)
 		write( ts );
 	}
 
-	if (!outfile.commit())
+	if (keepBackup && QFile::exists(fullName))
 	{
-		showError(SongEditor::tr("Could not write file"),
-			SongEditor::tr("An unknown error has occurred and the file could not be saved."));
-		return false;
+		// copy instead of moving the current file away, so it stays in place
+		// until the new version replaces it
+		const QString fullNameBak = fullName + ".bak";
+		QFile::remove(fullNameBak);
+		QFile::copy(fullName, fullNameBak);
 	}
 
-	if (ConfigManager::inst()->value("app", "disablebackup").toInt())
-	{
-		// remove current file
-		QFile::remove(fullName);
+	return outfile.commit() ? WriteResult::Ok : WriteResult::WriteFailed;
+}
+
+
+
+
+bool DataFile::writeContainer(QIODevice& device)
+{
+	// Move base64 encoded data out of the XML into raw blob sections. The
+	// original attributes are restored afterwards, so this DataFile stays
+	// usable.
+	auto blobs = std::vector<QByteArray>{};
+	auto replaced = std::vector<std::tuple<QDomElement, QString, QString>>{};
+	for (const auto& [tagName, attributes] : ELEMENTS_WITH_EMBEDDED_DATA)
+	{
+		const QDomNodeList list = elementsByTagName(tagName);
+		for (int i = 0; !list.item(i).isNull(); ++i)
+		{
+			QDomElement el = list.item(i).toElement();
+			for (const auto& attribute : attributes)
+			{
+				const QString value = el.attribute(attribute);
+				if (value.isEmpty()) { continue; }
+
+				const auto data = embeddedData(value);
+				blobs.push_back(data ? *data : QByteArray::fromBase64(value.toLatin1()));
+				el.setAttribute(attribute, BlobReferencePrefix + QString::number(blobs.size() - 1));
+				replaced.emplace_back(el, attribute, value);
+			}
+		}
 	}
-	else
+
+	QString xml;
+	QTextStream ts(&xml);
+	write(ts);
+	const bool success = ProjectContainer::write(device, xml.toUtf8(), blobs);
+
+	for (auto& [el, attribute, value] : replaced)
 	{
-		// remove old backup file
-		QFile::remove(fullNameBak);
-		// move current file to backup file
-		QFile::rename(fullName, fullNameBak);
+		el.setAttribute(attribute, value);
 	}
-	// move temporary file to current file
-	QFile::rename(fullNameTemp, fullName);
 
-	return true;
+	return success;
+}
+
+
+
+
+std::optional<QByteArray> DataFile::embeddedData(const QString& attributeValue)
+{
+	if (!attributeValue.startsWith(BlobReferencePrefix)) { return std::nullopt; }
+
+	auto& registry = blobRegistry();
+	const auto guard = std::lock_guard{registry.mutex};
+	const auto it = registry.blobs.constFind(attributeValue);
+	if (it == registry.blobs.constEnd())
+	{
+		qWarning() << "DataFile: reference to unknown embedded data" << attributeValue;
+		return QByteArray{};
+	}
+	return *it;
 }
 
 
@@ -2208,6 +2351,63 @@ void DataFile::loadData( const QByteArray & _data, const QString & _sourceFile )
 }
 
 
+void DataFile::loadContainer(QIODevice& device, const QString& sourceFile)
+{
+	auto contents = ProjectContainer::read(device);
+	if (!contents)
+	{
+		using gui::SongEditor;
+
+		qWarning() << "Invalid project container" << sourceFile;
+		if (gui::getGUI() != nullptr)
+		{
+			QMessageBox::critical(nullptr,
+				SongEditor::tr("Error in file"),
+				SongEditor::tr("The file %1 seems to contain "
+						"errors and therefore can't be "
+						"loaded.").arg(sourceFile));
+		}
+		return;
+	}
+
+	loadData(contents->xml, sourceFile);
+	if (contents->blobs.empty()) { return; }
+
+	// Register the blobs for as long as this document lives and let the
+	// references in the document point to them
+	m_embeddedBlobs = std::make_shared<EmbeddedBlobs>();
+	QString filePrefix;
+	{
+		auto& registry = blobRegistry();
+		const auto guard = std::lock_guard{registry.mutex};
+		filePrefix = BlobReferencePrefix + QString::number(registry.nextSerial++) + "/";
+		for (std::size_t i = 0; i < contents->blobs.size(); ++i)
+		{
+			const QString key = filePrefix + QString::number(i);
+			registry.blobs.insert(key, std::move(contents->blobs[i]));
+			m_embeddedBlobs->keys.append(key);
+		}
+	}
+
+	for (const auto& [tagName, attributes] : ELEMENTS_WITH_EMBEDDED_DATA)
+	{
+		const QDomNodeList list = elementsByTagName(tagName);
+		for (int i = 0; !list.item(i).isNull(); ++i)
+		{
+			QDomElement el = list.item(i).toElement();
+			for (const auto& attribute : attributes)
+			{
+				const QString value = el.attribute(attribute);
+				if (value.startsWith(BlobReferencePrefix))
+				{
+					el.setAttribute(attribute, filePrefix + value.mid(BlobReferencePrefix.size()));
+				}
+			}
+		}
+	}
+}
+
+
 void findIds(const QDomElement& elem, QList<jo_id_t>& idList)
 {
 	if(elem.hasAttribute("id"))
@@ -117,10 +117,22 @@ bool Effect::processAudioBuffer(AudioBuffer& inOut)
 		return false;
 	}
 
-	const auto status = processImpl(inOut.interleavedBuffer().asSampleFrames().data(), inOut.frames());
+	ProcessStatus status;
+	if (usesPlanarBuffers())
+	{
+		status = processPlanarImpl(PlanarBufferView<float, 2>{inOut.groupBuffers(0).data(), inOut.frames()});
+
+		// The temporary interleaved buffer is only brought up to date if an interleaved effect follows
+		inOut.invalidateInterleavedBuffer();
+	}
+	else
+	{
+		inOut.syncInterleavedBuffer();
+		status = processImpl(inOut.interleavedBuffer().asSampleFrames().data(), inOut.frames());
 
-	// Copy interleaved plugin output to planar
-	toPlanar(inOut.interleavedBuffer(), inOut.groupBuffers(0));
+		// Copy interleaved plugin output to planar
+		inOut.syncFromInterleavedBuffer();
+	}
 
 	const auto sanitized = Engine::audioEngine()->sanitizationEnabled() ? inOut.sanitize(0b11) : false;
 	m_corrupted.store(sanitized, std::memory_order_relaxed);
@@ -26,6 +26,7 @@
 #include "EffectChain.h"
 
 #include <QDomElement>
+#include <algorithm>
 #include <cassert>
 
 #include "AudioBuffer.h"
@@ -191,6 +192,9 @@ bool EffectChain::processAudioBuffer(AudioBuffer& buffer)
 		return false;
 	}
 
+	// The planar buffers may have been written to since the chain last ran
+	buffer.invalidateInterleavedBuffer();
+
 	bool moreEffects = false;
 	for (Effect* effect : m_effects)
 	{
@@ -203,6 +207,14 @@ bool EffectChain::processAudioBuffer(AudioBuffer& buffer)
 
 
 
+bool EffectChain::isCorrupted() const
+{
+	return std::ranges::any_of(m_effects, [](const Effect* effect) { return effect->isCorrupted(); });
+}
+
+
+
+
 void EffectChain::clear()
 {
 	emit aboutToClear();
@@ -29,6 +29,8 @@
 #include "Engine.h"
 #include "AudioEngine.h"
 
+#include <utility>
+
 namespace lmms
 {
 
@@ -43,6 +45,7 @@ InstrumentPlayHandle::InstrumentPlayHandle(Instrument * instrument, InstrumentTr
 void InstrumentPlayHandle::play(SampleFrame* working_buffer)
 {
 	InstrumentTrack * instrumentTrack = m_instrument->instrumentTrack();
+	if (instrumentTrack->isRenderingSuspended()) { return; }
 
 	// ensure that all our nph's have been processed first
 	auto nphv = NotePlayHandle::nphsOfInstrumentTrack(instrumentTrack, true);
@@ -62,11 +65,37 @@ void InstrumentPlayHandle::play(SampleFrame* working_buffer)
 	}
 	while (nphsLeft);
 
+	if (m_instrument->startPlay())
+	{
+		// the instrument renders elsewhere; AudioEngine collects the result
+		// through finishPlay() once the other jobs of this stage are done
+		m_pendingBuffer = working_buffer;
+		return;
+	}
+
 	m_instrument->play(working_buffer);
+	processOutput(working_buffer);
+}
 
+void InstrumentPlayHandle::queueJobs(std::vector<ThreadableJob*>& jobs)
+{
+	if (m_pendingBuffer) { m_instrument->queueJobs(jobs); }
+}
+
+void InstrumentPlayHandle::finishPlay()
+{
+	if (!m_pendingBuffer) { return; }
+
+	const auto buffer = std::exchange(m_pendingBuffer, nullptr);
+	m_instrument->finishPlay(buffer);
+	processOutput(buffer);
+}
+
+void InstrumentPlayHandle::processOutput(SampleFrame* working_buffer)
+{
 	// Process the audio buffer that the instrument has just worked on...
 	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
-	instrumentTrack->processAudioBuffer(working_buffer, frames, nullptr);
+	m_instrument->instrumentTrack()->processAudioBuffer(working_buffer, frames, nullptr);
 }
 
 bool InstrumentPlayHandle::isFromTrack(const Track* track) const
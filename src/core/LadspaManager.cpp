@@ -32,11 +32,14 @@
 #include <QRegularExpression>
 
 #include <cmath>
+#include <mutex>
 
 #include "ConfigManager.h"
 #include "LadspaManager.h"
 #include "PluginFactory.h"
+#include "PluginMetadataCache.h"
 #include "lmms_constants.h"
+#include "lmmsversion.h"
 
 
 namespace lmms
@@ -64,6 +67,10 @@ LadspaManager::LadspaManager()
 	ladspaDirectories.push_back( "/Library/Audio/Plug-Ins/LADSPA" );
 #endif
 
+	// Libraries are only loaded when their metadata is not known yet, or
+	// when one of their plugins is actually used
+	PluginMetadataCache cache( "ladspa", LMMS_VERSION );
+
 	for (const auto& ladspaDirectory : ladspaDirectories)
 	{
 		// Skip empty entries as QDir will interpret it as the working directory
@@ -91,16 +98,23 @@ LadspaManager::LadspaManager()
 				continue;
 			}
 
+			if( const auto cached = cache.find( f.absoluteFilePath(), f ) )
+			{
+				for( const auto& plugin : cached->toList() )
+				{
+					addPlugin( f, plugin.toMap(), nullptr );
+				}
+				continue;
+			}
+
 			QLibrary plugin_lib( f.absoluteFilePath() );
 
 			if( plugin_lib.load() == true )
 			{
 				auto descriptorFunction = (LADSPA_Descriptor_Function)plugin_lib.resolve("ladspa_descriptor");
-				if( descriptorFunction != nullptr )
-				{
-					addPlugins( descriptorFunction,
-							f.fileName() );
-				}
+				cache.insert( f.absoluteFilePath(), f, descriptorFunction != nullptr
+					? addPlugins( descriptorFunction, f )
+					: QVariantList{} );
 			}
 			else
 			{
@@ -108,7 +122,8 @@ LadspaManager::LadspaManager()
 			}
 		}
 	}
-	
+	cache.save();
+
 	l_ladspa_key_t keys = m_ladspaManagerMap.keys();
 	for (const auto& key : keys)
 	{
@@ -142,45 +157,89 @@ LadspaManagerDescription * LadspaManager::getDescription(
 
 
 
-void LadspaManager::addPlugins(
+QVariantList LadspaManager::addPlugins(
 		LADSPA_Descriptor_Function _descriptor_func,
-						const QString & _file )
+						const QFileInfo & _file )
 {
+	QVariantList metadata;
 	for (long pluginIndex = 0; const auto descriptor = _descriptor_func(pluginIndex); ++pluginIndex)
 	{
-		ladspa_key_t key( _file, QString( descriptor->Label ) );
-		if( m_ladspaManagerMap.contains( key ) )
-		{
-			continue;
-		}
+		const QVariantMap plugin{
+			{ "index", static_cast<uint>( pluginIndex ) },
+			{ "label", QString( descriptor->Label ) },
+			{ "name", QString( descriptor->Name ) },
+			{ "maker", QString( descriptor->Maker ) },
+			{ "copyright", QString( descriptor->Copyright ) },
+			{ "properties", descriptor->Properties },
+			{ "inputs", getPluginInputs( descriptor ) },
+			{ "outputs", getPluginOutputs( descriptor ) }
+		};
+		metadata.append( plugin );
+		addPlugin( _file, plugin, _descriptor_func );
+	}
+	return metadata;
+}
 
-		auto plugIn = new LadspaManagerDescription;
-		plugIn->descriptorFunction = _descriptor_func;
-		plugIn->index = pluginIndex;
-		plugIn->inputChannels = getPluginInputs( descriptor );
-		plugIn->outputChannels = getPluginOutputs( descriptor );
 
-		if( plugIn->inputChannels == 0 && plugIn->outputChannels > 0 )
-		{
-			plugIn->type = LadspaPluginType::Source;
-		}
-		else if( plugIn->inputChannels > 0 &&
-				       plugIn->outputChannels > 0 )
-		{
-			plugIn->type = LadspaPluginType::Transfer;
-		}
-		else if( plugIn->inputChannels > 0 &&
-				       plugIn->outputChannels == 0 )
-		{
-			plugIn->type = LadspaPluginType::Sink;
-		}
-		else
-		{
-			plugIn->type = LadspaPluginType::Other;
-		}
 
-		m_ladspaManagerMap[key] = plugIn;
+
+void LadspaManager::addPlugin( const QFileInfo & _file,
+				const QVariantMap & _metadata,
+				LADSPA_Descriptor_Function _descriptor_func )
+{
+	ladspa_key_t key( _file.fileName(), _metadata["label"].toString() );
+	if( m_ladspaManagerMap.contains( key ) )
+	{
+		return;
+	}
+
+	auto plugIn = new LadspaManagerDescription;
+	plugIn->descriptorFunction = _descriptor_func;
+	plugIn->library = _file.absoluteFilePath();
+	plugIn->index = _metadata["index"].toUInt();
+	plugIn->inputChannels = _metadata["inputs"].toUInt();
+	plugIn->outputChannels = _metadata["outputs"].toUInt();
+	plugIn->name = _metadata["name"].toString();
+	plugIn->maker = _metadata["maker"].toString();
+	plugIn->copyright = _metadata["copyright"].toString();
+	plugIn->properties = _metadata["properties"].toInt();
+
+	if( plugIn->inputChannels == 0 && plugIn->outputChannels > 0 )
+	{
+		plugIn->type = LadspaPluginType::Source;
+	}
+	else if( plugIn->inputChannels > 0 &&
+			       plugIn->outputChannels > 0 )
+	{
+		plugIn->type = LadspaPluginType::Transfer;
+	}
+	else if( plugIn->inputChannels > 0 &&
+			       plugIn->outputChannels == 0 )
+	{
+		plugIn->type = LadspaPluginType::Sink;
+	}
+	else
+	{
+		plugIn->type = LadspaPluginType::Other;
+	}
+
+	m_ladspaManagerMap[key] = plugIn;
+}
+
+
+
+
+bool LadspaManager::loadLibrary( LadspaManagerDescription & _plugin )
+{
+	QLibrary plugin_lib( _plugin.library );
+	if( !plugin_lib.load() )
+	{
+		qWarning() << plugin_lib.errorString();
+		return false;
 	}
+
+	_plugin.descriptorFunction = (LADSPA_Descriptor_Function)plugin_lib.resolve("ladspa_descriptor");
+	return _plugin.descriptorFunction != nullptr;
 }
 
 
@@ -268,8 +327,7 @@ l_sortable_plugin_t LadspaManager::getSortedPlugins()
 
 QString LadspaManager::getLabel( const ladspa_key_t & _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? descriptor->Label : "" );
+	return( m_ladspaManagerMap.contains( _plugin ) ? _plugin.second : "" );
 }
 
 
@@ -278,8 +336,8 @@ QString LadspaManager::getLabel( const ladspa_key_t & _plugin )
 bool LadspaManager::hasRealTimeDependency(
 					const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_REALTIME( descriptor->Properties )
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? LADSPA_IS_REALTIME( description->properties )
 					   : false );
 }
 
@@ -288,8 +346,8 @@ bool LadspaManager::hasRealTimeDependency(
 
 bool LadspaManager::isInplaceBroken( const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_INPLACE_BROKEN( descriptor->Properties )
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? LADSPA_IS_INPLACE_BROKEN( description->properties )
 					   : false );
 }
 
@@ -299,8 +357,8 @@ bool LadspaManager::isInplaceBroken( const ladspa_key_t &  _plugin )
 bool LadspaManager::isRealTimeCapable(
 					const ladspa_key_t &  _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? LADSPA_IS_HARD_RT_CAPABLE( descriptor->Properties )
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? LADSPA_IS_HARD_RT_CAPABLE( description->properties )
 					   : false );
 }
 
@@ -309,8 +367,8 @@ bool LadspaManager::isRealTimeCapable(
 
 QString LadspaManager::getName( const ladspa_key_t & _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? descriptor->Name : "" );
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? description->name : "" );
 }
 
 
@@ -318,8 +376,8 @@ QString LadspaManager::getName( const ladspa_key_t & _plugin )
 
 QString LadspaManager::getMaker( const ladspa_key_t & _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? descriptor->Maker : "" );
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? description->maker : "" );
 }
 
 
@@ -327,8 +385,8 @@ QString LadspaManager::getMaker( const ladspa_key_t & _plugin )
 
 QString LadspaManager::getCopyright( const ladspa_key_t & _plugin )
 {
-	const LADSPA_Descriptor * descriptor = getDescriptor( _plugin );
-	return( descriptor ? descriptor->Copyright : "" );
+	const LadspaManagerDescription * description = getDescription( _plugin );
+	return( description ? description->copyright : "" );
 }
 
 
@@ -567,6 +625,11 @@ const LADSPA_Descriptor * LadspaManager::getDescriptor(const ladspa_key_t & _plu
 	{
 		auto const plugin = *it;
 
+		{
+			const auto guard = std::lock_guard{m_libraryMutex};
+			if (plugin->descriptorFunction == nullptr && !loadLibrary(*plugin)) { return nullptr; }
+		}
+
 		LADSPA_Descriptor_Function descriptorFunction = plugin->descriptorFunction;
 		const LADSPA_Descriptor* descriptor = descriptorFunction(plugin->index);
 
@@ -25,6 +25,7 @@
 #include "MixHelpers.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 
 #include "ValueBuffer.h"
@@ -58,6 +59,39 @@ inline void run(SampleFrame* dst, const sample_t* srcLeft, const sample_t* srcRi
 	}
 }
 
+/*! \brief Add all channels of src to dst, multiplied by coeff(frame) */
+template<typename COEFF>
+inline void addPlanar(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, const COEFF& coeff)
+{
+	assert(dst.channels() == src.channels());
+	assert(dst.frames() == src.frames());
+
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
+	{
+		auto* dstPtr = dst.bufferPtr(channel);
+		const auto* srcPtr = src.bufferPtr(channel);
+		for (f_cnt_t frame = 0; frame < dst.frames(); ++frame)
+		{
+			dstPtr[frame] += srcPtr[frame] * coeff(frame);
+		}
+	}
+}
+
+/*! \brief Add the stereo channels of src to the interleaved dst, multiplied by coeff(frame) */
+template<typename COEFF>
+inline void addPlanarToInterleaved(SampleFrame* dst, PlanarBufferView<const sample_t> src, const COEFF& coeff)
+{
+	assert(src.channels() == 2);
+
+	const auto* left = src.bufferPtr(0);
+	const auto* right = src.bufferPtr(1);
+	for (f_cnt_t frame = 0; frame < src.frames(); ++frame)
+	{
+		dst[frame][0] += left[frame] * coeff(frame);
+		dst[frame][1] += right[frame] * coeff(frame);
+	}
+}
+
 } // namespace
 
 bool isSilent(const SampleFrame* src, int frames)
@@ -103,6 +137,57 @@ void add(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src)
 }
 
 
+void add(PlanarBufferView<sample_t> dst, const SampleFrame* src)
+{
+	assert(dst.channels() == 2);
+
+	auto* left = dst.bufferPtr(0);
+	auto* right = dst.bufferPtr(1);
+	for (f_cnt_t frame = 0; frame < dst.frames(); ++frame)
+	{
+		left[frame] += src[frame][0];
+		right[frame] += src[frame][1];
+	}
+}
+
+
+void addMultiplied(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc)
+{
+	addPlanar(dst, src, [coeffSrc](f_cnt_t) { return coeffSrc; });
+}
+
+
+void addMultiplied(SampleFrame* dst, PlanarBufferView<const sample_t> src, float coeffSrc)
+{
+	addPlanarToInterleaved(dst, src, [coeffSrc](f_cnt_t) { return coeffSrc; });
+}
+
+
+void addMultipliedByBuffer(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc,
+	ValueBuffer* coeffSrcBuf)
+{
+	const auto* values = coeffSrcBuf->values();
+	addPlanar(dst, src, [coeffSrc, values](f_cnt_t frame) { return coeffSrc * values[frame]; });
+}
+
+
+void addMultipliedByBuffer(SampleFrame* dst, PlanarBufferView<const sample_t> src, float coeffSrc,
+	ValueBuffer* coeffSrcBuf)
+{
+	const auto* values = coeffSrcBuf->values();
+	addPlanarToInterleaved(dst, src, [coeffSrc, values](f_cnt_t frame) { return coeffSrc * values[frame]; });
+}
+
+
+void addMultipliedByBuffers(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	ValueBuffer* coeffSrcBuf1, ValueBuffer* coeffSrcBuf2)
+{
+	const auto* values1 = coeffSrcBuf1->values();
+	const auto* values2 = coeffSrcBuf2->values();
+	addPlanar(dst, src, [values1, values2](f_cnt_t frame) { return values1[frame] * values2[frame]; });
+}
+
+
 struct AddMultipliedOp
 {
 	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
@@ -62,8 +62,6 @@ void MixerRoute::updateName()
 MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_fxChain( nullptr ),
 	m_stillRunning( false ),
-	m_peakLeft( 0.0f ),
-	m_peakRight( 0.0f ),
 	m_buffer(Engine::audioEngine()->framesPerPeriod()),
 	m_muteModel( false, _parent ),
 	m_soloModel( false, _parent ),
@@ -163,8 +161,6 @@ void MixerChannel::unmuteReceiverForSolo()
 
 void MixerChannel::doProcessing()
 {
-	const f_cnt_t fpp = Engine::audioEngine()->framesPerPeriod();
-
 	if( m_muted == false )
 	{
 		for( MixerRoute * senderRoute : m_receives )
@@ -175,36 +171,35 @@ void MixerChannel::doProcessing()
 
 			if (sender->m_buffer.hasAnySignal() || sender->m_stillRunning)
 			{
-				auto buffer = m_buffer.interleavedBuffer().asSampleFrames();
+				auto buffer = m_buffer.groupBuffers(0);
 
 				// figure out if we're getting sample-exact input
 				ValueBuffer * sendBuf = sendModel->valueBuffer();
 				ValueBuffer * volBuf = sender->m_volumeModel.valueBuffer();
 
 				// mix it's output with this one's output
-				auto ch_buf = sender->m_buffer.interleavedBuffer().asSampleFrames();
+				auto ch_buf = sender->m_buffer.groupBuffers(0);
 
 				// use sample-exact mixing if sample-exact values are available
 				if( ! volBuf && ! sendBuf ) // neither volume nor send has sample-exact data...
 				{
 					const float v = sender->m_volumeModel.value() * sendModel->value();
-					MixHelpers::addMultiplied(buffer.data(), ch_buf.data(), v, fpp);
+					MixHelpers::addMultiplied(buffer, ch_buf, v);
 				}
 				else if( volBuf && sendBuf ) // both volume and send have sample-exact data
 				{
-					MixHelpers::addMultipliedByBuffers(buffer.data(), ch_buf.data(), volBuf, sendBuf, fpp);
+					MixHelpers::addMultipliedByBuffers(buffer, ch_buf, volBuf, sendBuf);
 				}
 				else if( volBuf ) // volume has sample-exact data but send does not
 				{
 					const float v = sendModel->value();
-					MixHelpers::addMultipliedByBuffer(buffer.data(), ch_buf.data(), v, volBuf, fpp);
+					MixHelpers::addMultipliedByBuffer(buffer, ch_buf, v, volBuf);
 				}
 				else // vice versa
 				{
 					const float v = sender->m_volumeModel.value();
-					MixHelpers::addMultipliedByBuffer(buffer.data(), ch_buf.data(), v, sendBuf, fpp);
+					MixHelpers::addMultipliedByBuffer(buffer, ch_buf, v, sendBuf);
 				}
-				toPlanar(m_buffer.interleavedBuffer(), m_buffer.groupBuffers(0));
 				m_buffer.mixSilenceFlags(sender->m_buffer);
 			}
 		}
@@ -214,13 +209,16 @@ void MixerChannel::doProcessing()
 
 		m_stillRunning = m_fxChain.processAudioBuffer(m_buffer);
 
-		const auto peakSamples = SampleFrame{m_buffer.absPeakValue(0), m_buffer.absPeakValue(1)};
-		m_peakLeft = std::max(m_peakLeft, peakSamples[0] * v);
-		m_peakRight = std::max(m_peakRight, peakSamples[1] * v);
+		for (ch_cnt_t ch = 0; ch < 2; ++ch)
+		{
+			m_levels.peak[ch] = m_buffer.absPeakValue(ch) * v;
+			m_levels.rms[ch] = m_buffer.rmsValue(ch) * v;
+		}
+		m_levels.corrupted = m_fxChain.isCorrupted();
 	}
 	else
 	{
-		m_peakLeft = m_peakRight = 0.0f;
+		m_levels = {};
 	}
 
 	// increment dependency counter of all receivers
@@ -260,6 +258,14 @@ Mixer::~Mixer()
 int Mixer::createChannel()
 {
 	const int index = m_mixerChannels.size();
+
+	auto& telemetry = Engine::audioEngine()->telemetry();
+	if (telemetry.channelCapacity() <= static_cast<std::size_t>(index))
+	{
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		telemetry.reserveChannels(index + 1);
+	}
+
 	// create new channel
 	m_mixerChannels.push_back( new MixerChannel( index, this ) );
 
@@ -646,10 +652,6 @@ void Mixer::mixToChannel(const AudioBuffer& buffer, mix_ch_t dest)
 	{
 		channel->m_lock.lock();
 		MixHelpers::add(channel->m_buffer.groupBuffers(0), buffer.groupBuffers(0));
-
-		// Copy the planar buffer to the temporary interleaved buffer so they stay in sync
-		toInterleaved(channel->m_buffer.groupBuffers(0), channel->m_buffer.interleavedBuffer());
-
 		channel->m_buffer.mixSilenceFlags(buffer);
 		channel->m_lock.unlock();
 	}
@@ -667,8 +669,6 @@ void Mixer::prepareMasterMix()
 
 void Mixer::masterMix( SampleFrame* _buf )
 {
-	const int fpp = Engine::audioEngine()->framesPerPeriod();
-
 	// add the channels that have no dependencies (no incoming senders, ie.
 	// no receives) to the jobqueue. The channels that have receives get
 	// added when their senders get processed, which is detected by
@@ -711,24 +711,20 @@ void Mixer::masterMix( SampleFrame* _buf )
 		AudioEngineWorkerThread::startAndWaitForJobs();
 	}
 
-	auto buffer = m_mixerChannels[0]->m_buffer.interleavedBuffer().asSampleFrames();
+	// The output is interleaved, so the master channel is converted on the way
+	auto buffer = m_mixerChannels[0]->m_buffer.groupBuffers(0);
 
 	// handle sample-exact data in master volume fader
 	ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
 
 	if( volBuf )
 	{
-		for( int f = 0; f < fpp; f++ )
-		{
-			buffer[f][0] *= volBuf->values()[f];
-			buffer[f][1] *= volBuf->values()[f];
-		}
+		MixHelpers::addMultipliedByBuffer(_buf, buffer, 1.0f, volBuf);
+	}
+	else
+	{
+		MixHelpers::addMultiplied(_buf, buffer, m_mixerChannels[0]->m_volumeModel.value());
 	}
-
-	const float v = volBuf
-		? 1.0f
-		: m_mixerChannels[0]->m_volumeModel.value();
-	MixHelpers::addMultiplied(_buf, buffer.data(), v, fpp);
 
 	// clear all channel buffers and
 	// reset channel process state
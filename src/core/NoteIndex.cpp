@@ -0,0 +1,108 @@
+/*
+ * NoteIndex.cpp - time x key index for finding the notes within a region
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NoteIndex.h"
+
+#include <algorithm>
+
+namespace lmms
+{
+
+
+void NoteIndex::rebuild(const NoteVector& notes, const EndFunction& end)
+{
+	clear();
+
+	for (std::size_t i = 0; i < notes.size(); ++i)
+	{
+		Note* note = notes[i];
+		const int key = note->key();
+		const tick_t start = note->pos();
+		const tick_t last = end(*note);
+		if (key < 0 || key >= NumKeys || last < start) { continue; }
+
+		auto& bucket = m_buckets[key];
+		bucket.entries.push_back(Entry{start, last, i, note});
+		bucket.maxLength = std::max(bucket.maxLength, last - start);
+		++m_size;
+	}
+
+	for (auto& bucket : m_buckets)
+	{
+		// Clips keep their notes sorted by position, so this is usually cheap
+		std::stable_sort(bucket.entries.begin(), bucket.entries.end(),
+			[](const Entry& a, const Entry& b) { return a.start < b.start; });
+	}
+}
+
+
+
+
+void NoteIndex::clear()
+{
+	for (auto& bucket : m_buckets)
+	{
+		bucket.entries.clear();
+		bucket.maxLength = 0;
+	}
+	m_size = 0;
+}
+
+
+
+
+void NoteIndex::query(tick_t start, tick_t end, int lowKey, int highKey, NoteVector& result) const
+{
+	result.clear();
+	m_hits.clear();
+
+	lowKey = std::max(lowKey, 0);
+	highKey = std::min(highKey, NumKeys - 1);
+	for (int key = lowKey; key <= highKey; ++key)
+	{
+		const auto& bucket = m_buckets[key];
+		if (bucket.entries.empty()) { continue; }
+
+		// No note of this bucket starting before this can reach the range
+		const tick_t earliest = start - bucket.maxLength;
+		auto it = std::lower_bound(bucket.entries.begin(), bucket.entries.end(), earliest,
+			[](const Entry& e, tick_t tick) { return e.start < tick; });
+		for (; it != bucket.entries.end() && it->start <= end; ++it)
+		{
+			if (it->end >= start) { m_hits.push_back(&*it); }
+		}
+	}
+
+	// Keep the order of the clip, so overlapping notes are drawn as before
+	std::sort(m_hits.begin(), m_hits.end(), [](const Entry* a, const Entry* b) { return a->order < b->order; });
+
+	result.reserve(m_hits.size());
+	for (const auto hit : m_hits)
+	{
+		result.push_back(hit->note);
+	}
+}
+
+
+} // namespace lmms
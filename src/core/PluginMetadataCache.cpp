@@ -0,0 +1,171 @@
+/*
+ * PluginMetadataCache.cpp - persistent cache of plugin scan results
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PluginMetadataCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QSaveFile>
+
+#include "ConfigManager.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr quint32 Magic = 0x4c504d43; // "LPMC"
+constexpr quint32 FormatVersion = 2;
+
+} // namespace
+
+
+
+
+PluginMetadataCache::PluginMetadataCache(const QString& name, const QString& context) :
+	m_fileName(ConfigManager::cacheDir("plugins") + name),
+	m_context(context)
+{
+	load();
+}
+
+
+
+
+std::optional<QVariant> PluginMetadataCache::find(const QString& key, const QFileInfo& file)
+{
+	return find(key, QList<QFileInfo>{file});
+}
+
+
+
+
+std::optional<QVariant> PluginMetadataCache::find(const QString& key, const QList<QFileInfo>& files)
+{
+	const auto it = m_entries.find(key);
+	if (it == m_entries.end() || it->stamp != stamp(files)) { return std::nullopt; }
+
+	it->used = true;
+	return it->metadata;
+}
+
+
+
+
+void PluginMetadataCache::insert(const QString& key, const QFileInfo& file, const QVariant& metadata)
+{
+	insert(key, QList<QFileInfo>{file}, metadata);
+}
+
+
+
+
+void PluginMetadataCache::insert(const QString& key, const QList<QFileInfo>& files, const QVariant& metadata)
+{
+	m_entries.insert(key, Entry{stamp(files), metadata, true});
+	m_modified = true;
+}
+
+
+
+
+QByteArray PluginMetadataCache::stamp(const QList<QFileInfo>& files)
+{
+	auto identity = QString{};
+	for (const auto& file : files)
+	{
+		identity += QString{"%1:%2:%3\n"}.arg(file.absoluteFilePath())
+			.arg(file.size()).arg(file.lastModified().toMSecsSinceEpoch());
+	}
+	return QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Sha1);
+}
+
+
+
+
+void PluginMetadataCache::save()
+{
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (it->used) { ++it; continue; }
+		it = m_entries.erase(it);
+		m_modified = true;
+	}
+
+	if (!m_modified) { return; }
+
+	auto file = QSaveFile{m_fileName};
+	if (!file.open(QIODevice::WriteOnly)) { return; }
+
+	auto stream = QDataStream{&file};
+	stream << Magic << FormatVersion << m_context << static_cast<quint32>(m_entries.size());
+	for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+	{
+		stream << it.key() << it->stamp << it->metadata;
+	}
+
+	if (stream.status() == QDataStream::Ok && file.commit()) { m_modified = false; }
+}
+
+
+
+
+void PluginMetadataCache::load()
+{
+	auto file = QFile{m_fileName};
+	if (!file.open(QIODevice::ReadOnly)) { return; }
+
+	auto stream = QDataStream{&file};
+	auto magic = quint32{0};
+	auto version = quint32{0};
+	auto context = QString{};
+	auto count = quint32{0};
+	stream >> magic >> version >> context >> count;
+	if (stream.status() != QDataStream::Ok || magic != Magic || version != FormatVersion || context != m_context)
+	{
+		// Outdated, rewrite it
+		m_modified = true;
+		return;
+	}
+
+	for (auto i = quint32{0}; i < count; ++i)
+	{
+		auto key = QString{};
+		auto entry = Entry{};
+		stream >> key >> entry.stamp >> entry.metadata;
+		if (stream.status() != QDataStream::Ok)
+		{
+			m_entries.clear();
+			m_modified = true;
+			return;
+		}
+		m_entries.insert(key, entry);
+	}
+}
+
+
+} // namespace lmms
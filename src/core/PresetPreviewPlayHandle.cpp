@@ -22,10 +22,13 @@
  *
  */
 
+#include <QDateTime>
 #include <QFileInfo>
+#include <QTimer>
 
 #include "PresetPreviewPlayHandle.h"
 #include "AudioEngine.h"
+#include "DataFile.h"
 #include "Engine.h"
 #include "Instrument.h"
 #include "InstrumentTrack.h"
@@ -33,7 +36,9 @@
 #include "ProjectJournal.h"
 #include "TrackContainer.h"
 
+#include <array>
 #include <atomic>
+#include <deque>
 
 namespace lmms
 {
@@ -43,14 +48,18 @@ class PreviewTrackContainer : public TrackContainer
 {
 public:
 	PreviewTrackContainer() :
-		m_previewInstrumentTrack( nullptr ),
 		m_previewNote( nullptr ),
 		m_dataMutex()
 	{
 		setJournalling( false );
-		m_previewInstrumentTrack = dynamic_cast<InstrumentTrack *>( Track::create( Track::Type::Instrument, this ) );
-		m_previewInstrumentTrack->setJournalling( false );
-		m_previewInstrumentTrack->setPreviewMode( true );
+		for (auto& slot : m_slots)
+		{
+			slot.track = dynamic_cast<InstrumentTrack*>(Track::create(Track::Type::Instrument, this));
+			slot.track->setJournalling(false);
+			slot.track->setPreviewMode(true);
+			// until it is swapped in by setActiveTrack()
+			slot.track->setRenderingSuspended(true);
+		}
 	}
 
 	~PreviewTrackContainer() override = default;
@@ -60,9 +69,47 @@ public:
 		return "previewtrackcontainer";
 	}
 
-	InstrumentTrack* previewInstrumentTrack()
+	//! Return a track with the given preset loaded. Presets are loaded into
+	//! a suspended track, so the audio engine is not held up by it
+	InstrumentTrack* loadPreset(const QString& presetFile, bool loadByPlugin, DataFile* dataFile)
+	{
+		Slot* slot = findSlot(presetFile, loadByPlugin);
+		if (slot == nullptr)
+		{
+			slot = &idleSlot();
+			load(*slot, presetFile, loadByPlugin, dataFile);
+		}
+		slot->lastUsed = ++m_useCount;
+		return slot->track;
+	}
+
+	//! Only the active track renders. Call within a change in model.
+	void setActiveTrack(InstrumentTrack* track)
+	{
+		m_activeTrack = track;
+		for (auto& slot : m_slots)
+		{
+			slot.track->setRenderingSuspended(slot.track != track);
+		}
+	}
+
+	void silenceAllTracks()
+	{
+		for (auto& slot : m_slots)
+		{
+			slot.track->silenceAllNotes();
+		}
+	}
+
+	void preload(const QString& presetFile, bool loadByPlugin)
+	{
+		m_preloads.emplace_back(presetFile, loadByPlugin);
+		if (m_preloads.size() == 1) { QTimer::singleShot(0, this, [this] { preloadNext(); }); }
+	}
+
+	void cancelPreloads()
 	{
-		return m_previewInstrumentTrack;
+		m_preloads.clear();
 	}
 
 	NotePlayHandle* previewNote()
@@ -102,7 +149,120 @@ public:
 
 
 private:
-	InstrumentTrack* m_previewInstrumentTrack;
+	struct Slot
+	{
+		InstrumentTrack* track = nullptr;
+		QString presetFile; //!< empty if nothing has been loaded yet
+		bool loadByPlugin = false;
+		QDateTime modified;
+		unsigned lastUsed = 0;
+	};
+
+	Slot* findSlot(const QString& presetFile, bool loadByPlugin)
+	{
+		const auto modified = QFileInfo(presetFile).lastModified();
+		for (auto& slot : m_slots)
+		{
+			if (slot.presetFile == presetFile && slot.loadByPlugin == loadByPlugin && slot.modified == modified)
+			{
+				return &slot;
+			}
+		}
+		return nullptr;
+	}
+
+	//! The least recently used slot that is not playing
+	Slot& idleSlot()
+	{
+		Slot* idle = nullptr;
+		for (auto& slot : m_slots)
+		{
+			if (slot.track == m_activeTrack) { continue; }
+			if (idle == nullptr || slot.lastUsed < idle->lastUsed) { idle = &slot; }
+		}
+		return *idle;
+	}
+
+	void load(Slot& slot, const QString& presetFile, bool loadByPlugin, DataFile* dataFile)
+	{
+		// A suspended track never calls into its instrument from the audio
+		// threads, so loading can't wait for a lock the render path holds
+		// (e.g. the synth mutex of Sf2Player or the plugin mutex of ZynAddSubFx)
+		Q_ASSERT(slot.track != m_activeTrack && slot.track->isRenderingSuspended());
+
+		lockData();
+
+		const bool j = Engine::projectJournal()->isJournalling();
+		Engine::projectJournal()->setJournalling( false );
+
+		InstrumentTrack* track = slot.track;
+		if (loadByPlugin)
+		{
+			Instrument* i = track->instrument();
+			const QString ext = QFileInfo(presetFile).suffix().toLower();
+			if (i == nullptr || !i->descriptor()->supportsFileType(ext))
+			{
+				const PluginFactory::PluginInfoAndKey& infoAndKey =
+					getPluginFactory()->pluginSupportingExtension(ext);
+				i = track->loadInstrument(infoAndKey.info.name(), &infoAndKey.key);
+			}
+			if (i != nullptr)
+			{
+				i->loadFile(presetFile);
+			}
+		}
+		else
+		{
+			track->loadTrackSpecificSettings(dataFile->content().firstChild().toElement());
+		}
+
+		// make sure, our preset-preview-track does not appear in any MIDI-
+		// devices list, so just disable receiving/sending MIDI-events at all
+		track->midiPort()->setMode( MidiPort::Mode::Disabled );
+
+		slot.presetFile = presetFile;
+		slot.loadByPlugin = loadByPlugin;
+		slot.modified = QFileInfo(presetFile).lastModified();
+
+		unlockData();
+		Engine::projectJournal()->setJournalling( j );
+	}
+
+	void preloadNext()
+	{
+		if (m_preloads.empty()) { return; }
+
+		const auto [presetFile, loadByPlugin] = m_preloads.front();
+		m_preloads.pop_front();
+
+		if (findSlot(presetFile, loadByPlugin) == nullptr)
+		{
+			Slot& slot = idleSlot();
+			if (loadByPlugin)
+			{
+				load(slot, presetFile, true, nullptr);
+			}
+			else
+			{
+				DataFile dataFile(presetFile);
+				if (dataFile.validate(QFileInfo(presetFile).suffix()))
+				{
+					load(slot, presetFile, false, &dataFile);
+				}
+			}
+			// keep it around until it is previewed
+			slot.lastUsed = ++m_useCount;
+		}
+
+		// one preset per event loop iteration, so the GUI stays responsive
+		if (!m_preloads.empty()) { QTimer::singleShot(0, this, [this] { preloadNext(); }); }
+	}
+
+	std::array<Slot, PresetPreviewPlayHandle::PoolSize> m_slots;
+	InstrumentTrack* m_activeTrack = nullptr;
+	unsigned m_useCount = 0;
+	std::deque<std::pair<QString, bool>> m_preloads;
+
 	std::atomic<NotePlayHandle*> m_previewNote;
 	QMutex m_dataMutex;
 
@@ -117,76 +277,47 @@ PreviewTrackContainer * PresetPreviewPlayHandle::s_previewTC;
 
 PresetPreviewPlayHandle::PresetPreviewPlayHandle( const QString & _preset_file, bool _load_by_plugin, DataFile *dataFile ) :
 	PlayHandle( Type::PresetPreviewHandle ),
+	m_previewTrack(nullptr),
 	m_previewNote(nullptr)
 {
 	setUsesBuffer( false );
 
-	s_previewTC->lockData();
-
-	Engine::audioEngine()->requestChangeInModel();
-	s_previewTC->setPreviewNote( nullptr );
-	s_previewTC->previewInstrumentTrack()->silenceAllNotes();
-	Engine::audioEngine()->doneChangeInModel();
+	// presets loaded ahead of time were meant for browsing from the previous preview on
+	s_previewTC->cancelPreloads();
 
-	const bool j = Engine::projectJournal()->isJournalling();
-	Engine::projectJournal()->setJournalling( false );
-
-	if( _load_by_plugin )
+	// load outside the change lock; the audio engine keeps playing the current
+	// preview while the preset goes into another track
+	bool dataFileCreated = false;
+	if( !_load_by_plugin && dataFile == nullptr )
 	{
-		Instrument * i = s_previewTC->previewInstrumentTrack()->instrument();
-		const QString ext = QFileInfo( _preset_file ).
-							suffix().toLower();
-		if( i == nullptr || !i->descriptor()->supportsFileType( ext ) )
-		{
-			const PluginFactory::PluginInfoAndKey& infoAndKey =
-				getPluginFactory()->pluginSupportingExtension(ext);
-			i = s_previewTC->previewInstrumentTrack()->
-				loadInstrument(infoAndKey.info.name(), &infoAndKey.key);
-		}
-		if( i != nullptr )
-		{
-			i->loadFile( _preset_file );
-		}
+		dataFile = new DataFile( _preset_file );
+		dataFileCreated = true;
 	}
-	else
+	m_previewTrack = s_previewTC->loadPreset(_preset_file, _load_by_plugin, dataFile);
+	if( dataFileCreated )
 	{
-		bool dataFileCreated = false;
-		if( dataFile == 0 )
-		{
-			dataFile = new DataFile( _preset_file );
-			dataFileCreated = true;
-		}
-
-		s_previewTC->previewInstrumentTrack()->loadTrackSpecificSettings(
-					dataFile->content().firstChild().toElement());
-
-		if( dataFileCreated )
-		{
-			delete dataFile;
-		}
+		delete dataFile;
 	}
-	dataFile = 0;
-	// make sure, our preset-preview-track does not appear in any MIDI-
-	// devices list, so just disable receiving/sending MIDI-events at all
-	s_previewTC->previewInstrumentTrack()->
-				midiPort()->setMode( MidiPort::Mode::Disabled );
 
+	// then swap the tracks
 	Engine::audioEngine()->requestChangeInModel();
+	s_previewTC->setPreviewNote( nullptr );
+	s_previewTC->silenceAllTracks();
+
 	// create note-play-handle for it
 	m_previewNote = NotePlayHandleManager::acquire(
-			s_previewTC->previewInstrumentTrack(), 0,
+			m_previewTrack, 0,
 			std::numeric_limits<f_cnt_t>::max() / 2,
 				Note( 0, 0, DefaultKey, 100 ) );
 
-	setAudioBusHandle(s_previewTC->previewInstrumentTrack()->audioBusHandle());
+	setAudioBusHandle(m_previewTrack->audioBusHandle());
 
+	s_previewTC->setActiveTrack(m_previewTrack);
 	s_previewTC->setPreviewNote( m_previewNote );
 
 	Engine::audioEngine()->addPlayHandle( m_previewNote );
 
 	Engine::audioEngine()->doneChangeInModel();
-	s_previewTC->unlockData();
-	Engine::projectJournal()->setJournalling( j );
 }
 
 
@@ -225,7 +356,7 @@ bool PresetPreviewPlayHandle::isFinished() const
 
 bool PresetPreviewPlayHandle::isFromTrack( const Track * _track ) const
 {
-	return s_previewTC && s_previewTC->previewInstrumentTrack() == _track;
+	return s_previewTC && m_previewTrack == _track;
 }
 
 
@@ -242,6 +373,17 @@ void PresetPreviewPlayHandle::init()
 
 
 
+void PresetPreviewPlayHandle::preload(const QString& presetFile, bool loadByPlugin)
+{
+	if (s_previewTC)
+	{
+		s_previewTC->preload(presetFile, loadByPlugin);
+	}
+}
+
+
+
+
 void PresetPreviewPlayHandle::cleanup()
 {
 	delete s_previewTC;
@@ -0,0 +1,306 @@
+/*
+ * ProjectContainer.cpp - binary project container with a compressed XML part
+ *                        and raw sections for embedded binary data
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ProjectContainer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <QDataStream>
+#include <QDebug>
+#include <QIODevice>
+
+#include "lmmsconfig.h"
+
+#ifdef LMMS_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr auto Magic = std::array<char, 8>{'L', 'M', 'M', 'S', 'P', 'R', 'J', 'X'};
+constexpr quint32 FormatVersion = 1;
+
+enum class SectionType : quint32
+{
+	End = 0,
+	Xml = 1,
+	Blob = 2
+};
+
+constexpr quint32 SectionFlagZstd = 1 << 0;
+
+//! Trades a slightly larger file for fast saving
+constexpr int CompressionLevel = 3;
+
+constexpr qint64 ChunkSize = 1 << 16;
+
+struct SectionHeader
+{
+	SectionType type = SectionType::End;
+	quint32 flags = 0;
+	quint64 storedSize = 0;
+	quint64 rawSize = 0;
+};
+
+bool writeSection(QDataStream& stream, const SectionHeader& header, const QByteArray& payload)
+{
+	stream << static_cast<quint32>(header.type) << header.flags << header.storedSize << header.rawSize;
+	const auto written = stream.writeRawData(payload.constData(), payload.size());
+	return written == payload.size() && stream.status() == QDataStream::Ok;
+}
+
+std::optional<SectionHeader> readSectionHeader(QDataStream& stream)
+{
+	auto type = quint32{0};
+	auto header = SectionHeader{};
+	stream >> type >> header.flags >> header.storedSize >> header.rawSize;
+	if (stream.status() != QDataStream::Ok) { return std::nullopt; }
+
+	header.type = static_cast<SectionType>(type);
+	return header;
+}
+
+std::optional<QByteArray> readStored(QIODevice& device, const SectionHeader& header)
+{
+	auto data = QByteArray{};
+	if (header.storedSize > static_cast<quint64>(std::numeric_limits<int>::max())) { return std::nullopt; }
+
+	data.resize(static_cast<int>(header.storedSize));
+	if (device.read(data.data(), data.size()) != data.size()) { return std::nullopt; }
+	return data;
+}
+
+#ifdef LMMS_HAVE_ZSTD
+//! Decompress the section payload while reading it, without holding the
+//! compressed data in memory
+std::optional<QByteArray> readZstd(QIODevice& device, const SectionHeader& header)
+{
+	if (header.rawSize > static_cast<quint64>(std::numeric_limits<int>::max())) { return std::nullopt; }
+
+	const auto context = std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)>{ZSTD_createDCtx(), &ZSTD_freeDCtx};
+	if (!context) { return std::nullopt; }
+
+	auto result = QByteArray{};
+	result.resize(static_cast<int>(header.rawSize));
+	auto output = ZSTD_outBuffer{result.data(), static_cast<std::size_t>(result.size()), 0};
+
+	auto chunk = QByteArray{};
+	auto remaining = static_cast<qint64>(header.storedSize);
+	while (remaining > 0)
+	{
+		chunk.resize(static_cast<int>(std::min(remaining, ChunkSize)));
+		if (device.read(chunk.data(), chunk.size()) != chunk.size()) { return std::nullopt; }
+		remaining -= chunk.size();
+
+		auto input = ZSTD_inBuffer{chunk.constData(), static_cast<std::size_t>(chunk.size()), 0};
+		while (input.pos < input.size)
+		{
+			const auto ret = ZSTD_decompressStream(context.get(), &output, &input);
+			if (ZSTD_isError(ret))
+			{
+				qWarning() << "ProjectContainer: decompression failed:" << ZSTD_getErrorName(ret);
+				return std::nullopt;
+			}
+			if (output.pos == output.size && input.pos < input.size) { return std::nullopt; }
+		}
+	}
+
+	if (output.pos != output.size) { return std::nullopt; }
+	return result;
+}
+#endif
+
+std::optional<QByteArray> readSectionPayload(QIODevice& device, const SectionHeader& header)
+{
+	if (header.flags & SectionFlagZstd)
+	{
+#ifdef LMMS_HAVE_ZSTD
+		return readZstd(device, header);
+#else
+		qWarning() << "ProjectContainer: this file is zstd-compressed, but LMMS was built without zstd support";
+		return std::nullopt;
+#endif
+	}
+
+	return readStored(device, header);
+}
+
+bool readPreamble(QDataStream& stream)
+{
+	auto magic = std::array<char, Magic.size()>{};
+	if (stream.readRawData(magic.data(), magic.size()) != static_cast<int>(magic.size()) || magic != Magic)
+	{
+		return false;
+	}
+
+	auto version = quint32{0};
+	stream >> version;
+	if (stream.status() != QDataStream::Ok || version > FormatVersion)
+	{
+		qWarning() << "ProjectContainer: unsupported container version" << version;
+		return false;
+	}
+	return true;
+}
+
+void setupStream(QDataStream& stream)
+{
+	stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+} // namespace
+
+
+
+
+bool ProjectContainer::isContainer(QIODevice& device)
+{
+	const auto head = device.peek(Magic.size());
+	return head.size() == static_cast<int>(Magic.size())
+		&& std::memcmp(head.constData(), Magic.data(), Magic.size()) == 0;
+}
+
+
+
+
+bool ProjectContainer::write(QIODevice& device, const QByteArray& xml, const std::vector<QByteArray>& blobs)
+{
+	auto stream = QDataStream{&device};
+	setupStream(stream);
+
+	stream.writeRawData(Magic.data(), Magic.size());
+	stream << FormatVersion;
+
+	auto xmlHeader = SectionHeader{SectionType::Xml, 0, static_cast<quint64>(xml.size()),
+		static_cast<quint64>(xml.size())};
+#ifdef LMMS_HAVE_ZSTD
+	auto compressed = QByteArray{};
+	compressed.resize(static_cast<int>(ZSTD_compressBound(xml.size())));
+	const auto compressedSize = ZSTD_compress(compressed.data(), compressed.size(),
+		xml.constData(), xml.size(), CompressionLevel);
+	if (ZSTD_isError(compressedSize))
+	{
+		qWarning() << "ProjectContainer: compression failed:" << ZSTD_getErrorName(compressedSize);
+		return false;
+	}
+	compressed.resize(static_cast<int>(compressedSize));
+
+	xmlHeader.flags |= SectionFlagZstd;
+	xmlHeader.storedSize = compressedSize;
+	if (!writeSection(stream, xmlHeader, compressed)) { return false; }
+#else
+	if (!writeSection(stream, xmlHeader, xml)) { return false; }
+#endif
+
+	for (const auto& blob : blobs)
+	{
+		const auto size = static_cast<quint64>(blob.size());
+		if (!writeSection(stream, SectionHeader{SectionType::Blob, 0, size, size}, blob)) { return false; }
+	}
+
+	return writeSection(stream, SectionHeader{}, QByteArray{});
+}
+
+
+
+
+std::optional<ProjectContainer::Contents> ProjectContainer::read(QIODevice& device)
+{
+	auto stream = QDataStream{&device};
+	setupStream(stream);
+	if (!readPreamble(stream)) { return std::nullopt; }
+
+	auto contents = Contents{};
+	auto haveXml = false;
+	while (true)
+	{
+		const auto header = readSectionHeader(stream);
+		if (!header) { return std::nullopt; }
+		if (header->type == SectionType::End) { break; }
+
+		auto payload = readSectionPayload(device, *header);
+		if (!payload) { return std::nullopt; }
+
+		switch (header->type)
+		{
+			case SectionType::Xml:
+				contents.xml = std::move(*payload);
+				haveXml = true;
+				break;
+			case SectionType::Blob:
+				contents.blobs.push_back(std::move(*payload));
+				break;
+			default:
+				// Unknown sections from newer minor revisions are skipped
+				break;
+		}
+	}
+
+	if (!haveXml) { return std::nullopt; }
+	return contents;
+}
+
+
+
+
+std::optional<QByteArray> ProjectContainer::readXml(QIODevice& device)
+{
+	auto stream = QDataStream{&device};
+	setupStream(stream);
+	if (!readPreamble(stream)) { return std::nullopt; }
+
+	while (true)
+	{
+		const auto header = readSectionHeader(stream);
+		if (!header || header->type == SectionType::End) { return std::nullopt; }
+		if (header->type == SectionType::Xml) { return readSectionPayload(device, *header); }
+
+		// Skip everything until the XML section
+		const auto size = static_cast<qint64>(header->storedSize);
+		if (device.skip(size) != size) { return std::nullopt; }
+	}
+}
+
+
+
+
+bool ProjectContainer::supportsCompression()
+{
+#ifdef LMMS_HAVE_ZSTD
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+} // namespace lmms
@@ -22,15 +22,21 @@
  *
  */
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <QDomElement>
 
 #include "ProjectJournal.h"
+#include "ConfigManager.h"
 #include "Engine.h"
 #include "JournallingObject.h"
 #include "lmms_math.h"
 #include "Song.h"
 #include "AutomationClip.h"
+#include "ThreadPool.h"
 
 namespace lmms
 {
@@ -39,12 +45,58 @@ namespace lmms
 //! and newly created IDs (have the bit set)
 static const int EO_ID_MSB = 1 << 23;
 
-const int ProjectJournal::MAX_UNDO_STATES = 100; // TODO: make this configurable in settings
+namespace
+{
+
+/*
+ * Consecutive states of an object usually differ in one small region (a
+ * moved note, a changed knob value), so a delta is stored as the length of
+ * the common prefix and suffix followed by the differing bytes of the older
+ * state: [u32 prefix][u32 suffix][middle]
+ */
+constexpr int DeltaHeaderSize = 2 * sizeof(quint32);
+
+QByteArray makeDelta(const QByteArray& newer, const QByteArray& older)
+{
+	const auto maxCommon = std::min(newer.size(), older.size());
+
+	auto prefix = 0;
+	while (prefix < maxCommon && newer[prefix] == older[prefix]) { ++prefix; }
+
+	auto suffix = 0;
+	while (suffix < maxCommon - prefix
+		&& newer[newer.size() - 1 - suffix] == older[older.size() - 1 - suffix]) { ++suffix; }
+
+	const auto header = std::array<quint32, 2>{static_cast<quint32>(prefix), static_cast<quint32>(suffix)};
+	auto delta = QByteArray{};
+	delta.reserve(DeltaHeaderSize + older.size() - prefix - suffix);
+	delta.append(reinterpret_cast<const char*>(header.data()), DeltaHeaderSize);
+	delta.append(older.constData() + prefix, older.size() - prefix - suffix);
+	return delta;
+}
+
+QByteArray applyDelta(const QByteArray& newer, const QByteArray& delta)
+{
+	auto header = std::array<quint32, 2>{};
+	std::memcpy(header.data(), delta.constData(), DeltaHeaderSize);
+	const auto prefix = static_cast<int>(header[0]);
+	const auto suffix = static_cast<int>(header[1]);
+
+	auto older = QByteArray{};
+	older.reserve(prefix + delta.size() - DeltaHeaderSize + suffix);
+	older.append(newer.constData(), prefix);
+	older.append(delta.constData() + DeltaHeaderSize, delta.size() - DeltaHeaderSize);
+	older.append(newer.constData() + newer.size() - suffix, suffix);
+	return older;
+}
+
+} // namespace
 
 ProjectJournal::ProjectJournal() :
 	m_joIDs(),
 	m_undoCheckPoints(),
 	m_redoCheckPoints(),
+	m_undoBytes( 0 ),
 	m_journalling( false )
 {
 }
@@ -54,25 +106,28 @@ ProjectJournal::ProjectJournal() :
 
 void ProjectJournal::undo()
 {
-	while( !m_undoCheckPoints.isEmpty() )
+	while( !m_undoCheckPoints.empty() )
 	{
-		CheckPoint c = m_undoCheckPoints.pop();
+		CheckPoint c = std::move( m_undoCheckPoints.back() );
+		m_undoCheckPoints.pop_back();
+		m_undoBytes -= c.data.size();
+		expandPredecessor( c.joID, c.data );
+
 		JournallingObject *jo = m_joIDs[c.joID];
 
 		if( jo )
 		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_redoCheckPoints.push( CheckPoint( c.joID, curState ) );
+			m_redoCheckPoints.push_back( CheckPoint{ c.joID, serializeState( jo ) } );
 
+			DataFile data( c.data );
 			bool prev = isJournalling();
 			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
+			jo->restoreState( data.content().firstChildElement() );
 			setJournalling( prev );
 			Engine::getSong()->setModified();
 
 			// loading AutomationClip connections correctly
-			if (!c.data.content().elementsByTagName("automationclip").isEmpty())
+			if (!data.content().elementsByTagName("automationclip").isEmpty())
 			{
 				AutomationClip::resolveAllIDs();
 			}
@@ -85,20 +140,20 @@ void ProjectJournal::undo()
 
 void ProjectJournal::redo()
 {
-	while( !m_redoCheckPoints.isEmpty() )
+	while( !m_redoCheckPoints.empty() )
 	{
-		CheckPoint c = m_redoCheckPoints.pop();
+		CheckPoint c = std::move( m_redoCheckPoints.back() );
+		m_redoCheckPoints.pop_back();
 		JournallingObject *jo = m_joIDs[c.joID];
 
 		if( jo )
 		{
-			DataFile curState( DataFile::Type::JournalData );
-			jo->saveState( curState, curState.content() );
-			m_undoCheckPoints.push( CheckPoint( c.joID, curState ) );
+			pushUndoCheckPoint( c.joID, serializeState( jo ) );
 
+			DataFile data( c.data );
 			bool prev = isJournalling();
 			setJournalling( false );
-			jo->restoreState( c.data.content().firstChildElement() );
+			jo->restoreState( data.content().firstChildElement() );
 			setJournalling( prev );
 			Engine::getSong()->setModified();
 			break;
@@ -108,12 +163,12 @@ void ProjectJournal::redo()
 
 bool ProjectJournal::canUndo() const
 {
-	return !m_undoCheckPoints.isEmpty();
+	return !m_undoCheckPoints.empty();
 }
 
 bool ProjectJournal::canRedo() const
 {
-	return !m_redoCheckPoints.isEmpty();
+	return !m_redoCheckPoints.empty();
 }
 
 
@@ -124,14 +179,119 @@ void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
 	{
 		m_redoCheckPoints.clear();
 
-		DataFile dataFile( DataFile::Type::JournalData );
-		jo->saveState( dataFile, dataFile.content() );
+		auto state = serializeState( jo );
 
-		m_undoCheckPoints.push( CheckPoint( jo->id(), dataFile ) );
-		if( m_undoCheckPoints.size() > MAX_UNDO_STATES )
+		// Nothing changed since the last checkpoint of this object (e.g. a
+		// knob was clicked but not moved), so undoing would be a no-op
+		if( !m_undoCheckPoints.empty() && m_undoCheckPoints.back().joID == jo->id()
+			&& m_undoCheckPoints.back().data == state )
 		{
-			m_undoCheckPoints.remove( 0, m_undoCheckPoints.size() - MAX_UNDO_STATES );
+			return;
 		}
+
+		pushUndoCheckPoint( jo->id(), std::move( state ) );
+	}
+}
+
+
+
+
+QByteArray ProjectJournal::serializeState( JournallingObject* jo )
+{
+	DataFile dataFile( DataFile::Type::JournalData );
+	jo->saveState( dataFile, dataFile.content() );
+	return dataFile.toByteArray( -1 );
+}
+
+
+
+
+std::size_t ProjectJournal::undoBudget()
+{
+	const auto megabytes = ConfigManager::inst()->value( "app", "undobudget",
+		QString::number( DEFAULT_UNDO_BUDGET_MB ) ).toInt();
+	return static_cast<std::size_t>( std::clamp( megabytes, MIN_UNDO_BUDGET_MB, MAX_UNDO_BUDGET_MB ) ) << 20;
+}
+
+
+
+
+void ProjectJournal::pushUndoCheckPoint( jo_id_t id, QByteArray state )
+{
+	collectDeltas();
+
+	// The previous checkpoint of this object only needs to keep what differs
+	// from the new one, which is worked out off the GUI thread
+	const auto previous = std::find_if( m_undoCheckPoints.rbegin(), m_undoCheckPoints.rend(),
+		[id]( const CheckPoint& c ) { return c.joID == id; } );
+	if( previous != m_undoCheckPoints.rend() && !previous->isDelta && !previous->pendingDelta.valid() )
+	{
+		previous->pendingDelta = ThreadPool::instance().enqueue(
+			[older = previous->data, newer = state] { return makeDelta( newer, older ); } ).share();
+	}
+
+	m_undoBytes += state.size();
+	m_undoCheckPoints.push_back( CheckPoint{ id, std::move( state ) } );
+	trimUndoHistory();
+}
+
+
+
+
+void ProjectJournal::collectDeltas()
+{
+	using namespace std::chrono_literals;
+	for( auto& c : m_undoCheckPoints )
+	{
+		if( !c.pendingDelta.valid() || c.pendingDelta.wait_for( 0s ) != std::future_status::ready )
+		{
+			continue;
+		}
+
+		const auto delta = c.pendingDelta.get();
+		c.pendingDelta = {};
+		if( delta.size() < c.data.size() )
+		{
+			m_undoBytes -= c.data.size() - delta.size();
+			c.data = delta;
+			c.isDelta = true;
+		}
+	}
+}
+
+
+
+
+void ProjectJournal::expandPredecessor( jo_id_t id, const QByteArray& newer )
+{
+	const auto previous = std::find_if( m_undoCheckPoints.rbegin(), m_undoCheckPoints.rend(),
+		[id]( const CheckPoint& c ) { return c.joID == id; } );
+	if( previous == m_undoCheckPoints.rend() ) { return; }
+
+	// A delta still being computed is simply dropped, the full state is
+	// still there
+	previous->pendingDelta = {};
+	if( previous->isDelta )
+	{
+		m_undoBytes -= previous->data.size();
+		previous->data = applyDelta( newer, previous->data );
+		previous->isDelta = false;
+		m_undoBytes += previous->data.size();
+	}
+}
+
+
+
+
+void ProjectJournal::trimUndoHistory()
+{
+	// Deltas only refer to newer checkpoints, so the oldest ones can always
+	// be dropped. The newest checkpoint is kept even if it exceeds the budget.
+	const auto budget = undoBudget();
+	while( m_undoBytes > budget && m_undoCheckPoints.size() > 1 )
+	{
+		m_undoBytes -= m_undoCheckPoints.front().data.size();
+		m_undoCheckPoints.pop_front();
 	}
 }
 
@@ -174,6 +334,7 @@ void ProjectJournal::clearJournal()
 {
 	m_undoCheckPoints.clear();
 	m_redoCheckPoints.clear();
+	m_undoBytes = 0;
 
 	for( JoIdMap::Iterator it = m_joIDs.begin(); it != m_joIDs.end(); )
 	{
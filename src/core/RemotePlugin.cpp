@@ -43,6 +43,9 @@
 #include <QDir>
 #include <QUuid>
 
+#include <algorithm>
+#include <utility>
+
 #ifndef SYNC_WITH_SHM_FIFO
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -181,6 +184,16 @@ RemotePlugin::RemotePlugin() :
 		Qt::DirectConnection );
 	connect( &m_process, SIGNAL(finished(int,QProcess::ExitStatus)),
 		&m_watcher, SLOT(quit()), Qt::DirectConnection );
+
+	// logging could block the audio thread, so drops are only counted there
+	connect( &m_midiDropReporter, &QTimer::timeout, this, [this]
+	{
+		if( const auto dropped = m_droppedMidiEvents.exchange( 0 ) )
+		{
+			qWarning( "Remote plugin MIDI ring is full, %zu events dropped", dropped );
+		}
+	} );
+	m_midiDropReporter.start( 1000 );
 }
 
 
@@ -328,15 +341,22 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 
 
 bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
+{
+	startProcessing( _in_buf );
+	return finishProcessing( _out_buf );
+}
+
+
+
+
+bool RemotePlugin::startProcessing( const SampleFrame* _in_buf )
 {
 	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
 
+	m_processingStarted = false;
+
 	if( m_failed || !isRunning() )
 	{
-		if( _out_buf != nullptr )
-		{
-			zeroSampleFrames(_out_buf, frames);
-		}
 		return false;
 	}
 
@@ -352,17 +372,18 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 			fetchAndProcessAllMessages();
 			unlock();
 		}
-		if( _out_buf != nullptr )
-		{
-			zeroSampleFrames(_out_buf, frames);
-		}
 		return false;
 	}
 
-	memset( m_audioBuffer.get(), 0, m_audioBufferSize );
-
 	ch_cnt_t inputs = std::min<ch_cnt_t>(m_inputCount, DEFAULT_CHANNELS);
 
+	// input channels that are about to be overwritten completely don't need
+	// to be cleared first
+	const bool fillsInputs = _in_buf != nullptr && inputs == m_inputCount
+		&& (m_splitChannels || inputs == DEFAULT_CHANNELS);
+	const std::size_t clearFrom = fillsInputs ? m_inputCount * frames * sizeof(float) : 0;
+	memset( reinterpret_cast<char*>(m_audioBuffer.get()) + clearFrom, 0, m_audioBufferSize - clearFrom );
+
 	if( _in_buf != nullptr && inputs > 0 )
 	{
 		if( m_splitChannels )
@@ -395,16 +416,67 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 	}
 
 	lock();
-	sendMessage( IdStartProcessing );
+	if (m_processChannel)
+	{
+		flushMidiOverflow();
+		m_processChannel.requestProcessing();
+	}
+	else
+	{
+		// Other threads may wait for messages between our calls and would
+		// swallow IdProcessingDone, so the message protocol has to complete
+		// the round trip while we hold the lock
+		sendMessage( IdStartProcessing );
+		if( m_failed )
+		{
+			unlock();
+			return false;
+		}
+		waitForMessage( IdProcessingDone );
+	}
+	unlock();
+
+	m_processingStarted = true;
+	return true;
+}
+
+
+
 
-	if( m_failed || _out_buf == nullptr || m_outputCount == 0 )
+bool RemotePlugin::finishProcessing( SampleFrame* _out_buf )
+{
+	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
+
+	if (!std::exchange(m_processingStarted, false))
 	{
-		unlock();
+		if( _out_buf != nullptr )
+		{
+			zeroSampleFrames(_out_buf, frames);
+		}
 		return false;
 	}
 
-	waitForMessage( IdProcessingDone );
-	unlock();
+	if (m_processChannel)
+	{
+		lock();
+		// always wait, so the next period can't touch the buffer while the
+		// client is still working on it
+		const bool done = waitForProcessChannel();
+		unlock();
+		if (!done)
+		{
+			if( _out_buf != nullptr )
+			{
+				zeroSampleFrames(_out_buf, frames);
+			}
+			return false;
+		}
+	}
+
+	if( _out_buf == nullptr || m_outputCount == 0 )
+	{
+		return false;
+	}
 
 	const ch_cnt_t outputs = std::min<ch_cnt_t>(m_outputCount,
 							DEFAULT_CHANNELS);
@@ -449,17 +521,107 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 void RemotePlugin::processMidiEvent( const MidiEvent & _e,
 							const f_cnt_t _offset )
 {
+	lock();
+	if (m_processChannel)
+	{
+		// the ring is drained right before the next period is processed, which is
+		// when the client would have applied the event anyway. Falling back to a
+		// message when it is full would let the event overtake the queued ones,
+		// e.g. a note-off its note-on, so it waits in the overflow queue instead,
+		// and so does everything after it.
+		const RemoteProcessChannel::MidiEntry entry{_e.type(), _e.channel(),
+			_e.param(0), _e.param(1), static_cast<std::int32_t>(_offset)};
+		flushMidiOverflow();
+		if (m_midiOverflowCount > 0 || m_pendingAllNotesOff != 0 || !m_processChannel.pushMidiEvent(entry))
+		{
+			queueMidiEvent(entry);
+		}
+		unlock();
+		return;
+	}
+
 	message m( IdMidiEvent );
 	m.addInt( _e.type() );
 	m.addInt( _e.channel() );
 	m.addInt( _e.param( 0 ) );
 	m.addInt( _e.param( 1 ) );
 	m.addInt( _offset );
-	lock();
 	sendMessage( m );
 	unlock();
 }
 
+
+
+
+void RemotePlugin::queueMidiEvent( const RemoteProcessChannel::MidiEntry& entry )
+{
+	// losing one of these would leave notes hanging in the remote plugin
+	const auto endsNotes = [](const RemoteProcessChannel::MidiEntry& e)
+	{
+		return e.type == MidiNoteOff || (e.type == MidiNoteOn && e.param1 == 0)
+			|| (e.type == MidiControlChange
+				&& (e.param0 == MidiControllerAllNotesOff || e.param0 == MidiControllerAllSoundOff));
+	};
+
+	const auto begin = m_midiOverflow.begin();
+	if (m_pendingAllNotesOff == 0)
+	{
+		if (m_midiOverflowCount == MidiOverflowSize && endsNotes(entry))
+		{
+			// make room by dropping the oldest event that is safe to lose
+			const auto end = begin + m_midiOverflowCount;
+			const auto victim = std::find_if_not(begin, end, endsNotes);
+			if (victim != end)
+			{
+				std::move(victim + 1, end, victim);
+				--m_midiOverflowCount;
+				++m_droppedMidiEvents;
+			}
+		}
+		if (m_midiOverflowCount < MidiOverflowSize)
+		{
+			m_midiOverflow[m_midiOverflowCount++] = entry;
+			return;
+		}
+	}
+
+	if (!endsNotes(entry))
+	{
+		++m_droppedMidiEvents;
+		return;
+	}
+
+	// an all-notes-off after the queue stops the note as well, along with
+	// whatever else plays on that channel
+	m_pendingAllNotesOff |= 1 << (entry.channel & (MidiChannelCount - 1));
+}
+
+
+
+
+void RemotePlugin::flushMidiOverflow()
+{
+	std::size_t flushed = 0;
+	while (flushed < m_midiOverflowCount && m_processChannel.pushMidiEvent(m_midiOverflow[flushed]))
+	{
+		++flushed;
+	}
+	std::move(m_midiOverflow.begin() + flushed, m_midiOverflow.begin() + m_midiOverflowCount, m_midiOverflow.begin());
+	m_midiOverflowCount -= flushed;
+	if (m_midiOverflowCount > 0) { return; }
+
+	for (int channel = 0; channel < MidiChannelCount && m_pendingAllNotesOff != 0; ++channel)
+	{
+		const auto bit = static_cast<std::uint16_t>(1 << channel);
+		if ((m_pendingAllNotesOff & bit) == 0) { continue; }
+		if (!m_processChannel.pushMidiEvent({MidiControlChange, channel, MidiControllerAllNotesOff, 0, 0})) { return; }
+		m_pendingAllNotesOff &= ~bit;
+	}
+}
+
+
+
+
 void RemotePlugin::showUI()
 {
 	lock();
@@ -497,6 +659,46 @@ void RemotePlugin::resizeSharedProcessingMemory()
 
 
 
+std::string RemotePlugin::createProcessChannel()
+{
+#ifdef LMMS_HAVE_REMOTE_PROCESS_CHANNEL
+	try
+	{
+		m_processChannel.create();
+		// whatever waited for the previous ring is meaningless to the new one
+		m_midiOverflowCount = 0;
+		m_pendingAllNotesOff = 0;
+		return m_processChannel.key();
+	}
+	catch (const std::runtime_error& error)
+	{
+		qWarning() << "Failed to create remote process channel:" << error.what();
+		m_processChannel.detach();
+	}
+#endif
+	return {};
+}
+
+
+
+
+bool RemotePlugin::waitForProcessChannel()
+{
+	using namespace std::chrono_literals;
+	// poll in slices so a crashed client can't stall the audio thread forever
+	while (!m_processChannel.waitForProcessingDone(100ms))
+	{
+		if (m_failed || !isRunning())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+
 void RemotePlugin::processFinished( int exitCode,
 					QProcess::ExitStatus exitStatus )
 {
@@ -562,6 +764,12 @@ bool RemotePlugin::processMessage( const message & _m )
 			resizeSharedProcessingMemory();
 			break;
 
+		case IdEnableProcessChannel:
+			reply = true;
+			reply_message.id = IdProcessChannelKey;
+			reply_message.addString(createProcessChannel());
+			break;
+
 		case IdDebugMessage:
 			fprintf( stderr, "RemotePlugin::DebugMessage: %s",
 						_m.getString( 0 ).c_str() );
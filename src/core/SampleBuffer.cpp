@@ -28,6 +28,7 @@
 #include <QMessageBox>
 #include <cstring>
 
+#include "DataFile.h"
 #include "GuiApplication.h"
 #include "PathUtil.h"
 #include "SampleDecoder.h"
@@ -106,7 +107,9 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromBase64(const QString& str,
 {
 	if (str.isEmpty()) { return SampleBuffer::emptyBuffer(); }
 
-	const auto bytes = QByteArray::fromBase64(str.toUtf8());
+	// Data loaded from a project container is referenced rather than inlined
+	const auto embedded = DataFile::embeddedData(str);
+	const auto bytes = embedded ? *embedded : QByteArray::fromBase64(str.toUtf8());
 
 	if (bytes.size() % sizeof(SampleFrame) != 0)
 	{
@@ -54,6 +54,7 @@
 #include "ProjectNotes.h"
 #include "Scale.h"
 #include "SongEditor.h"
+#include "ThreadPool.h"
 #include "PeakController.h"
 
 
@@ -140,6 +141,7 @@ Song::Song() :
 
 Song::~Song()
 {
+	waitForBackgroundSave();
 	m_playing = false;
 	delete m_globalAutomationTrack;
 }
@@ -454,7 +456,11 @@ void Song::processMetronome(size_t bufferOffset)
 
 void Song::setModified(bool value)
 {
-	if( !m_loadingProject && m_modified != value)
+	if (m_loadingProject) { return; }
+
+	// also counts saving and loading, as both change what is current
+	++m_modificationCount;
+	if (m_modified != value)
 	{
 		m_modified = value;
 		emit modified();
@@ -1213,10 +1219,65 @@ void Song::loadProject( const QString & fileName )
 
 // only save current song as filename and do nothing else
 bool Song::saveProjectFile(const QString & filename, bool withResources)
+{
+	DataFile dataFile( DataFile::Type::SongProject );
+	saveProject(dataFile);
+
+	return dataFile.writeFile(filename, withResources);
+}
+
+
+
+
+bool Song::saveProjectFileInBackground(const QString & filename)
+{
+	if (isSavingInBackground()) { return false; }
+
+	// Storing the project walks all models, so it has to happen here. Turning
+	// the document into text, compressing and writing it is the slow part and
+	// is left to the worker, which owns the document from then on.
+	auto dataFile = std::make_shared<DataFile>(DataFile::Type::SongProject);
+	saveProject(*dataFile);
+
+	const bool keepBackup = !ConfigManager::inst()->value("app", "disablebackup").toInt();
+	const unsigned modificationCount = m_modificationCount;
+	m_backgroundSave = ThreadPool::instance().enqueue([this, dataFile, filename, keepBackup, modificationCount]
+	{
+		const bool success = dataFile->writeFileQuietly(filename, keepBackup);
+		QMetaObject::invokeMethod(this, [this, filename, success, modificationCount]
+		{
+			emit backgroundSaveFinished(filename, success, modificationCount);
+		}, Qt::QueuedConnection);
+		return success;
+	});
+
+	return true;
+}
+
+
+
+
+bool Song::isSavingInBackground() const
+{
+	return m_backgroundSave.valid()
+		&& m_backgroundSave.wait_for(std::chrono::seconds{0}) != std::future_status::ready;
+}
+
+
+
+
+void Song::waitForBackgroundSave()
+{
+	if (m_backgroundSave.valid()) { m_backgroundSave.wait(); }
+}
+
+
+
+
+void Song::saveProject(DataFile & dataFile)
 {
 	using gui::getGUI;
 
-	DataFile dataFile( DataFile::Type::SongProject );
 	m_savingProject = true;
 
 	m_tempoModel.saveSettings( dataFile, dataFile.head(), "bpm" );
@@ -1242,8 +1303,6 @@ bool Song::saveProjectFile(const QString & filename, bool withResources)
 	saveKeymapStates(dataFile, dataFile.content());
 
 	m_savingProject = false;
-
-	return dataFile.writeFile(filename, withResources);
 }
 
 
@@ -161,6 +161,37 @@ void Lv2ControlBase::copyBuffersToLmms(SampleFrame* buf, f_cnt_t frames) const {
 
 
 
+bool Lv2ControlBase::supportsPlanarBuffers() const
+{
+	return std::all_of(m_procs.begin(), m_procs.end(),
+		[this](const auto& c) { return c->planarChannels() == m_channelsPerProc; });
+}
+
+
+
+
+bool Lv2ControlBase::inPlaceBroken() const
+{
+	// all procs run the same plugin
+	return m_procs.front()->inPlaceBroken();
+}
+
+
+
+
+void Lv2ControlBase::connectPlanarBuffers(float* const* in, float* const* out)
+{
+	unsigned firstChan = 0;
+	for (const auto& c : m_procs)
+	{
+		c->connectPlanarBuffers(in + firstChan, out + firstChan, m_channelsPerProc);
+		firstChan += m_channelsPerProc;
+	}
+}
+
+
+
+
 void Lv2ControlBase::run(f_cnt_t frames) {
 	for (const auto& c : m_procs) { c->run(frames); }
 }
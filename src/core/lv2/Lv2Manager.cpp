@@ -31,9 +31,12 @@
 #include <lilv/lilv.h>
 #include <lv2/buf-size/buf-size.h>
 #include <lv2/options/options.h>
+#include <lv2/state/state.h>
 #include <lv2/worker/worker.h>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QElapsedTimer>
+#include <QFileInfo>
 
 #include "AudioEngine.h"
 #include "ConfigManager.h"
@@ -42,12 +45,63 @@
 #include "Lv2ControlBase.h"
 #include "Lv2Options.h"
 #include "PluginIssue.h"
+#include "PluginMetadataCache.h"
+#include "lmmsversion.h"
 
 
 namespace lmms
 {
 
 
+namespace
+{
+
+//! Append the local file that @p uri points to, if any
+void appendFile(QList<QFileInfo>& files, const LilvNode* uri)
+{
+	if (!uri || !lilv_node_is_uri(uri)) { return; }
+
+	char* path = lilv_file_uri_parse(lilv_node_as_uri(uri), nullptr);
+	if (!path) { return; }
+
+	files.append(QFileInfo{QString::fromLocal8Bit(path)});
+	lilv_free(path);
+}
+
+//! The files a plugin's description and code are read from, i.e. all data
+//! files of its bundle (including manifest.ttl) and its library
+QList<QFileInfo> pluginFiles(LilvWorld* world, const LilvPlugin* plugin)
+{
+	auto files = QList<QFileInfo>{};
+	const LilvNodes* dataUris = lilv_plugin_get_data_uris(plugin);
+	LILV_FOREACH(nodes, itr, dataUris)
+	{
+		appendFile(files, lilv_nodes_get(dataUris, itr));
+	}
+
+	// lilv_plugin_get_library_uri() would parse the data files, which is what
+	// the cache avoids, but the binary is declared in the manifest anyway
+	const auto binaryPredicate = AutoLilvNode{lilv_new_uri(world, LV2_CORE__binary)};
+	const auto binary = AutoLilvNode{lilv_world_get(world, lilv_plugin_get_uri(plugin), binaryPredicate.get(), nullptr)};
+	appendFile(files, binary.get());
+	return files;
+}
+
+//! Identifies the host features, which decide whether a plugin can be loaded
+QString featuresHash(const std::set<std::string_view>& features)
+{
+	auto joined = QByteArray{};
+	for (const auto& feature : features)
+	{
+		joined.append(feature.data(), static_cast<int>(feature.size()));
+		joined.append('\n');
+	}
+	return QString::fromLatin1(QCryptographicHash::hash(joined, QCryptographicHash::Sha1).toHex());
+}
+
+} // namespace
+
+
 const std::set<std::string_view> Lv2Manager::unstablePlugins =
 {
 	// github.com/calf-studio-gear/calf, #278
@@ -178,6 +232,11 @@ Lv2Manager::Lv2Manager() :
 	m_supportedFeatureURIs.insert(LV2_URID__unmap);
 	m_supportedFeatureURIs.insert(LV2_OPTIONS__options);
 	m_supportedFeatureURIs.insert(LV2_WORKER__schedule);
+	// audio ports are never connected in place for such plugins
+	m_supportedFeatureURIs.insert(LV2_CORE__inPlaceBroken);
+	// default state is restored on the worker pool, see Lv2Proc::restoreDefaultState
+	m_supportedFeatureURIs.insert(LV2_STATE__loadDefaultState);
+	m_supportedFeatureURIs.insert(LV2_STATE__threadSafeRestore);
 	// min/max is always passed in the options
 	m_supportedFeatureURIs.insert(LV2_BUF_SIZE__boundedBlockLength);
 	// block length is only changed initially in AudioEngine CTOR
@@ -241,42 +300,70 @@ void Lv2Manager::initPlugins()
 	QElapsedTimer timer;
 	timer.start();
 
+	// Checking a plugin requires its data files to be parsed, which dominates
+	// the startup time with many plugins installed, so the results are cached
+	// until the plugin's bundle changes
+	PluginMetadataCache cache("lv2", QString{"%1/%2/%3/%4"}.arg(LMMS_VERSION)
+		.arg(Engine::audioEngine()->framesPerPeriod())
+		.arg(ConfigManager::enableBlockedPlugins())
+		.arg(featuresHash(m_supportedFeatureURIs)));
+
 	unsigned blocked = 0;
 	LILV_FOREACH(plugins, itr, plugins)
 	{
 		const LilvPlugin* curPlug = lilv_plugins_get(plugins, itr);
+		const char* pluginUri = lilv_node_as_uri(lilv_plugin_get_uri(curPlug));
+		const QList<QFileInfo> files = pluginFiles(m_world, curPlug);
 
-		std::vector<PluginIssue> issues;
-		Plugin::Type type = Lv2ControlBase::check(curPlug, issues);
-		std::sort(issues.begin(), issues.end());
-		auto last = std::unique(issues.begin(), issues.end());
-		issues.erase(last, issues.end());
-		if (m_debug && issues.size())
+		Plugin::Type type;
+		bool valid, isBlocked;
+		// In debug mode, the issues are needed for the output
+		if (const auto cached = m_debug ? std::nullopt : cache.find(pluginUri, files))
 		{
-			qDebug() << "Lv2 plugin"
-				<< qStringFromPluginNode(curPlug, lilv_plugin_get_name)
-				<< "(URI:"
-				<< lilv_node_as_uri(lilv_plugin_get_uri(curPlug))
-				<< ") can not be loaded:";
-			for (const PluginIssue& iss : issues) { qDebug() << "  - " << iss; }
+			const QVariantMap result = cached->toMap();
+			type = static_cast<Plugin::Type>(result["type"].toInt());
+			valid = result["valid"].toBool();
+			isBlocked = result["blocked"].toBool();
 		}
-
-		Lv2Info info(curPlug, type, issues.empty());
-
-		m_lv2InfoMap[lilv_node_as_uri(lilv_plugin_get_uri(curPlug))]
-			= std::move(info);
-		if(issues.empty()) { ++pluginsLoaded; }
 		else
 		{
-			if(std::any_of(issues.begin(), issues.end(),
+			std::vector<PluginIssue> issues;
+			type = Lv2ControlBase::check(curPlug, issues);
+			std::sort(issues.begin(), issues.end());
+			auto last = std::unique(issues.begin(), issues.end());
+			issues.erase(last, issues.end());
+			if (m_debug && issues.size())
+			{
+				qDebug() << "Lv2 plugin"
+					<< qStringFromPluginNode(curPlug, lilv_plugin_get_name)
+					<< "(URI:"
+					<< pluginUri
+					<< ") can not be loaded:";
+				for (const PluginIssue& iss : issues) { qDebug() << "  - " << iss; }
+			}
+
+			valid = issues.empty();
+			isBlocked = std::any_of(issues.begin(), issues.end(),
 				[](const PluginIssue& iss) {
-				return iss.type() == PluginIssueType::Blocked; }))
+				return iss.type() == PluginIssueType::Blocked; });
+			if (!files.empty())
 			{
-				++blocked;
+				cache.insert(pluginUri, files, QVariantMap{
+					{"type", static_cast<int>(type)},
+					{"valid", valid},
+					{"blocked", isBlocked}
+				});
 			}
 		}
+
+		Lv2Info info(curPlug, type, valid);
+
+		m_lv2InfoMap[pluginUri] = std::move(info);
+		if(valid) { ++pluginsLoaded; }
+		else if(isBlocked) { ++blocked; }
 		++pluginCount;
 	}
+	cache.save();
 
 	qDebug() << "Lv2 plugin SUMMARY:"
 		<< pluginsLoaded << "of" << pluginCount << " loaded in"
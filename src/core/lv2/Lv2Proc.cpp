@@ -30,6 +30,7 @@
 #include <lv2/midi/midi.h>
 #include <lv2/atom/atom.h>
 #include <lv2/resize-port/resize-port.h>
+#include <lv2/state/state.h>
 #include <lv2/worker/worker.h>
 #include <QDebug>
 #include <QtGlobal>
@@ -197,6 +198,7 @@ Lv2Proc::Lv2Proc(const LilvPlugin *plugin, Model* parent) :
 	m_midiInputBuf(m_maxMidiInputEvents),
 	m_midiInputReader(m_midiInputBuf)
 {
+	m_inPlaceBroken = lilv_plugin_has_feature(m_plugin, uri(LV2_CORE__inPlaceBroken).get());
 	createPorts();
 	initPlugin();
 }
@@ -328,6 +330,7 @@ void Lv2Proc::copyBuffersFromCore(const SampleFrame* buf,
 									unsigned firstChan, unsigned num,
 									f_cnt_t frames)
 {
+	connectPortBuffers();
 	inPorts().m_left->copyBuffersFromCore(buf, firstChan, frames);
 	if (num > 1)
 	{
@@ -370,6 +373,9 @@ void Lv2Proc::copyBuffersToCore(SampleFrame* buf,
 
 void Lv2Proc::run(f_cnt_t frames)
 {
+	// the plugin is still restoring its default state, see restoreDefaultState()
+	if (m_runBlockedByRestore.load(std::memory_order_acquire)) { return; }
+
 	if (m_worker)
 	{
 		// Process any worker replies
@@ -388,6 +394,52 @@ void Lv2Proc::run(f_cnt_t frames)
 
 
 
+unsigned Lv2Proc::planarChannels() const
+{
+	const unsigned ins = !!m_inPorts.m_left + !!m_inPorts.m_right;
+	const unsigned outs = !!m_outPorts.m_left + !!m_outPorts.m_right;
+	return ins == outs ? ins : 0;
+}
+
+
+
+
+void Lv2Proc::connectPlanarBuffers(float* const* in, float* const* out, unsigned num)
+{
+	Q_ASSERT(num == planarChannels());
+	Q_ASSERT(!m_inPlaceBroken || in != out);
+
+	const auto connect = [this](const Lv2Ports::Audio* port, float* location)
+	{
+		lilv_instance_connect_port(m_instance, lilv_port_get_index(m_plugin, port->m_port), location);
+	};
+	connect(m_inPorts.m_left, in[0]);
+	connect(m_outPorts.m_left, out[0]);
+	if (num > 1)
+	{
+		connect(m_inPorts.m_right, in[1]);
+		connect(m_outPorts.m_right, out[1]);
+	}
+	m_planarConnected = true;
+}
+
+
+
+
+void Lv2Proc::connectPortBuffers()
+{
+	if (!m_planarConnected) { return; }
+
+	for (Lv2Ports::Audio* port : {m_inPorts.m_left, m_inPorts.m_right, m_outPorts.m_left, m_outPorts.m_right})
+	{
+		if (port) { connectPort(lilv_port_get_index(m_plugin, port->m_port)); }
+	}
+	m_planarConnected = false;
+}
+
+
+
+
 // in case there will be a PR which removes this callback and instead adds a
 // `ringbuffer_t<MidiEvent + time info>` to `class Instrument`, this
 // function (and the ringbuffer and its reader in `Lv2Proc`) will simply vanish
@@ -466,7 +518,9 @@ void Lv2Proc::initPlugin()
 		{
 			connectPort(portNum);
 		}
+		m_planarConnected = false;
 		lilv_instance_activate(m_instance);
+		restoreDefaultState();
 	}
 	else
 	{
@@ -484,6 +538,11 @@ void Lv2Proc::initPlugin()
 
 void Lv2Proc::shutdownPlugin()
 {
+	if (m_stateRestore.valid()) { m_stateRestore.wait(); }
+	m_stateRestore = {};
+	// the worker must not call into the instance anymore once it is freed
+	m_worker.reset();
+
 	lilv_instance_deactivate(m_instance);
 	lilv_instance_free(m_instance);
 	m_instance = nullptr;
@@ -555,6 +614,46 @@ void Lv2Proc::initPluginSpecificFeatures()
 
 
 
+void Lv2Proc::restoreDefaultState()
+{
+	if (!lilv_plugin_has_feature(m_plugin, uri(LV2_STATE__loadDefaultState).get())) { return; }
+
+	// Reading from the world is not thread safe, but cheap. Only the restore
+	// itself, which may load samples or other files, is moved to the pool, so
+	// that many instruments of a project can load their state in parallel.
+	Lv2Manager* mgr = Engine::getLv2Manager();
+	LilvState* state = lilv_state_new_from_world(mgr->world(), mgr->uridMap().mapFeature(),
+		lilv_plugin_get_uri(m_plugin));
+	if (!state) { return; }
+
+	// loadDefaultState requires the default state to be loaded before the
+	// first run(). threadSafeRestore only allows restore() to overlap run(),
+	// so run() is skipped until the restore has finished either way.
+	m_runBlockedByRestore = true;
+
+	m_stateRestore = Lv2WorkerPool::instance().post([this, state, mgr]
+	{
+		const LV2_Feature map{LV2_URID__map, mgr->uridMap().mapFeature()};
+		const LV2_Feature unmap{LV2_URID__unmap, mgr->uridMap().unmapFeature()};
+		const LV2_Feature* features[] = {&map, &unmap, nullptr};
+
+		// port values are not restored: the models already hold the port
+		// defaults, and they must only be changed from the main thread
+		m_workLock.wait();
+		lilv_state_restore(state, m_instance, nullptr, nullptr, 0, features);
+		m_workLock.post();
+		lilv_state_free(state);
+
+		m_runBlockedByRestore.store(false, std::memory_order_release);
+	});
+
+	// rendering from the command line must not skip the first periods
+	if (Engine::audioEngine()->renderOnly()) { m_stateRestore.wait(); }
+}
+
+
+
+
 void Lv2Proc::loadFileInternal(const QString &file)
 {
 	(void)file;
@@ -24,6 +24,7 @@
 
 #include "Lv2Worker.h"
 
+#include <algorithm>
 #include <cassert>
 
 #ifdef LMMS_HAVE_LV2
@@ -47,6 +48,107 @@ staticWorkerRespond(LV2_Worker_Respond_Handle handle,
 
 
 
+Lv2WorkerPool& Lv2WorkerPool::instance()
+{
+	static Lv2WorkerPool pool;
+	return pool;
+}
+
+
+
+
+Lv2WorkerPool::Lv2WorkerPool() :
+	m_scheduled(MaxScheduled),
+	m_sem(0)
+{
+	const unsigned threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, MaxThreads);
+	m_threads.reserve(threadCount);
+	for (unsigned i = 0; i < threadCount; ++i)
+	{
+		m_threads.emplace_back(&Lv2WorkerPool::threadFunc, this);
+	}
+}
+
+
+
+
+Lv2WorkerPool::~Lv2WorkerPool()
+{
+	m_exit = true;
+	for (std::size_t i = 0; i < m_threads.size(); ++i) { m_sem.post(); }
+	for (auto& thread : m_threads) { thread.join(); }
+}
+
+
+
+
+void Lv2WorkerPool::schedule(Lv2Worker* worker)
+{
+	m_scheduled.push(worker);
+	m_sem.post();
+}
+
+
+
+
+std::future<void> Lv2WorkerPool::post(std::function<void()> task)
+{
+	// std::function must be copyable, std::packaged_task is not
+	auto job = std::make_shared<std::packaged_task<void()>>(std::move(task));
+	auto result = job->get_future();
+	{
+		const auto lock = std::lock_guard{m_queueMutex};
+		m_queue.emplace_back([job] { (*job)(); });
+	}
+	m_sem.post();
+	return result;
+}
+
+
+
+
+void Lv2WorkerPool::collectScheduled()
+{
+	// the list is a stack, so inserting each element at the same position
+	// restores the order in which the workers were scheduled
+	const auto pos = m_queue.size();
+	auto* element = m_scheduled.popList();
+	while (element)
+	{
+		Lv2Worker* worker = element->value;
+		m_queue.emplace(m_queue.begin() + pos, [worker] { worker->workOnNextRequest(); });
+		auto* next = element->next;
+		m_scheduled.free(element);
+		element = next;
+	}
+}
+
+
+
+
+void Lv2WorkerPool::threadFunc()
+{
+	while (true)
+	{
+		m_sem.wait();
+		if (m_exit) { break; }
+
+		std::function<void()> task;
+		{
+			const auto lock = std::lock_guard{m_queueMutex};
+			collectScheduled();
+			// every post of m_sem follows one insertion, so this should not happen
+			if (m_queue.empty()) { continue; }
+			task = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+		task();
+	}
+}
+
+
+
+
 std::size_t Lv2Worker::bufferSize() const
 {
 	// ardour uses this fixed size for ALSA:
@@ -60,12 +162,12 @@ std::size_t Lv2Worker::bufferSize() const
 
 Lv2Worker::Lv2Worker(Semaphore* commonWorkLock, bool threaded) :
 	m_threaded(threaded),
+	m_request(bufferSize()),
 	m_response(bufferSize()),
 	m_requests(bufferSize()),
 	m_responses(bufferSize()),
 	m_requestsReader(m_requests),
 	m_responsesReader(m_responses),
-	m_sem(0),
 	m_workLock(commonWorkLock)
 {
 	m_scheduleFeature.handle = static_cast<LV2_Worker_Schedule_Handle>(this);
@@ -76,7 +178,8 @@ Lv2Worker::Lv2Worker(Semaphore* commonWorkLock, bool threaded) :
 			return worker->scheduleWork(size, data);
 		};
 
-	if (threaded) { m_thread = std::thread(&Lv2Worker::workerFunc, this); }
+	// start the pool now rather than from the audio thread
+	if (threaded) { Lv2WorkerPool::instance(); }
 
 	m_requests.mlock();
 	m_responses.mlock();
@@ -105,10 +208,12 @@ void Lv2Worker::setInterface(const LV2_Worker_Interface* newInterface)
 
 Lv2Worker::~Lv2Worker()
 {
+	// a pool thread may still hold a turn of this worker; let it drop the
+	// remaining requests and wait until the pool does not reference us anymore
 	m_exit = true;
-	if(m_threaded) {
-		m_sem.post();
-		m_thread.join();
+	while (m_pendingRequests.load(std::memory_order_acquire) != 0)
+	{
+		std::this_thread::yield();
 	}
 }
 
@@ -143,28 +248,32 @@ LV2_Worker_Status Lv2Worker::respond(uint32_t size, const void* data)
 
 
 // Let the worker receive work from the audio thread and "work" on it
-void Lv2Worker::workerFunc()
+void Lv2Worker::workOnNextRequest()
 {
-	std::vector<char> buf;
 	uint32_t size;
-	while (true) {
-		m_sem.wait();
-		if (m_exit) { break; }
-
-		const std::size_t readSpace = m_requestsReader.read_space();
-		if (readSpace <= sizeof(size)) { continue; } // (should not happen)
-
-		m_requestsReader.read(sizeof(size)).copy((char*)&size, sizeof(size));
-		assert(size <= readSpace - sizeof(size));
-		if(size > buf.size()) { buf.resize(size); }
-		if(size) { m_requestsReader.read(size).copy(buf.data(), size); }
-
+	const std::size_t readSpace = m_requestsReader.read_space();
+	assert(readSpace > sizeof(size));
+	m_requestsReader.read(sizeof(size)).copy((char*)&size, sizeof(size));
+	assert(size <= readSpace - sizeof(size));
+	if(size > m_request.size()) { m_request.resize(size); }
+	if(size) { m_requestsReader.read(size).copy(m_request.data(), size); }
+
+	if (!m_exit)
+	{
 		assert(m_handle);
 		assert(m_interface);
 		m_workLock->wait();
-		m_interface->work(m_handle, staticWorkerRespond, this, size, buf.data());
+		m_interface->work(m_handle, staticWorkerRespond, this, size, m_request.data());
 		m_workLock->post();
 	}
+
+	// queue the next turn while requests are left, so that no two pool threads
+	// ever work for the same instance. If this was the last request, the
+	// worker may be destroyed right after the decrement.
+	if (m_pendingRequests.fetch_sub(1, std::memory_order_acq_rel) > 1)
+	{
+		Lv2WorkerPool::instance().schedule(this);
+	}
 }
 
 
@@ -181,10 +290,13 @@ LV2_Worker_Status Lv2Worker::scheduleWork(uint32_t size, const void *data)
 		}
 		else
 		{
-			// Schedule a request to be executed by the worker thread
+			// Schedule a request to be executed by the worker pool
 			m_requests.write((const char*)&size, sizeof(size));
 			if(size && data) { m_requests.write((const char*)data, size); }
-			m_sem.post();
+			if (m_pendingRequests.fetch_add(1, std::memory_order_acq_rel) == 0)
+			{
+				Lv2WorkerPool::instance().schedule(this);
+			}
 		}
 	}
 	else
@@ -67,6 +67,7 @@
 #include "MainWindow.h"
 #include "MixHelpers.h"
 #include "OutputSettings.h"
+#include "ProjectContainer.h"
 #include "ProjectRenderer.h"
 #include "RenderManager.h"
 #include "Song.h"
@@ -162,7 +163,10 @@ void printHelp()
 		"Actions:\n"
 		"  <no action> [options...] [<project>]  Start LMMS in normal GUI mode\n"
 		"  dump <in>                             Dump XML of compressed file <in>\n"
-		"  compress <in>                         Compress file <in>\n"
+		"  compress <in> [out]                   Compress file <in> and write it to\n"
+		"                                        standard out, or save it as <out>.\n"
+		"                                        Use the .mmpx extension for <out> to\n"
+		"                                        write a binary project container\n"
 		"  render <project> [options...]         Render given project file\n"
 		"  rendertracks <project> [options...]   Render each track to a different file\n"
 		"  upgrade <in> [out]                    Upgrade file <in> and save as <out>\n"
@@ -447,6 +451,13 @@ int main( int argc, char * * argv )
 
 			QFile f( QString::fromLocal8Bit( argv[i] ) );
 			f.open( QIODevice::ReadOnly );
+			if (ProjectContainer::isContainer(f))
+			{
+				const auto xml = ProjectContainer::readXml(f);
+				if (!xml) { return usageError("Invalid project container"); }
+				printf("%s\n", xml->constData());
+				return EXIT_SUCCESS;
+			}
 			QString d = qUncompress( f.readAll() );
 			printf( "%s\n", d.toUtf8().constData() );
 
@@ -461,6 +472,12 @@ int main( int argc, char * * argv )
 				return noInputFileError();
 			}
 
+			if (argc > i + 1) // output file specified
+			{
+				DataFile dataFile(QString::fromLocal8Bit(argv[i]));
+				return dataFile.writeFile(QString::fromLocal8Bit(argv[i + 1])) ? EXIT_SUCCESS : EXIT_FAILURE;
+			}
+
 			QFile f( QString::fromLocal8Bit( argv[i] ) );
 			f.open( QIODevice::ReadOnly );
 			QByteArray d = qCompress( f.readAll() ) ;
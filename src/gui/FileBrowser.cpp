@@ -48,6 +48,7 @@
 #include "DeprecationHelper.h"
 #include "Engine.h"
 #include "FileBrowser.h"
+#include "FileIndex.h"
 #include "FileRevealer.h"
 #include "GuiApplication.h"
 #include "ImportFilter.h"
@@ -143,10 +144,12 @@ FileBrowser::FileBrowser(Type type, const QString& directories, const QString& f
 	{
 		connect(ConfigManager::inst(), &ConfigManager::favoritesChanged, [this] {
 			m_directories = ConfigManager::inst()->favoriteItems().join("*");
+			indexDirectories();
 			reloadTree();
 		});
 	}
 
+	indexDirectories();
 	reloadTree();
 	show();
 }
@@ -243,6 +246,17 @@ void FileBrowser::onSearch(const QString& filter)
 	m_searchJob.search(searchTask);
 }
 
+void FileBrowser::indexDirectories()
+{
+	// The home and root browsers cover far too much to keep an index of, so they keep walking the filesystem
+	if (m_type != Type::Favorites && m_userDir.isEmpty() && m_factoryDir.isEmpty()) { return; }
+
+	for (const auto& directory : m_directories.split('*', Qt::SkipEmptyParts))
+	{
+		if (QFileInfo{directory}.isDir()) { FileIndex::instance().addRoot(directory); }
+	}
+}
+
 void FileBrowser::onSearchMatch(const QString& path)
 {
 	const auto fileInfo = QFileInfo{path};
@@ -852,6 +866,32 @@ void FileBrowserTreeWidget::previewFileItem(FileItem* file)
 		}
 		else { m_previewPlayHandle = nullptr; }
 	}
+
+	if (m_previewPlayHandle != nullptr && m_previewPlayHandle->type() == PlayHandle::Type::PresetPreviewHandle)
+	{
+		preloadPresetsBelow(file);
+	}
+}
+
+
+
+
+void FileBrowserTreeWidget::preloadPresetsBelow(FileItem* file)
+{
+	auto item = static_cast<QTreeWidgetItem*>(file);
+	for (std::size_t preloaded = 1; preloaded < PresetPreviewPlayHandle::PoolSize;)
+	{
+		// Stop at the end of the directory
+		auto next = dynamic_cast<FileItem*>(item = itemBelow(item));
+		if (next == nullptr) { break; }
+
+		if (next->type() != FileItem::FileType::VstPlugin && next->isTrack())
+		{
+			const bool isPlugin = next->handling() == FileItem::FileHandling::LoadByPlugin;
+			PresetPreviewPlayHandle::preload(next->fullName(), isPlugin);
+			++preloaded;
+		}
+	}
 }
 
 
@@ -1239,7 +1279,7 @@ void FileItem::determineFileType()
 	m_handling = FileHandling::NotSupported;
 
 	const QString ext = extension();
-	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" )
+	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" || ext == "mmpx" )
 	{
 		m_type = FileType::Project;
 		m_handling = FileHandling::LoadAsProject;
@@ -1323,7 +1363,7 @@ QString FileItem::extension(const QString & file )
 
 QString FileItem::defaultFilters()
 {
-	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz"};
+	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz", "*.mmpx"};
 	const auto presetFilters = QStringList{"*.xpf", "*.xml", "*.xiz", "*.lv2"};
 	const auto soundFontFilters = QStringList{"*.sf2", "*.sf3"};
 	const auto patchFilters = QStringList{"*.pat"};
@@ -0,0 +1,582 @@
+/*
+ * FileIndex.cpp - persistent index of the directories shown in the file browser
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "FileIndex.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <sndfile.h>
+
+#include "ConfigManager.h"
+#include "ThreadPool.h"
+
+namespace lmms::gui {
+namespace {
+constexpr auto IndexFileVersion = quint32{1};
+
+//! Stay well below the usual limits of inotify and friends.
+constexpr auto MaxWatchedDirectories = 4096;
+
+auto indexFilePath() -> QString
+{
+	return ConfigManager::cacheDir("filebrowser") + "index.dat";
+}
+
+auto childPath(const QString& directory, const QString& name) -> QString
+{
+	return directory.endsWith('/') ? directory + name : directory + '/' + name;
+}
+
+auto isWithin(const QString& path, const QString& directory) -> bool
+{
+	if (!path.startsWith(directory)) { return false; }
+	return path.size() == directory.size() || directory.endsWith('/') || path[directory.size()] == '/';
+}
+
+auto isAudioFile(const QFileInfo& info) -> bool
+{
+	static const auto s_suffixes = QStringList{"wav", "ogg", "flac", "aif", "aiff", "au", "voc", "mp3"};
+	return s_suffixes.contains(info.suffix(), Qt::CaseInsensitive);
+}
+} // namespace
+
+FileIndex::FileIndex(QObject* parent)
+	: QObject(parent)
+{
+	connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this,
+		[this](const QString& path) { queueJob(Job{.type = Job::Type::Rescan, .path = path}); });
+
+	queueJob(Job{.type = Job::Type::Load, .path = {}});
+}
+
+FileIndex::~FileIndex()
+{
+	m_stop = true;
+	if (m_worker.valid()) { m_worker.wait(); }
+}
+
+auto FileIndex::instance() -> FileIndex&
+{
+	// Owned by the application, so the index stops before the thread pool does
+	static auto s_index = new FileIndex{QCoreApplication::instance()};
+	return *s_index;
+}
+
+void FileIndex::addRoot(const QString& root)
+{
+	queueJob(Job{.type = Job::Type::AddRoot, .path = QDir::cleanPath(root)});
+}
+
+auto FileIndex::isIndexed(const QString& path) const -> bool
+{
+	const auto lock = std::shared_lock{m_rootsMutex};
+	const auto root = rootOf(QDir::cleanPath(path));
+	if (!root) { return false; }
+
+	// Without a watch on every directory, the index can miss changes, so searches must walk the tree instead
+	const auto& indexed = m_roots.at(*root);
+	return indexed.complete && indexed.watched;
+}
+
+void FileIndex::search(const QString& path, const QStringList& tokens, bool includeHidden,
+	const std::function<bool(const QString&, const Entry&)>& fn) const
+{
+	auto foldedTokens = QStringList{};
+	for (const auto& token : tokens)
+	{
+		foldedTokens.push_back(token.toCaseFolded());
+	}
+
+	const auto searchPath = QDir::cleanPath(path);
+	const auto lock = std::shared_lock{m_rootsMutex};
+	const auto rootPath = rootOf(searchPath);
+	if (!rootPath) { return; }
+
+	const auto& directories = m_roots.at(*rootPath).directories;
+	for (auto it = directories.begin(); it != directories.end(); ++it)
+	{
+		const auto& directory = it.value();
+		if (!isWithin(it.key(), searchPath) || directory.entries.empty()) { continue; }
+		if (directory.isHidden && !includeHidden) { continue; }
+
+		// Find the names with the first token in all names at once, then check the others
+		const auto names = QStringView{directory.names};
+		const auto first = foldedTokens.isEmpty() ? QString{} : foldedTokens.front();
+		for (auto position = names.indexOf(first); position != -1;)
+		{
+			const auto index = static_cast<std::size_t>(
+				std::upper_bound(directory.nameOffsets.begin(), directory.nameOffsets.end(), position)
+				- directory.nameOffsets.begin() - 1);
+			const auto& entry = directory.entries[index];
+			const auto name = names.mid(directory.nameOffsets[index], entry.name.size());
+
+			const auto matches = std::all_of(foldedTokens.begin(), foldedTokens.end(),
+				[&](const auto& token) { return name.contains(token); });
+			if (matches && (includeHidden || !entry.isHidden))
+			{
+				if (!fn(childPath(it.key(), entry.name), entry)) { return; }
+			}
+
+			const auto next = directory.nameOffsets[index] + entry.name.size() + 1;
+			position = next < names.size() ? names.indexOf(first, next) : -1;
+		}
+	}
+}
+
+auto FileIndex::entry(const QString& path) const -> std::optional<Entry>
+{
+	const auto info = QFileInfo{QDir::cleanPath(path)};
+	const auto lock = std::shared_lock{m_rootsMutex};
+	const auto rootPath = rootOf(info.path());
+	if (!rootPath) { return std::nullopt; }
+
+	const auto& directories = m_roots.at(*rootPath).directories;
+	const auto directory = directories.find(info.path());
+	if (directory == directories.end()) { return std::nullopt; }
+
+	const auto& entries = directory->entries;
+	const auto it = std::find_if(
+		entries.begin(), entries.end(), [&](const Entry& entry) { return entry.name == info.fileName(); });
+	if (it == entries.end()) { return std::nullopt; }
+	return *it;
+}
+
+void FileIndex::queueJob(Job job)
+{
+	const auto lock = std::lock_guard{m_jobsMutex};
+
+	// A directory that changes over and over only needs to be scanned once
+	const auto queued = std::any_of(m_jobs.begin(), m_jobs.end(),
+		[&](const Job& other) { return other.type == job.type && other.path == job.path; });
+	if (queued) { return; }
+
+	m_jobs.push_back(std::move(job));
+	if (!m_running)
+	{
+		m_running = true;
+		m_worker = ThreadPool::instance().enqueue([this] { runJobs(); });
+	}
+}
+
+void FileIndex::runJobs()
+{
+	// Only one worker runs at a time, so the filesystem is not hit from several threads
+	while (true)
+	{
+		auto job = std::optional<Job>{};
+		{
+			const auto lock = std::lock_guard{m_jobsMutex};
+			if (!m_jobs.empty() && !m_stop)
+			{
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+			else if (!m_changed || m_stop)
+			{
+				m_running = false;
+				return;
+			}
+		}
+
+		if (!job)
+		{
+			// Save once all pending changes are in
+			m_changed = false;
+			save();
+			continue;
+		}
+
+		switch (job->type)
+		{
+		case Job::Type::Load:
+			load();
+			break;
+		case Job::Type::AddRoot:
+			addRootInBackground(job->path);
+			break;
+		case Job::Type::Rescan:
+			rescanChanged(job->path);
+			break;
+		}
+	}
+}
+
+void FileIndex::load()
+{
+	auto file = QFile{indexFilePath()};
+	if (!file.open(QIODevice::ReadOnly)) { return; }
+
+	auto stream = QDataStream{&file};
+	auto version = quint32{0};
+	stream >> version;
+	if (version != IndexFileVersion) { return; }
+
+	auto roots = std::map<QString, Root>{};
+	auto rootCount = quint32{0};
+	stream >> rootCount;
+	for (auto i = quint32{0}; i < rootCount && stream.status() == QDataStream::Ok; ++i)
+	{
+		auto rootPath = QString{};
+		auto directoryCount = quint32{0};
+		stream >> rootPath >> directoryCount;
+
+		auto& root = roots[rootPath];
+		root.complete = true;
+		for (auto j = quint32{0}; j < directoryCount && stream.status() == QDataStream::Ok; ++j)
+		{
+			auto path = QString{};
+			auto directory = Directory{};
+			auto entryCount = quint32{0};
+			stream >> path >> directory.modified >> directory.isHidden >> entryCount;
+
+			for (auto k = quint32{0}; k < entryCount && stream.status() == QDataStream::Ok; ++k)
+			{
+				auto entry = Entry{};
+				stream >> entry.name >> entry.suffix >> entry.size >> entry.modified >> entry.isDir >> entry.isHidden
+					>> entry.duration >> entry.sampleRate;
+				directory.entries.push_back(std::move(entry));
+			}
+
+			indexNames(directory);
+			root.directories.insert(path, std::move(directory));
+		}
+	}
+
+	// Better start from scratch than from a damaged index
+	if (stream.status() != QDataStream::Ok) { return; }
+
+	const auto lock = std::unique_lock{m_rootsMutex};
+	m_roots = std::move(roots);
+}
+
+void FileIndex::save() const
+{
+	auto file = QSaveFile{indexFilePath()};
+	if (!file.open(QIODevice::WriteOnly)) { return; }
+
+	auto stream = QDataStream{&file};
+	const auto lock = std::shared_lock{m_rootsMutex};
+
+	const auto saved = [](const Root& root) { return root.complete && root.inUse; };
+	stream << IndexFileVersion;
+	stream << static_cast<quint32>(std::count_if(
+		m_roots.begin(), m_roots.end(), [&](const auto& root) { return saved(root.second); }));
+
+	for (const auto& [rootPath, root] : m_roots)
+	{
+		if (!saved(root)) { continue; }
+
+		stream << rootPath << static_cast<quint32>(root.directories.size());
+		for (auto it = root.directories.begin(); it != root.directories.end(); ++it)
+		{
+			const auto& directory = it.value();
+			stream << it.key() << directory.modified << directory.isHidden
+				<< static_cast<quint32>(directory.entries.size());
+
+			for (const auto& entry : directory.entries)
+			{
+				stream << entry.name << entry.suffix << entry.size << entry.modified << entry.isDir << entry.isHidden
+					<< entry.duration << entry.sampleRate;
+			}
+		}
+	}
+
+	file.commit();
+}
+
+void FileIndex::addRootInBackground(const QString& rootPath)
+{
+	auto loaded = false;
+	{
+		const auto lock = std::unique_lock{m_rootsMutex};
+		auto& root = m_roots[rootPath];
+		if (root.inUse) { return; }
+
+		root.inUse = true;
+		loaded = root.complete;
+	}
+
+	if (loaded)
+	{
+		// Loaded from the last session, so only look for what changed since
+		refresh(rootPath);
+	}
+	else
+	{
+		auto visited = QSet<QString>{};
+		auto found = QStringList{};
+		rescan(rootPath, rootPath, false, true, visited, found);
+		if (m_stop) { return; }
+
+		const auto lock = std::unique_lock{m_rootsMutex};
+		m_roots[rootPath].complete = true;
+	}
+
+	// Watch the directories closest to the root, as only a limited number can be watched
+	auto directories = QStringList{};
+	{
+		const auto lock = std::shared_lock{m_rootsMutex};
+		directories = m_roots.at(rootPath).directories.keys();
+	}
+	std::stable_sort(directories.begin(), directories.end(),
+		[](const QString& a, const QString& b) { return a.count('/') < b.count('/'); });
+
+	QMetaObject::invokeMethod(
+		this, [this, rootPath, directories] { watch(rootPath, directories); }, Qt::QueuedConnection);
+}
+
+void FileIndex::refresh(const QString& rootPath)
+{
+	auto directories = std::vector<std::tuple<QString, qint64, bool>>{};
+	{
+		const auto lock = std::shared_lock{m_rootsMutex};
+		const auto& root = m_roots.at(rootPath);
+		for (auto it = root.directories.begin(); it != root.directories.end(); ++it)
+		{
+			directories.emplace_back(it.key(), it->modified, it->isHidden);
+		}
+	}
+
+	// A directory changes when entries are added, removed or renamed in it, which is all the names need
+	// New directories need no watch yet, the caller watches all of them afterwards
+	auto visited = QSet<QString>{};
+	auto found = QStringList{};
+	for (const auto& [path, modified, isHidden] : directories)
+	{
+		if (m_stop) { return; }
+
+		const auto info = QFileInfo{path};
+		if (info.lastModified().toMSecsSinceEpoch() != modified || !info.isDir())
+		{
+			rescan(rootPath, path, isHidden, false, visited, found);
+		}
+	}
+}
+
+void FileIndex::rescanChanged(const QString& path)
+{
+	auto rootPath = QString{};
+	auto isHidden = false;
+	{
+		const auto lock = std::shared_lock{m_rootsMutex};
+		const auto root = rootOf(path);
+		if (!root) { return; }
+
+		rootPath = *root;
+		const auto& directories = m_roots.at(rootPath).directories;
+		const auto directory = directories.find(path);
+		if (directory != directories.end()) { isHidden = directory->isHidden; }
+	}
+
+	auto visited = QSet<QString>{};
+	auto found = QStringList{};
+	rescan(rootPath, path, isHidden, false, visited, found);
+	if (found.isEmpty()) { return; }
+
+	// Watch directories created since, or changes inside them would go unnoticed
+	QMetaObject::invokeMethod(this, [this, rootPath, found] { watch(rootPath, found); }, Qt::QueuedConnection);
+}
+
+void FileIndex::rescan(const QString& rootPath, const QString& path, bool isHidden, bool recursive,
+	QSet<QString>& visited, QStringList& found)
+{
+	if (m_stop) { return; }
+
+	const auto info = QFileInfo{path};
+	if (!info.isDir())
+	{
+		const auto lock = std::unique_lock{m_rootsMutex};
+		removeTree(m_roots[rootPath], path);
+		m_changed = true;
+		return;
+	}
+
+	// Follow symlinks like the search does, but enter each directory only once
+	const auto canonicalPath = info.canonicalFilePath();
+	if (visited.contains(canonicalPath)) { return; }
+	visited.insert(canonicalPath);
+
+	auto previous = std::optional<Directory>{};
+	{
+		const auto lock = std::shared_lock{m_rootsMutex};
+		const auto& directories = m_roots.at(rootPath).directories;
+		const auto it = directories.find(path);
+		if (it != directories.end()) { previous = *it; }
+	}
+
+	auto previousEntries = QHash<QString, const Entry*>{};
+	if (previous)
+	{
+		for (const auto& entry : previous->entries)
+		{
+			previousEntries.insert(entry.name, &entry);
+		}
+	}
+
+	auto directory = Directory{};
+	directory.modified = info.lastModified().toMSecsSinceEpoch();
+	directory.isHidden = isHidden;
+
+	const auto entries = QDir{path}.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden);
+	for (const auto& entryInfo : entries)
+	{
+		directory.entries.push_back(makeEntry(entryInfo, previousEntries.value(entryInfo.fileName(), nullptr)));
+	}
+	indexNames(directory);
+
+	auto subdirectories = std::vector<std::pair<QString, bool>>{};
+	for (const auto& entry : directory.entries)
+	{
+		if (entry.isDir) { subdirectories.emplace_back(childPath(path, entry.name), isHidden || entry.isHidden); }
+	}
+
+	{
+		const auto lock = std::unique_lock{m_rootsMutex};
+		auto& root = m_roots[rootPath];
+
+		// Subdirectories that are gone take their contents with them
+		if (previous)
+		{
+			for (const auto& entry : previous->entries)
+			{
+				const auto& current = directory.entries;
+				const auto stillThere = std::any_of(current.begin(), current.end(),
+					[&](const Entry& other) { return other.isDir && other.name == entry.name; });
+				if (entry.isDir && !stillThere) { removeTree(root, childPath(path, entry.name)); }
+			}
+		}
+
+		root.directories.insert(path, std::move(directory));
+		m_changed = true;
+	}
+	if (!previous) { found.push_back(path); }
+
+	for (const auto& [subdirectory, subdirectoryHidden] : subdirectories)
+	{
+		auto known = false;
+		{
+			const auto lock = std::shared_lock{m_rootsMutex};
+			known = m_roots.at(rootPath).directories.contains(subdirectory);
+		}
+
+		if (recursive || !known) { rescan(rootPath, subdirectory, subdirectoryHidden, true, visited, found); }
+	}
+}
+
+void FileIndex::watch(const QString& rootPath, const QStringList& directories)
+{
+	const auto watched = m_watcher.directories();
+	const auto alreadyWatched = QSet<QString>{watched.begin(), watched.end()};
+
+	auto added = QStringList{};
+	for (const auto& directory : directories)
+	{
+		if (!alreadyWatched.contains(directory)) { added.push_back(directory); }
+	}
+	if (added.isEmpty()) { return; }
+
+	// Once the budget or the system limit is used up, the root can no longer be trusted to be up to date
+	const auto budget = std::max<qsizetype>(MaxWatchedDirectories - watched.size(), 0);
+	const auto failed = m_watcher.addPaths(added.mid(0, budget));
+	if (added.size() <= budget && failed.isEmpty()) { return; }
+
+	const auto lock = std::unique_lock{m_rootsMutex};
+	const auto root = m_roots.find(rootPath);
+	if (root != m_roots.end()) { root->second.watched = false; }
+}
+
+auto FileIndex::rootOf(const QString& path) const -> const QString*
+{
+	for (const auto& [rootPath, root] : m_roots)
+	{
+		if (root.inUse && isWithin(path, rootPath)) { return &rootPath; }
+	}
+	return nullptr;
+}
+
+void FileIndex::removeTree(Root& root, const QString& path)
+{
+	for (auto it = root.directories.begin(); it != root.directories.end();)
+	{
+		it = isWithin(it.key(), path) ? root.directories.erase(it) : std::next(it);
+	}
+}
+
+auto FileIndex::makeEntry(const QFileInfo& info, const Entry* previous) -> Entry
+{
+	auto entry = Entry{};
+	entry.name = info.fileName();
+	entry.isDir = info.isDir();
+	entry.isHidden = info.isHidden();
+	entry.modified = info.lastModified().toMSecsSinceEpoch();
+	if (entry.isDir) { return entry; }
+
+	entry.suffix = info.completeSuffix();
+	entry.size = info.size();
+	if (!isAudioFile(info)) { return entry; }
+
+	// Only decode the header again if the file changed
+	if (previous && previous->size == entry.size && previous->modified == entry.modified)
+	{
+		entry.duration = previous->duration;
+		entry.sampleRate = previous->sampleRate;
+		return entry;
+	}
+
+	auto file = QFile{info.filePath()};
+	if (!file.open(QIODevice::ReadOnly)) { return entry; }
+
+	auto sfInfo = SF_INFO{};
+	if (const auto sndFile = sf_open_fd(file.handle(), SFM_READ, &sfInfo, false))
+	{
+		if (sfInfo.samplerate > 0)
+		{
+			entry.sampleRate = sfInfo.samplerate;
+			entry.duration = static_cast<double>(sfInfo.frames) / sfInfo.samplerate;
+		}
+		sf_close(sndFile);
+	}
+
+	return entry;
+}
+
+void FileIndex::indexNames(Directory& directory)
+{
+	directory.names.clear();
+	directory.nameOffsets.clear();
+	directory.nameOffsets.reserve(directory.entries.size());
+	for (const auto& entry : directory.entries)
+	{
+		directory.nameOffsets.push_back(directory.names.size());
+		directory.names += entry.name.toCaseFolded();
+		directory.names += '\n';
+	}
+}
+} // namespace lmms::gui
@@ -27,6 +27,7 @@
 #include <QDirIterator>
 #include <QRegularExpression>
 
+#include "FileIndex.h"
 #include "ThreadPool.h"
 
 namespace lmms::gui {
@@ -77,8 +78,23 @@ void FileSearchJob::runSearch(Task task)
 
 	emit started();
 
+	const auto& index = FileIndex::instance();
+	const auto includeHidden = task.dirFilters.testFlag(QDir::Hidden);
+
 	for (const auto& path : task.paths)
 	{
+		if (index.isIndexed(path))
+		{
+			index.search(path, tokens, includeHidden, [&](const QString& filePath, const FileIndex::Entry& entry) {
+				const auto validFile = !entry.isDir
+					&& task.extensions.contains(QString{"*.%1"}.arg(entry.suffix), Qt::CaseInsensitive);
+
+				if (entry.isDir || validFile) { emit foundMatch(filePath); }
+				return !m_stop.test(std::memory_order_relaxed);
+			});
+			continue;
+		}
+
 		auto dirIt = QDirIterator{path, task.dirFilters,
 			QDirIterator::IteratorFlag::Subdirectories | QDirIterator::IteratorFlag::FollowSymlinks};
 
@@ -115,7 +115,7 @@ MainWindow::MainWindow() :
 		embed::getIconPixmap("star").transformed(QTransform().rotate(90)), splitter, false, "", ""));
 
 	sideBar->appendTab(new FileBrowser(FileBrowser::Type::Normal,
-		confMgr->userProjectsDir() + "*" + confMgr->factoryProjectsDir(), "*.mmp *.mmpz *.xml *.mid *.mpt",
+		confMgr->userProjectsDir() + "*" + confMgr->factoryProjectsDir(), "*.mmp *.mmpz *.mmpx *.xml *.mid *.mpt",
 		tr("My Projects"), embed::getIconPixmap("project_file").transformed(QTransform().rotate(90)), splitter, false,
 		confMgr->userProjectsDir(), confMgr->factoryProjectsDir()));
 
@@ -209,6 +209,14 @@ MainWindow::MainWindow() :
 	{
 		// connect auto save
 		connect(&m_autoSaveTimer, SIGNAL(timeout()), this, SLOT(autoSave()));
+		connect(Engine::getSong(), &Song::backgroundSaveFinished, this,
+			[this](const QString& filename, bool success, unsigned modificationCount)
+		{
+			if (success && filename == ConfigManager::inst()->recoveryFile())
+			{
+				m_autoSavedModificationCount = modificationCount;
+			}
+		});
 		m_autoSaveInterval = ConfigManager::inst()->value(
 					"ui", "saveinterval" ).toInt() < 1 ?
 						DEFAULT_AUTO_SAVE_INTERVAL :
@@ -746,7 +754,7 @@ void MainWindow::openProject()
 {
 	if( mayChangeProject(false) )
 	{
-		FileDialog ofd( this, tr( "Open Project" ), "", tr( "LMMS (*.mmp *.mmpz)" ) );
+		FileDialog ofd( this, tr( "Open Project" ), "", tr( "LMMS (*.mmp *.mmpz *.mmpx)" ) );
 
 		ofd.setDirectory( ConfigManager::inst()->userProjectsDir() );
 		ofd.setFileMode( FileDialog::ExistingFiles );
@@ -791,6 +799,7 @@ bool MainWindow::saveProjectAs()
 	auto optionsWidget = new SaveOptionsWidget(Engine::getSong()->getSaveOptions());
 	VersionedSaveDialog sfd( this, optionsWidget, tr( "Save Project" ), "",
 			tr( "LMMS Project" ) + " (*.mmpz *.mmp);;" +
+				tr( "LMMS Project (binary container)" ) + " (*.mmpx);;" +
 				tr( "LMMS Project Template" ) + " (*.mpt)" );
 	QString f = Engine::getSong()->projectFileName();
 	if( f != "" )
@@ -827,6 +836,15 @@ bool MainWindow::saveProjectAs()
 				}
 			}
 		}
+		else if (sfd.selectedNameFilter().contains("(*.mmpx)"))
+		{
+			fname.remove("." + suffix);
+			if (!sfd.selectedFiles()[0].endsWith(".mmpx")
+				&& VersionedSaveDialog::fileExistsQuery(fname + ".mmpx", tr("Save project")))
+			{
+				fname += ".mmpx";
+			}
+		}
 		if( this->guiSaveProjectAs( fname ) )
 		{
 			if( getSession() == SessionState::Recover )
@@ -1257,6 +1275,9 @@ void MainWindow::closeEvent( QCloseEvent * _ce )
 
 void MainWindow::sessionCleanup()
 {
+	// an auto save still being written would bring the file back
+	Engine::getSong()->waitForBackgroundSave();
+
 	// delete recover session files
 	QFile::remove( ConfigManager::inst()->recoveryFile() );
 	setSession( SessionState::Normal );
@@ -1395,15 +1416,24 @@ void MainWindow::browseHelp()
 
 void MainWindow::autoSave()
 {
+	if (m_autoSavedModificationCount == Engine::getSong()->modificationCount())
+	{
+		// nothing changed since the last auto save
+		autoSaveTimerReset();
+		return;
+	}
+
 	if( !Engine::getSong()->isExporting() &&
 		!Engine::getSong()->isLoadingProject() &&
+		!Engine::getSong()->isSavingInBackground() &&
 		!RemotePluginBase::isMainThreadWaiting() &&
 		!QApplication::mouseButtons() &&
 		( ConfigManager::inst()->value( "ui",
 				"enablerunningautosave" ).toInt() ||
 			! Engine::getSong()->isPlaying() ) )
 	{
-		Engine::getSong()->saveProjectFile(ConfigManager::inst()->recoveryFile());
+		// Only the model is stored here, the file is written on a worker thread
+		Engine::getSong()->saveProjectFileInBackground(ConfigManager::inst()->recoveryFile());
 		autoSaveTimerReset();  // Reset timer
 	}
 	else
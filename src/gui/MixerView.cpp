@@ -24,6 +24,10 @@
 
 #include "MixerView.h"
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include <QHBoxLayout>
 #include <QLayout>
 #include <QLineEdit>
@@ -34,6 +38,7 @@
 #include <QStackedLayout>
 #include <QStackedWidget>
 
+#include "AudioEngine.h"
 #include "EffectRackView.h"
 #include "Engine.h"
 #include "Fader.h"
@@ -59,7 +64,8 @@ MixerView::MixerView(Mixer* mixer) :
 	QWidget(),
 	ModelView(nullptr, this),
 	SerializingObjectHook(),
-	m_mixer(mixer)
+	m_mixer(mixer),
+	m_telemetryReader(Engine::audioEngine()->telemetry())
 {
 	mixer->setHook(this);
 
@@ -557,34 +563,26 @@ void MixerView::clear()
 
 void MixerView::updateFaders()
 {
-	Mixer * m = getMixer();
-
-	for (int i = 0; i < m_mixerChannelViews.size(); ++i)
-	{
-		const float opl = m_mixerChannelViews[i]->m_fader->getPeak_L();
-		const float opr = m_mixerChannelViews[i]->m_fader->getPeak_R();
-		const float fallOff = 1.25;
-		if (m->mixerChannel(i)->m_peakLeft >= opl/fallOff)
+	// Take the highest peak of all periods rendered since the last update
+	auto peaks = std::vector<std::array<float, 2>>(m_mixerChannelViews.size());
+	const auto periods = m_telemetryReader.read([&](const AudioTelemetry::Snapshot& snapshot) {
+		const auto channels = std::min(peaks.size(), snapshot.channelCount);
+		for (std::size_t i = 0; i < channels; ++i)
 		{
-			m_mixerChannelViews[i]->m_fader->setPeak_L(m->mixerChannel(i)->m_peakLeft);
-			// Set to -1 so later we'll know if this value has been refreshed yet.
-			m->mixerChannel(i)->m_peakLeft = -1;
-		}
-		else if (m->mixerChannel(i)->m_peakLeft != -1)
-		{
-			m_mixerChannelViews[i]->m_fader->setPeak_L(opl/fallOff);
+			peaks[i][0] = std::max(peaks[i][0], snapshot.channels[i].peak[0]);
+			peaks[i][1] = std::max(peaks[i][1], snapshot.channels[i].peak[1]);
 		}
+	});
 
-		if (m->mixerChannel(i)->m_peakRight >= opr/fallOff)
-		{
-			m_mixerChannelViews[i]->m_fader->setPeak_R(m->mixerChannel(i)->m_peakRight);
-			// Set to -1 so later we'll know if this value has been refreshed yet.
-			m->mixerChannel(i)->m_peakRight = -1;
-		}
-		else if (m->mixerChannel(i)->m_peakRight != -1)
-		{
-			m_mixerChannelViews[i]->m_fader->setPeak_R(opr/fallOff);
-		}
+	// Nothing rendered, so keep the faders where they are
+	if (periods == 0) { return; }
+
+	const float fallOff = 1.25;
+	for (int i = 0; i < m_mixerChannelViews.size(); ++i)
+	{
+		Fader* fader = m_mixerChannelViews[i]->m_fader;
+		fader->setPeak_L(std::max(peaks[i][0], fader->getPeak_L() / fallOff));
+		fader->setPeak_R(std::max(peaks[i][1], fader->getPeak_R() / fallOff));
 	}
 }
 
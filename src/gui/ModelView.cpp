@@ -25,6 +25,7 @@
 #include <QWidget>
 
 #include "ModelView.h"
+#include "RepaintScheduler.h"
 
 namespace lmms::gui
 {
@@ -90,7 +91,7 @@ void ModelView::doConnections()
 {
 	if( m_model != nullptr )
 	{
-		QObject::connect( m_model, SIGNAL(dataChanged()), widget(), SLOT(update()));
+		RepaintScheduler::connectDataChanged(m_model, widget(), [w = widget()] { w->update(); });
 		QObject::connect( m_model, SIGNAL(propertiesChanged()), widget(), SLOT(update()));
 	}
 }
@@ -0,0 +1,119 @@
+/*
+ * RepaintScheduler.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RepaintScheduler.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QThread>
+#include <QTimerEvent>
+#include <QWidget>
+
+#include "Model.h"
+
+namespace lmms::gui {
+
+namespace {
+//! Same rate as MainWindow::periodicUpdate
+constexpr auto FrameInterval = 1000 / 60;
+} // namespace
+
+RepaintScheduler::RepaintScheduler()
+	: QObject(QCoreApplication::instance())
+{
+	m_timer.start(FrameInterval, this);
+}
+
+auto RepaintScheduler::instance() -> RepaintScheduler&
+{
+	static auto s_scheduler = new RepaintScheduler{};
+	return *s_scheduler;
+}
+
+void RepaintScheduler::connectDataChanged(Model* model, QWidget* widget, std::function<void()> update)
+{
+	auto& scheduler = instance();
+
+	// The connection owns the entry, so it lives exactly as long as the connection does
+	auto entry = std::make_shared<Entry>();
+	entry->widget = widget;
+	entry->update = std::move(update);
+	if (scheduler.m_entries.size() == scheduler.m_entries.capacity())
+	{
+		// Drop the entries of ended connections before growing
+		std::erase_if(scheduler.m_entries, [](const std::weak_ptr<Entry>& weakEntry) { return weakEntry.expired(); });
+	}
+	scheduler.m_entries.push_back(entry);
+
+	// Installing the same filter twice only moves it to the front, so widgets with several models are fine
+	widget->installEventFilter(&scheduler);
+
+	const auto guiThread = scheduler.thread();
+	QObject::connect(model, &Model::dataChanged, widget, [&scheduler, entry, guiThread] {
+		if (QThread::currentThread() == guiThread) { entry->update(); }
+		else { scheduler.markDirty(*entry); }
+	}, Qt::DirectConnection);
+}
+
+void RepaintScheduler::markDirty(Entry& entry)
+{
+	// Only touches atomics, as this runs on the thread that changed the model
+	entry.dirty.store(true, std::memory_order_relaxed);
+	m_anyDirty.store(true, std::memory_order_release);
+}
+
+void RepaintScheduler::timerEvent(QTimerEvent* event)
+{
+	if (event->timerId() != m_timer.timerId()) { return QObject::timerEvent(event); }
+	if (!m_anyDirty.exchange(false, std::memory_order_acquire)) { return; }
+
+	std::erase_if(m_entries, [](const std::weak_ptr<Entry>& weakEntry) {
+		const auto entry = weakEntry.lock();
+		if (!entry) { return true; }
+
+		// Hidden widgets stay dirty until they are shown, as the update may do more than repaint
+		if (entry->widget && entry->widget->isVisible()) { runIfDirty(*entry); }
+		return false;
+	});
+}
+
+bool RepaintScheduler::eventFilter(QObject* watched, QEvent* event)
+{
+	if (event->type() == QEvent::Show)
+	{
+		for (const auto& weakEntry : m_entries)
+		{
+			const auto entry = weakEntry.lock();
+			if (entry && entry->widget == watched) { runIfDirty(*entry); }
+		}
+	}
+	return QObject::eventFilter(watched, event);
+}
+
+void RepaintScheduler::runIfDirty(Entry& entry)
+{
+	if (entry.dirty.exchange(false, std::memory_order_relaxed)) { entry.update(); }
+}
+
+} // namespace lmms::gui
@@ -25,14 +25,50 @@
 
 #include "SampleThumbnail.h"
 
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QPainter>
+#include <QSaveFile>
 
+#include "ConfigManager.h"
+#include "PathUtil.h"
 #include "Sample.h"
+#include "ThreadPool.h"
 
 namespace {
 	constexpr auto MaxSampleThumbnailCacheSize = 32;
 	constexpr auto AggregationPerZoomStep = 10;
+
+	//! Samples up to this length are cheap enough to be processed right away
+	constexpr auto MaxSynchronousFrames = std::size_t{1} << 18;
+
+	//! The finest zoom level is not stored on disk, as it takes up most of the
+	//! space. Zooming in that far draws from the sample itself instead.
+	constexpr auto MinDiskSamplesPerPeak = AggregationPerZoomStep * AggregationPerZoomStep;
+	constexpr auto MaxDiskCacheBytes = qint64{256} << 20;
+
+	constexpr auto DiskCacheMagic = std::array<char, 8>{'L', 'M', 'M', 'S', 'T', 'H', 'M', 'B'};
+	constexpr quint32 DiskCacheVersion = 1;
+
+	std::mutex s_diskCacheMutex;
+
+	//! Remove the least recently written files until the cache fits its budget
+	void pruneDiskCache(const QString& dir)
+	{
+		const auto files = QDir{dir}.entryInfoList(QDir::Files, QDir::Time);
+		auto total = qint64{0};
+		for (const auto& file : files)
+		{
+			total += file.size();
+			if (total > MaxDiskCacheBytes) { QFile::remove(file.absoluteFilePath()); }
+		}
+	}
 }
 
 namespace lmms::gui {
@@ -80,7 +116,7 @@ SampleThumbnail::SampleThumbnail(const Sample& sample)
 		const auto it = s_sampleThumbnailCacheMap.find(entry);
 		if (it != s_sampleThumbnailCacheMap.end())
 		{
-			m_thumbnailCache = it->second;
+			m_pyramid = it->second;
 			return;
 		}
 
@@ -90,21 +126,127 @@ SampleThumbnail::SampleThumbnail(const Sample& sample)
 				[](const auto& a, const auto& b) { return a.second.use_count() < b.second.use_count(); });
 			s_sampleThumbnailCacheMap.erase(leastUsed->first);
 		}
+	}
+
+	if (m_buffer->size() <= MaxSynchronousFrames)
+	{
+		generate(*m_pyramid, *m_buffer);
+	}
+	else
+	{
+		m_pyramid = std::make_shared<Pyramid>(false);
+
+		// Create the notifier on the GUI thread before any worker uses it
+		notifier();
+
+		const auto cacheFile = entry.filePath.isEmpty() ? QString{} : diskCacheFile(entry.filePath);
+		ThreadPool::instance().enqueue([pyramid = m_pyramid, buffer = m_buffer, cacheFile] {
+			const auto loaded = !cacheFile.isEmpty() && loadFromDisk(*pyramid, cacheFile, buffer->size());
+			if (!loaded) { generate(*pyramid, *buffer); }
+
+			pyramid->ready.store(true, std::memory_order_release);
+			QMetaObject::invokeMethod(notifier(), "thumbnailReady", Qt::QueuedConnection);
 
-		s_sampleThumbnailCacheMap[std::move(entry)] = m_thumbnailCache;
+			if (!loaded && !cacheFile.isEmpty()) { saveToDisk(*pyramid, cacheFile, buffer->size()); }
+		});
 	}
 
-	const auto flatBuffer = m_buffer->data()->data();
-	const auto flatBufferSize = m_buffer->size() * DEFAULT_CHANNELS;
-	m_thumbnailCache->emplace_back(flatBuffer, flatBufferSize, flatBufferSize / AggregationPerZoomStep);
+	if (!entry.filePath.isEmpty()) { s_sampleThumbnailCacheMap[std::move(entry)] = m_pyramid; }
+}
+
+void SampleThumbnail::generate(Pyramid& pyramid, const SampleBuffer& buffer)
+{
+	auto& thumbnails = pyramid.thumbnails;
+	const auto flatBuffer = buffer.data()->data();
+	const auto flatBufferSize = buffer.size() * DEFAULT_CHANNELS;
+	thumbnails.emplace_back(flatBuffer, flatBufferSize, flatBufferSize / AggregationPerZoomStep);
 
-	while (m_thumbnailCache->back().width() >= AggregationPerZoomStep)
+	while (thumbnails.back().width() >= AggregationPerZoomStep)
 	{
-		auto zoomedOutThumbnail = m_thumbnailCache->back().zoomOut(AggregationPerZoomStep);
-		m_thumbnailCache->emplace_back(std::move(zoomedOutThumbnail));
+		auto zoomedOutThumbnail = thumbnails.back().zoomOut(AggregationPerZoomStep);
+		thumbnails.emplace_back(std::move(zoomedOutThumbnail));
 	}
 }
 
+bool SampleThumbnail::loadFromDisk(Pyramid& pyramid, const QString& cacheFile, std::size_t frames)
+{
+	auto file = QFile{cacheFile};
+	if (!file.open(QIODevice::ReadOnly)) { return false; }
+
+	auto stream = QDataStream{&file};
+	auto magic = std::array<char, DiskCacheMagic.size()>{};
+	auto version = quint32{0};
+	auto storedFrames = quint64{0};
+	auto levels = quint32{0};
+	stream.readRawData(magic.data(), magic.size());
+	stream >> version >> storedFrames >> levels;
+	if (stream.status() != QDataStream::Ok || magic != DiskCacheMagic || version != DiskCacheVersion
+		|| storedFrames != frames)
+	{
+		return false;
+	}
+
+	auto thumbnails = ThumbnailCache{};
+	for (auto level = quint32{0}; level < levels; ++level)
+	{
+		auto samplesPerPeak = 0.0;
+		auto width = quint32{0};
+		stream >> samplesPerPeak >> width;
+		const auto bytes = static_cast<qint64>(width) * sizeof(Thumbnail::Peak);
+		if (stream.status() != QDataStream::Ok || bytes > file.bytesAvailable()) { return false; }
+
+		auto peaks = std::vector<Thumbnail::Peak>(width);
+		if (stream.readRawData(reinterpret_cast<char*>(peaks.data()), bytes) != bytes) { return false; }
+		thumbnails.emplace_back(std::move(peaks), samplesPerPeak);
+	}
+
+	pyramid.thumbnails = std::move(thumbnails);
+	return true;
+}
+
+void SampleThumbnail::saveToDisk(const Pyramid& pyramid, const QString& cacheFile, std::size_t frames)
+{
+	const auto firstStored = std::find_if(pyramid.thumbnails.begin(), pyramid.thumbnails.end(),
+		[](const auto& thumbnail) { return thumbnail.samplesPerPeak() >= MinDiskSamplesPerPeak; });
+
+	auto file = QSaveFile{cacheFile};
+	if (!file.open(QIODevice::WriteOnly)) { return; }
+
+	auto stream = QDataStream{&file};
+	stream.writeRawData(DiskCacheMagic.data(), DiskCacheMagic.size());
+	stream << DiskCacheVersion << static_cast<quint64>(frames)
+		<< static_cast<quint32>(std::distance(firstStored, pyramid.thumbnails.end()));
+	for (auto it = firstStored; it != pyramid.thumbnails.end(); ++it)
+	{
+		const auto& thumbnail = *it;
+		stream << thumbnail.samplesPerPeak() << static_cast<quint32>(thumbnail.width());
+		stream.writeRawData(reinterpret_cast<const char*>(thumbnail.data()), thumbnail.width() * sizeof(Thumbnail::Peak));
+	}
+
+	const auto guard = std::lock_guard{s_diskCacheMutex};
+	if (stream.status() == QDataStream::Ok && file.commit())
+	{
+		pruneDiskCache(QFileInfo{cacheFile}.absolutePath());
+	}
+}
+
+QString SampleThumbnail::diskCacheFile(const QString& sampleFile)
+{
+	const auto info = QFileInfo{PathUtil::toAbsolute(sampleFile)};
+	if (!info.exists()) { return {}; }
+
+	const auto identity = QString{"%1\n%2\n%3"}.arg(info.canonicalFilePath())
+		.arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+	const auto hash = QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Sha1).toHex();
+	return ConfigManager::cacheDir("thumbnails") + QString::fromLatin1(hash) + ".peaks";
+}
+
+SampleThumbnailNotifier* SampleThumbnail::notifier()
+{
+	static auto s_notifier = SampleThumbnailNotifier{};
+	return &s_notifier;
+}
+
 void SampleThumbnail::visualize(VisualizeParameters parameters, QPainter& painter) const
 {
 	const auto& sampleRect = parameters.sampleRect;
@@ -116,11 +258,18 @@ void SampleThumbnail::visualize(VisualizeParameters parameters, QPainter& painte
 	const auto sampleRange = parameters.sampleEnd - parameters.sampleStart;
 	if (sampleRange <= 0.0f || sampleRange > 1.0f) { return; }
 
+	if (!isReady())
+	{
+		painter.drawLine(renderRect.left(), renderRect.center().y(), renderRect.right(), renderRect.center().y());
+		return;
+	}
+
+	const auto& thumbnails = m_pyramid->thumbnails;
 	const auto targetThumbnailWidth = static_cast<int>(sampleRect.width() / sampleRange);
-	const auto finerThumbnail = std::find_if(m_thumbnailCache->rbegin(), m_thumbnailCache->rend(),
+	const auto finerThumbnail = std::find_if(thumbnails.rbegin(), thumbnails.rend(),
 		[&](const auto& thumbnail) { return thumbnail.width() >= targetThumbnailWidth; });
 
-	const auto useOriginalBuffer = finerThumbnail == m_thumbnailCache->rend();
+	const auto useOriginalBuffer = finerThumbnail == thumbnails.rend();
 	const auto drawOriginalBuffer = static_cast<size_t>(targetThumbnailWidth) == m_buffer->size();
 
 	painter.save();
@@ -132,7 +281,10 @@ void SampleThumbnail::visualize(VisualizeParameters parameters, QPainter& painte
 	const auto thumbnailEnd = parameters.reversed ? targetThumbnailWidth - thumbnailEndForward : thumbnailEndForward;
 	const auto advanceThumbnailBy = parameters.reversed ? -1 : 1;
 
-	const auto finerThumbnailWidth = useOriginalBuffer ? m_buffer->size() : finerThumbnail->width();
+	// Thumbnails aggregate the interleaved samples, so the original buffer is scaled the same way
+	const auto finerThumbnailWidth = useOriginalBuffer
+		? m_buffer->size() * DEFAULT_CHANNELS
+		: static_cast<std::size_t>(finerThumbnail->width());
 	const auto finerThumbnailScaleFactor = static_cast<double>(finerThumbnailWidth) / targetThumbnailWidth;
 	const auto yScale = renderRect.height() / 2 * parameters.amplification;
 
@@ -147,8 +299,8 @@ void SampleThumbnail::visualize(VisualizeParameters parameters, QPainter& painte
 		}
 		else
 		{
-			const auto beginIndex = std::clamp<size_t>(std::floor(i * finerThumbnailScaleFactor), 0, finerThumbnail->width() - 1);
-			const auto endIndex = std::clamp<size_t>(std::ceil((i + 1) * finerThumbnailScaleFactor), 0, finerThumbnail->width() - 1);
+			const auto beginIndex = std::clamp<size_t>(std::floor(i * finerThumbnailScaleFactor), 0, finerThumbnailWidth - 1);
+			const auto endIndex = std::clamp<size_t>(std::ceil((i + 1) * finerThumbnailScaleFactor), 0, finerThumbnailWidth - 1);
 
 			auto minPeak = 0.f;
 			auto maxPeak = 0.f;
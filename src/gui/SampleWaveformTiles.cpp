@@ -0,0 +1,163 @@
+/*
+ * SampleWaveformTiles.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleWaveformTiles.h"
+
+#include <QCoreApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPointer>
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace lmms::gui {
+
+SampleWaveformTiles::SampleWaveformTiles(QObject* parent)
+	: QObject(parent)
+{
+}
+
+void SampleWaveformTiles::setThumbnail(const SampleThumbnail& thumbnail)
+{
+	m_thumbnail = thumbnail;
+	m_tiles.clear();
+	m_pendingTiles.clear();
+	++m_generation;
+}
+
+void SampleWaveformTiles::draw(QPainter& painter, QPoint position, const Parameters& parameters, const QRect& viewport)
+{
+	const auto sampleRect = QRect{position, QSize{parameters.sampleWidth, parameters.height}};
+	const auto visibleRect = sampleRect.intersected(viewport);
+	if (visibleRect.isEmpty()) { return; }
+
+	if (!m_thumbnail.isReady())
+	{
+		// Only draws a center line, so there is nothing worth caching yet
+		m_thumbnail.visualize({.sampleRect = sampleRect, .viewportRect = viewport}, painter);
+		return;
+	}
+
+	const auto firstIndex = (visibleRect.left() - position.x()) / TileWidth;
+	const auto lastIndex = (visibleRect.right() - position.x()) / TileWidth;
+	for (auto index = firstIndex; index <= lastIndex; ++index)
+	{
+		const auto tilePosition = QPoint{position.x() + index * TileWidth, position.y()};
+
+		if (const auto tile = findTile(parameters, index, false))
+		{
+			tile->lastUsed = ++m_useCount;
+			painter.drawPixmap(tilePosition, tile->pixmap);
+			continue;
+		}
+
+		render(parameters, index);
+
+		// Keep showing the tile as it was drawn before, e.g. before the clip was selected
+		if (const auto tile = findTile(parameters, index, true))
+		{
+			painter.drawPixmap(tilePosition, tile->pixmap);
+			continue;
+		}
+
+		const auto tileRect = QRect{tilePosition, QSize{TileWidth, parameters.height}}.intersected(visibleRect);
+		painter.drawLine(tileRect.left(), tileRect.center().y(), tileRect.right(), tileRect.center().y());
+	}
+}
+
+auto SampleWaveformTiles::findTile(const Parameters& parameters, int index, bool anyColor) -> Tile*
+{
+	const auto it = std::find_if(m_tiles.begin(), m_tiles.end(), [&](const Tile& tile) {
+		if (tile.index != index) { return false; }
+		if (!anyColor) { return tile.parameters == parameters; }
+
+		auto colored = parameters;
+		colored.color = tile.parameters.color;
+		return tile.parameters == colored;
+	});
+
+	return it != m_tiles.end() ? &*it : nullptr;
+}
+
+void SampleWaveformTiles::render(const Parameters& parameters, int index)
+{
+	const auto pending = std::any_of(m_pendingTiles.begin(), m_pendingTiles.end(),
+		[&](const PendingTile& tile) { return tile.index == index && tile.parameters == parameters; });
+	if (pending) { return; }
+
+	m_pendingTiles.push_back(PendingTile{.parameters = parameters, .index = index});
+
+	// The tiles may be gone by the time the tile is rendered, which the QPointer notices on the GUI thread
+	ThreadPool::instance().enqueue([tiles = QPointer{this}, thumbnail = m_thumbnail, parameters, index,
+									   generation = m_generation] {
+		const auto width = std::min(TileWidth, parameters.sampleWidth - index * TileWidth);
+		auto image = QImage{width, parameters.height, QImage::Format_ARGB32_Premultiplied};
+		image.fill(Qt::transparent);
+
+		auto painter = QPainter{&image};
+		painter.setPen(parameters.color);
+		thumbnail.visualize({.sampleRect = QRect{-index * TileWidth, 0, parameters.sampleWidth, parameters.height},
+								.viewportRect = image.rect(),
+								.amplification = parameters.amplification,
+								.reversed = parameters.reversed},
+			painter);
+		painter.end();
+
+		QMetaObject::invokeMethod(QCoreApplication::instance(), [tiles, parameters, index, generation, image] {
+			if (tiles) { tiles->addTile(parameters, index, generation, image); }
+		}, Qt::QueuedConnection);
+	});
+}
+
+void SampleWaveformTiles::addTile(const Parameters& parameters, int index, unsigned generation, const QImage& image)
+{
+	if (generation != m_generation) { return; }
+
+	std::erase_if(m_pendingTiles,
+		[&](const PendingTile& tile) { return tile.index == index && tile.parameters == parameters; });
+
+	// Replace the tile drawn in another color, as that one will not be shown again for a while
+	if (const auto tile = findTile(parameters, index, true))
+	{
+		tile->parameters = parameters;
+		tile->pixmap = QPixmap::fromImage(image);
+		tile->lastUsed = ++m_useCount;
+		emit tileReady();
+		return;
+	}
+
+	if (m_tiles.size() >= MaxTiles)
+	{
+		const auto leastRecentlyUsed = std::min_element(m_tiles.begin(), m_tiles.end(),
+			[](const Tile& a, const Tile& b) { return a.lastUsed < b.lastUsed; });
+		m_tiles.erase(leastRecentlyUsed);
+	}
+
+	m_tiles.push_back(Tile{.parameters = parameters, .index = index, .pixmap = QPixmap::fromImage(image),
+		.lastUsed = ++m_useCount});
+	emit tileReady();
+}
+
+} // namespace lmms::gui
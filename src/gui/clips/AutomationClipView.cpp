@@ -23,6 +23,7 @@
  */
 #include "AutomationClipView.h"
 
+#include <algorithm>
 #include <QApplication>
 #include <QMouseEvent>
 #include <QPainter>
@@ -289,65 +290,60 @@ void AutomationClipView::paintEvent( QPaintEvent * )
 	lin2grad.setColorAt( 0, col.darker( 150 ) );
 
 	p.setRenderHints( QPainter::Antialiasing, true );
-	for( AutomationClip::timeMap::const_iterator it =
-						m_clip->getTimeMap().begin();
-					it != m_clip->getTimeMap().end(); ++it )
+	const auto& timeMap = m_clip->getTimeMap();
+	if (!timeMap.isEmpty())
 	{
-		const auto nit = std::next(it);
-
-		if (nit == m_clip->getTimeMap().end())
+		const float right = width() - BORDER_WIDTH;
+
+		// Draw the values from the first to the last node with about one
+		// bucket of the clip's level of detail per pixel, filling the area
+		// between them and 0
+		const auto& lod = m_clip->levelsOfDetail();
+		const int level = lod.levelFor(1.f / ppTick);
+		const auto lastTick = static_cast<tick_t>((right - offset) / ppTick) + 1;
+		QPolygonF upper;
+		QPolygonF lower;
+		tick_t bucketEnd = 0;
+		lod.forEachBucket(level, lod.begin(), lastTick + 1, [&](tick_t tick, const AutomationLod::Bucket& bucket) {
+			const float x = tick * ppTick + offset;
+			upper << QPointF(x, std::max(bucket.max, 0.f));
+			lower << QPointF(x, std::min(bucket.min, 0.f));
+			bucketEnd = std::min(tick + (1 << level), lod.end());
+		});
+		if (!upper.isEmpty())
 		{
-			const float x1 = POS(it) * ppTick + offset;
-			const auto x2 = (float)(width() - BORDER_WIDTH);
-			if( x1 > ( width() - BORDER_WIDTH ) ) break;
-			// We are drawing the space after the last node, so we use the outValue
+			upper << QPointF(bucketEnd * ppTick + offset, upper.last().y());
+			lower << QPointF(bucketEnd * ppTick + offset, lower.last().y());
+			std::reverse(lower.begin(), lower.end());
+			upper += lower;
+
+			QPainterPath path;
+			path.addPolygon(upper);
+			path.closeSubpath();
 			if( gradient() )
 			{
-				p.fillRect(QRectF(x1, 0.0f, x2 - x1, OUTVAL(it)), lin2grad);
+				p.fillPath( path, lin2grad );
 			}
 			else
 			{
-				p.fillRect(QRectF(x1, 0.0f, x2 - x1, OUTVAL(it)), col);
+				p.fillPath( path, col );
 			}
-			break;
-		}
-
-		float *values = m_clip->valuesAfter(POS(it));
-
-		// We are creating a path to draw a polygon representing the values between two
-		// nodes. When we have two nodes with discrete progression, we will basically have
-		// a rectangle with the outValue of the first node (that's why nextValue will match
-		// the outValue of the current node). When we have nodes with linear or cubic progression
-		// the value of the end of the shape between the two nodes will be the inValue of
-		// the next node.
-		float nextValue = m_clip->progressionType() == AutomationClip::ProgressionType::Discrete
-			? OUTVAL(it)
-			: INVAL(nit);
-
-		QPainterPath path;
-		QPointF origin = QPointF(POS(it) * ppTick + offset, 0.0f);
-		path.moveTo(origin);
-		path.moveTo(QPointF(POS(it) * ppTick + offset, values[0]));
-		for (int i = POS(it) + 1; i < POS(nit); ++i)
-		{
-			float x = i * ppTick + offset;
-			if(x > (width() - BORDER_WIDTH)) break;
-			float value = values[i - POS(it)];
-			path.lineTo(QPointF(x, value));
 		}
-		path.lineTo((POS(nit)) * ppTick + offset, nextValue);
-		path.lineTo((POS(nit)) * ppTick + offset, 0.0f);
-		path.lineTo(origin);
 
-		if( gradient() )
-		{
-			p.fillPath( path, lin2grad );
-		}
-		else
+		// We are drawing the space after the last node, so we use the outValue
+		const auto last = std::prev(timeMap.end());
+		const float x1 = POS(last) * ppTick + offset;
+		if (x1 <= right)
 		{
-			p.fillPath( path, col );
+			if( gradient() )
+			{
+				p.fillRect(QRectF(x1, 0.0f, right - x1, OUTVAL(last)), lin2grad);
+			}
+			else
+			{
+				p.fillRect(QRectF(x1, 0.0f, right - x1, OUTVAL(last)), col);
+			}
 		}
-		delete [] values;
 	}
 
 	p.setRenderHints( QPainter::Antialiasing, false );
@@ -151,8 +151,12 @@ ClipView::~ClipView()
 	// we have to give our track-container the focus because otherwise the
 	// op-buttons of our track-widgets could become focus and when the user
 	// presses space for playing song, just one of these buttons is pressed
-	// which results in unwanted effects
-	m_trackView->trackContainerView()->setFocus();
+	// which results in unwanted effects. Views of virtualized tracks are
+	// also deleted when scrolling, which must not take the focus elsewhere.
+	if( hasFocus() || !m_trackView->trackContainerView()->isVirtualized() )
+	{
+		m_trackView->trackContainerView()->setFocus();
+	}
 }
 
 
@@ -35,6 +35,7 @@
 #include "PathUtil.h"
 #include "SampleClip.h"
 #include "SampleThumbnail.h"
+#include "SampleWaveformTiles.h"
 #include "Song.h"
 #include "StringPairDrag.h"
 #include "TrackContainerView.h"
@@ -58,6 +59,19 @@ SampleClipView::SampleClipView( SampleClip * _clip, TrackView * _tv ) :
 
 	connect(m_clip, SIGNAL(wasReversed()), this, SLOT(update()));
 
+	// redraw once the waveform has been generated in the background
+	connect(SampleThumbnail::notifier(), &SampleThumbnailNotifier::thumbnailReady, this, [this]
+	{
+		if (m_thumbnailPending && m_sampleThumbnail.isReady())
+		{
+			m_thumbnailPending = false;
+			update();
+		}
+	});
+
+	// redraw once newly exposed parts of the waveform have been rendered
+	connect(&m_waveformTiles, &SampleWaveformTiles::tileReady, this, [this] { update(); });
+
 	setStyle( QApplication::style() );
 }
 
@@ -66,6 +80,8 @@ void SampleClipView::updateSample()
 	update();
 
 	m_sampleThumbnail = SampleThumbnail{m_clip->m_sample};
+	m_thumbnailPending = !m_sampleThumbnail.isReady();
+	m_waveformTiles.setThumbnail(m_sampleThumbnail);
 
 	// set tooltip to filename so that user can see what sample this
 	// sample-clip contains
@@ -288,14 +304,15 @@ void SampleClipView::paintEvent( QPaintEvent * pe )
 
 	if (sample.sampleSize() > 0)
 	{
-		const auto param = SampleThumbnail::VisualizeParameters{
-			.sampleRect = QRect(sampleRextX, spacing, sampleLength, height() - spacing),
-			.viewportRect = viewPortRect,
+		const auto param = SampleWaveformTiles::Parameters{
+			.sampleWidth = static_cast<int>(sampleLength),
+			.height = height() - spacing,
 			.amplification = sample.amplification(),
-			.reversed = sample.reversed()
+			.reversed = sample.reversed(),
+			.color = p.pen().color()
 		};
 
-		m_sampleThumbnail.visualize(param, p);
+		m_waveformTiles.draw(p, QPoint(sampleRextX, spacing), param, viewPortRect);
 	}
 
 	QString name = PathUtil::cleanName(m_clip->m_sample.sampleFile());
@@ -35,7 +35,9 @@
 #include <QScrollBar>
 #include <QStyleOption>
 #include <QToolTip>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "ActionGroup.h"
 #include "AutomationNode.h"
@@ -106,6 +108,10 @@ AutomationEditor::AutomationEditor() :
 				Qt::QueuedConnection );
 	connect( Engine::getSong(), SIGNAL(timeSignatureChanged(int,int)),
 						this, SLOT(update()));
+	connect(SampleThumbnail::notifier(), &SampleThumbnailNotifier::thumbnailReady, this, [this]
+	{
+		if (m_renderSample) { update(); }
+	});
 
 	//keeps the direction of the widget, undepended on the locale
 	setLayoutDirection( Qt::LeftToRight );
@@ -892,6 +898,7 @@ void AutomationEditor::mouseMoveEvent(QMouseEvent * mouseEvent )
 					{
 						it.value().setInTangent(newTangent);
 					}
+					m_clip->invalidateCurve(POS(it), POS(it));
 				}
 				else if (m_mouseDownRight && m_action == Action::ResetTangents)
 				{
@@ -1304,66 +1311,61 @@ void AutomationEditor::paintEvent(QPaintEvent * pe )
 	// Don't bother doing/rendering anything if there is no automation points
 	if (time_map.size() > 0)
 	{
-		timeMap::iterator it = time_map.begin();
-		while (std::next(it) != time_map.end())
+		const int ticksPerBar = TimePos::ticksPerBar();
+		const int firstTick = m_currentPosition - VALUES_WIDTH * ticksPerBar / m_ppb - 1;
+		const int lastTick = m_currentPosition + (width() - VALUES_WIDTH) * ticksPerBar / m_ppb + 1;
+
+		// Draw the values from the first to the last node with about one bucket
+		// of the clip's level of detail per pixel. As before, the area between
+		// the values and level 0 is filled.
+		const auto& lod = m_clip->levelsOfDetail();
+		const int level = lod.levelFor(static_cast<float>(ticksPerBar) / m_ppb);
+		QPolygonF upper;
+		QPolygonF lower;
+		int bucketEnd = 0;
+		lod.forEachBucket(level, firstTick, lastTick + 1, [&](tick_t tick, const AutomationLod::Bucket& bucket) {
+			const int x = xCoordOfTick(tick);
+			upper << QPointF(x, yCoordOfLevel(std::max(bucket.max, 0.f)));
+			lower << QPointF(x, yCoordOfLevel(std::min(bucket.min, 0.f)));
+			bucketEnd = std::min(tick + (1 << level), lod.end());
+		});
+		if (!upper.isEmpty())
 		{
-			// skip this section if it occurs completely before the
-			// visible area
-			const auto nit = std::next(it);
-
-			int next_x = xCoordOfTick(POS(nit));
-			if (next_x < 0)
-			{
-				++it;
-				continue;
-			}
-
-			int x = xCoordOfTick(POS(it));
-			if (x > width()) { break; }
-
-			float* values = m_clip->valuesAfter(POS(it));
-
-			// We are creating a path to draw a polygon representing the values between two
-			// nodes. When we have two nodes with discrete progression, we will basically have
-			// a rectangle with the outValue of the first node (that's why nextValue will match
-			// the outValue of the current node). When we have nodes with linear or cubic progression
-			// the value of the end of the shape between the two nodes will be the inValue of
-			// the next node.
-			float nextValue
-				= m_clip->progressionType() == AutomationClip::ProgressionType::Discrete ? OUTVAL(it) : INVAL(nit);
+			upper << QPointF(xCoordOfTick(bucketEnd), upper.last().y());
+			lower << QPointF(xCoordOfTick(bucketEnd), lower.last().y());
+			std::reverse(lower.begin(), lower.end());
+			upper += lower;
 
-			p.setRenderHints(QPainter::Antialiasing, true);
 			QPainterPath path;
-			path.moveTo(QPointF(xCoordOfTick(POS(it)), yCoordOfLevel(0)));
-			for (int i = 0; i < POS(nit) - POS(it); ++i)
-			{
-				path.lineTo(QPointF(xCoordOfTick(POS(it) + i), yCoordOfLevel(values[i])));
-			}
-			path.lineTo(QPointF(xCoordOfTick(POS(nit)), yCoordOfLevel(nextValue)));
-			path.lineTo(QPointF(xCoordOfTick(POS(nit)), yCoordOfLevel(0)));
-			path.lineTo(QPointF(xCoordOfTick(POS(it)), yCoordOfLevel(0)));
+			path.addPolygon(upper);
+			path.closeSubpath();
+			p.setRenderHints(QPainter::Antialiasing, true);
 			p.fillPath(path, m_graphColor);
 			p.setRenderHints(QPainter::Antialiasing, false);
-			delete[] values;
-
-			// Draw circle
-			drawAutomationPoint(p, it);
-			// Draw tangents if necessary (only for manually edited tangents)
-			if (m_clip->canEditTangents() && LOCKEDTAN(it)) { drawAutomationTangents(p, it); }
-
-			++it;
 		}
 
-		for (int i = POS(it), x = xCoordOfTick(i); x <= width(); i++, x = xCoordOfTick(i))
+		const auto last = std::prev(time_map.end());
+		for (int i = std::max(POS(last), firstTick), x = xCoordOfTick(i); x <= width(); i++, x = xCoordOfTick(i))
 		{
 			// Draws the rectangle representing the value after the last node (for
 			// that reason we use outValue).
-			drawLevelTick(p, i, OUTVAL(it));
+			drawLevelTick(p, i, OUTVAL(last));
+		}
+
+		// Draw the visible nodes, leaving out those too close to the previous
+		// one to be told apart
+		int lastNodeX = std::numeric_limits<int>::min();
+		for (auto it = time_map.lowerBound(firstTick), end = time_map.upperBound(lastTick); it != end; ++it)
+		{
+			const int x = xCoordOfTick(POS(it));
+			if (x - lastNodeX < 2 && it != last) { continue; }
+			lastNodeX = x;
+
+			// Draw circle
+			drawAutomationPoint(p, it);
+			// Draw tangents if necessary (only for manually edited tangents)
+			if (m_clip->canEditTangents() && LOCKEDTAN(it)) { drawAutomationTangents(p, it); }
 		}
-		// Draw circle(the last one)
-		drawAutomationPoint(p, it);
-		// Draw tangents if necessary (only for manually edited tangents)
-		if (m_clip->canEditTangents() && LOCKEDTAN(it)) { drawAutomationTangents(p, it); }
 	}
 
 	// draw clip bounds overlay
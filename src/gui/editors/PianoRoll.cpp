@@ -136,6 +136,55 @@ static QString getNoteString(int key)
 	return s_noteStrings[key % 12] + QString::number(static_cast<int>(FirstOctave + key / KeysPerOctave));
 }
 
+struct NotesHash
+{
+	std::size_t geometry = 0; //!< which notes there are and where they are
+	std::size_t appearance = 0; //!< how they look apart from that
+};
+
+static void hashCombine(std::size_t& seed, std::size_t value)
+{
+	seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+//! The piano roll edits notes in place without signaling it, so the note layer
+//! compares a hash of the notes instead
+static NotesHash hashNotes(const NoteVector& notes)
+{
+	auto hash = NotesHash{};
+	hashCombine(hash.geometry, notes.size());
+	for (const Note* note : notes)
+	{
+		hashCombine(hash.geometry, std::hash<const Note*>{}(note));
+		hashCombine(hash.geometry, static_cast<std::size_t>(note->pos().getTicks()));
+		hashCombine(hash.geometry, static_cast<std::size_t>(note->length().getTicks()));
+		hashCombine(hash.geometry, static_cast<std::size_t>(note->key()));
+		if (const auto& detuning = note->detuning())
+		{
+			const auto& timeMap = detuning->automationClip()->getTimeMap();
+			hashCombine(hash.geometry, static_cast<std::size_t>(timeMap.size()));
+			hashCombine(hash.geometry, timeMap.isEmpty() ? 0 : static_cast<std::size_t>(timeMap.lastKey()));
+
+			// Detuning curves are also edited in place, e.g. in the automation editor or by undo
+			hashCombine(hash.appearance, static_cast<std::size_t>(detuning->automationClip()->progressionType()));
+			for (auto it = timeMap.begin(); it != timeMap.end(); ++it)
+			{
+				hashCombine(hash.appearance, static_cast<std::size_t>(it.key()));
+				hashCombine(hash.appearance, std::hash<float>{}(it->getInValue()));
+				hashCombine(hash.appearance, std::hash<float>{}(it->getOutValue()));
+				hashCombine(hash.appearance, std::hash<float>{}(it->getInTangent()));
+				hashCombine(hash.appearance, std::hash<float>{}(it->getOutTangent()));
+			}
+		}
+
+		hashCombine(hash.appearance, note->selected());
+		hashCombine(hash.appearance, static_cast<std::size_t>(note->getVolume()));
+		hashCombine(hash.appearance, static_cast<std::size_t>(note->getPanning()));
+		hashCombine(hash.appearance, static_cast<std::size_t>(note->type()));
+	}
+	return hash;
+}
+
 // used for drawing of piano
 std::array<PianoRoll::KeyType, 12> PianoRoll::prKeyOrder
 {
@@ -3306,18 +3355,17 @@ void PianoRoll::paintEvent(QPaintEvent * pe )
 {
 	bool drawNoteNames = ConfigManager::inst()->value( "ui", "printnotelabels").toInt();
 
-	QStyleOption opt;
-	opt.initFrom( this );
 	QPainter p( this );
-	style()->drawPrimitive( QStyle::PE_Widget, &opt, &p, this );
-
-	QBrush bgColor = p.background();
-
-	// fill with bg color
-	p.fillRect( 0, 0, width(), height(), bgColor );
 
 	if (!hasValidMidiClip())
 	{
+		QStyleOption opt;
+		opt.initFrom( this );
+		style()->drawPrimitive( QStyle::PE_Widget, &opt, &p, this );
+
+		// fill with bg color
+		p.fillRect( 0, 0, width(), height(), p.background() );
+
 		const auto icon = embed::getIconPixmap("pr_no_clip");
 		const int x = (width() - icon.width()) / 2;
 		const int y = (height() - icon.height()) / 2;
@@ -3330,354 +3378,77 @@ void PianoRoll::paintEvent(QPaintEvent * pe )
 		return;
 	}
 
-	// set font-size to 80% of key line height
-	QFont f = p.font();
-	int keyFontSize = m_keyLineHeight * 0.8;
-	p.setFont(adjustedToPixelSize(f, keyFontSize));
-	QFontMetrics fontMetrics(p.font());
-	// G-1 is one of the widest; plus one pixel margin for the shadow
-	QRect const boundingRect = fontMetrics.boundingRect(QString("G-1")) + QMargins(0, 0, 1, 0);
-
-	auto xCoordOfTick = [this](int tick) {
-		return m_whiteKeyWidth + (
-			(tick - m_currentPosition) * m_ppb / TimePos::ticksPerBar()
-		);
-	};
-
-	// Order of drawing
-	// - vertical quantization lines
-	// - piano roll + horizontal key lines
-	// - alternating bar colors
-	// - vertical beat lines
-	// - vertical bar lines
-	// - marked semitones
-	// - note editing
-	// - notes
-	// - selection frame
-	// - highlight hovered note
-	// - note edit area resize bar
-	// - cursor mode icon
-
-	if (hasValidMidiClip())
-	{
-		int pianoAreaHeight = keyAreaBottom() - keyAreaTop();
-		m_pianoKeysVisible = pianoAreaHeight / m_keyLineHeight;
-		int partialKeyVisible = pianoAreaHeight % m_keyLineHeight;
-		// check if we're below the minimum key area size
-		if (m_pianoKeysVisible * m_keyLineHeight < KEY_AREA_MIN_HEIGHT)
-		{
-			m_pianoKeysVisible = KEY_AREA_MIN_HEIGHT / m_keyLineHeight;
-			partialKeyVisible = KEY_AREA_MIN_HEIGHT % m_keyLineHeight;
-			// if we have a partial key, just show it
-			if (partialKeyVisible > 0)
-			{
-				m_pianoKeysVisible += 1;
-				partialKeyVisible = 0;
-			}
-			// have to modify the notes edit area height instead
-			m_notesEditHeight = height() - (m_pianoKeysVisible * m_keyLineHeight)
-				- PR_TOP_MARGIN - PR_BOTTOM_MARGIN;
-		}
-		// check if we're trying to show more keys than available
-		else if (m_pianoKeysVisible >= NumKeys)
-		{
-			m_pianoKeysVisible = NumKeys;
-			// have to modify the notes edit area height instead
-			m_notesEditHeight = height() - (NumKeys * m_keyLineHeight) -
-				PR_TOP_MARGIN - PR_BOTTOM_MARGIN;
+	// The editor is drawn in three layers:
+	// - the grid layer with the piano keys, the grid lines, bar shading and
+	//   marked semitones, cached until the view or the key states change
+	// - the note layer with ghost notes, notes, note editing bars and
+	//   detuning curves, cached until the view or the notes change
+	// - the overlay with clip bounds, knife line, step recording notes,
+	//   selection frame, the key under the cursor, the note edit area resize
+	//   bar and the cursor mode icon, which is drawn on every repaint
+	// Moving the position line or the cursor only repaints the overlay and
+	// copies the cached layers.
+
+	int pianoAreaHeight = keyAreaBottom() - keyAreaTop();
+	m_pianoKeysVisible = pianoAreaHeight / m_keyLineHeight;
+	int partialKeyVisible = pianoAreaHeight % m_keyLineHeight;
+	// check if we're below the minimum key area size
+	if (m_pianoKeysVisible * m_keyLineHeight < KEY_AREA_MIN_HEIGHT)
+	{
+		m_pianoKeysVisible = KEY_AREA_MIN_HEIGHT / m_keyLineHeight;
+		partialKeyVisible = KEY_AREA_MIN_HEIGHT % m_keyLineHeight;
+		// if we have a partial key, just show it
+		if (partialKeyVisible > 0)
+		{
+			m_pianoKeysVisible += 1;
 			partialKeyVisible = 0;
 		}
-		int topKey = std::clamp(m_startKey + m_pianoKeysVisible - 1, 0, NumKeys - 1);
-		int topNote = topKey % KeysPerOctave;
-		// if not resizing the note edit area, we can change m_notesEditHeight
-		if (m_action != Action::ResizeNoteEditArea && partialKeyVisible != 0)
-		{
-			// calculate the height change adding and subtracting the partial key
-			int noteAreaPlus = (m_notesEditHeight + partialKeyVisible) - m_userSetNotesEditHeight;
-			int noteAreaMinus = m_userSetNotesEditHeight - (m_notesEditHeight - partialKeyVisible);
-			// if adding the partial key to height is more distant from the set height
-			// we want to subtract the partial key
-			if (noteAreaPlus > noteAreaMinus)
-			{
-				m_notesEditHeight -= partialKeyVisible;
-				// since we're adding a partial key, we add one to the number visible
-				m_pianoKeysVisible += 1;
-			}
-			// otherwise we add height
-			else { m_notesEditHeight += partialKeyVisible; }
-		}
-		int x, q = quantization(), tick;
-
-		// draw vertical quantization lines
-		// If we're over 100% zoom, we allow all quantization level grids
-		if (m_zoomingModel.value() <= 3)
-		{
-			// we're under 100% zoom
-			// allow quantization grid up to 1/24 for triplets
-			if (q % 3 != 0 && q < 8) { q = 8; }
-			// allow quantization grid up to 1/32 for normal notes
-			else if (q < 6) { q = 6; }
-		}
-    
-		p.setPen(m_lineColor);
-		for (tick = m_currentPosition - m_currentPosition % q,
-			x = xCoordOfTick(tick);
-			x <= width();
-			tick += q, x = xCoordOfTick(tick))
-		{
-			p.drawLine(x, keyAreaTop(), x, noteEditBottom());
-		}
-
-		// draw horizontal grid lines and piano notes
-		p.setClipRect(0, keyAreaTop(), width(), keyAreaBottom() - keyAreaTop());
-		// the first grid line from the top Y position
-		int grid_line_y = keyAreaTop() + m_keyLineHeight - 1;
-
-		// lambda function for returning the height of a key
-		auto keyHeight = [&](
-			const int key
-		) -> int
-		{
-			switch (prKeyOrder[key % KeysPerOctave])
-			{
-			case KeyType::WhiteBig:
-				return m_whiteKeyBigHeight;
-			case KeyType::WhiteSmall:
-				return m_whiteKeySmallHeight;
-			case KeyType::Black:
-				return m_blackKeyHeight;
-			}
-			return 0; // should never happen
-		};
-		// lambda function for returning the distance to the top of a key
-		auto gridCorrection = [&](
-			const int key
-		) -> int
-		{
-			const int keyCode = key % KeysPerOctave;
-			switch (prKeyOrder[keyCode])
-			{
-			case KeyType::WhiteBig:
-				return m_whiteKeySmallHeight;
-			case KeyType::WhiteSmall:
-				// These two keys need to adjust up small height instead of only key line height
-				if (static_cast<Key>(keyCode) == Key::C || static_cast<Key>(keyCode) == Key::F)
-				{
-					return m_whiteKeySmallHeight;
-				}
-			case KeyType::Black:
-				return m_blackKeyHeight;
-			}
-			return 0; // should never happen
-		};
-		auto keyWidth = [&](
-			const int key
-		) -> int
-		{
-			switch (prKeyOrder[key % KeysPerOctave])
-			{
-			case KeyType::WhiteSmall:
-			case KeyType::WhiteBig:
-				return m_whiteKeyWidth;
-			case KeyType::Black:
-				return m_blackKeyWidth;
-			}
-			return 0; // should never happen
-		};
-		// lambda function to draw a key
-		auto drawKey = [&](
-			const int key,
-			const int yb)
-		{
-			const bool mapped = m_midiClip->instrumentTrack()->isKeyMapped(key);
-			const bool pressed = m_midiClip->instrumentTrack()->pianoModel()->isKeyPressed(key);
-			const int keyCode = key % KeysPerOctave;
-			const int yt = yb - gridCorrection(key);
-			const int kh = keyHeight(key);
-			const int kw = keyWidth(key);
-			// set key colors
-			p.setPen(QColor(0, 0, 0));
-			switch (prKeyOrder[keyCode])
-			{
-			case KeyType::WhiteSmall:
-			case KeyType::WhiteBig:
-				if (mapped)
-				{
-					if (pressed) { p.setBrush(m_whiteKeyActiveBackground); }
-					else { p.setBrush(m_whiteKeyInactiveBackground); }
-				}
-				else
-				{
-					p.setBrush(m_whiteKeyDisabledBackground);
-				}
-				break;
-			case KeyType::Black:
-				if (mapped)
-				{
-					if (pressed) { p.setBrush(m_blackKeyActiveBackground); }
-					else { p.setBrush(m_blackKeyInactiveBackground); }
-				}
-				else
-				{
-					p.setBrush(m_blackKeyDisabledBackground);
-				}
-			}
-			// draw key
-			p.drawRect(PIANO_X, yt, kw, kh);
-			// draw note name
-			if (static_cast<Key>(keyCode) == Key::C || (drawNoteNames && Piano::isWhiteKey(key)))
-			{
-				// small font sizes have 1 pixel offset instead of 2
-				auto zoomOffset = m_zoomYLevels[m_zoomingYModel.value()] > 1.0f ? 2 : 1;
-				QString noteString = getNoteString(key);
-				QRect textRect(
-					m_whiteKeyWidth - boundingRect.width() - 2,
-					yb - m_keyLineHeight + zoomOffset,
-					boundingRect.width(),
-					boundingRect.height()
-				);
-				p.setPen(pressed ? m_whiteKeyActiveTextShadow : m_whiteKeyInactiveTextShadow);
-				p.drawText(textRect.adjusted(0, 1, 1, 0), Qt::AlignRight | Qt::AlignHCenter, noteString);
-				p.setPen(pressed ? m_whiteKeyActiveTextColor : m_whiteKeyInactiveTextColor);
-				// if (static_cast<Key>(keyCode) == Key::C) { p.setPen(textColor()); }
-				// else { p.setPen(textColorLight()); }
-				p.drawText(textRect, Qt::AlignRight | Qt::AlignHCenter, noteString);
-			}
-		};
-		// lambda for drawing the horizontal grid line
-		auto drawHorizontalLine = [&](
-			const int key,
-			const int y
-		)
-		{
-			if (static_cast<Key>(key % KeysPerOctave) == Key::C) { p.setPen(m_beatLineColor); }
-			else { p.setPen(m_lineColor); }
-			p.drawLine(m_whiteKeyWidth, y, width(), y);
-		};
-		// correct y offset of the top key
-		switch (prKeyOrder[topNote])
-		{
-		case KeyType::WhiteSmall:
-		case KeyType::WhiteBig:
-			break;
-		case KeyType::Black:
-			// draw extra white key
-			drawKey(topKey + 1, grid_line_y - m_keyLineHeight);
-		}
-		// loop through visible keys
-		const int lastKey = qMax(0, topKey - m_pianoKeysVisible);
-		for (int key = topKey; key > lastKey; --key)
-		{
-			bool whiteKey = Piano::isWhiteKey(key);
-			if (whiteKey)
-			{
-				drawKey(key, grid_line_y);
-				drawHorizontalLine(key, grid_line_y);
-				grid_line_y += m_keyLineHeight;
-			}
-			else
-			{
-				// draw next white key
-				drawKey(key - 1, grid_line_y + m_keyLineHeight);
-				drawHorizontalLine(key - 1, grid_line_y + m_keyLineHeight);
-				// draw black key over previous and next white key
-				drawKey(key, grid_line_y);
-				drawHorizontalLine(key, grid_line_y);
-				// drew two grid keys so skip ahead properly
-				grid_line_y += m_keyLineHeight + m_keyLineHeight;
-				// capture double key draw
-				--key;
-			}
-		}
-
-		// don't draw over keys
-		p.setClipRect(m_whiteKeyWidth, keyAreaTop(), width(), noteEditBottom() - keyAreaTop());
-
-		// draw alternating shading on bars
-		float timeSignature =
-			static_cast<float>(Engine::getSong()->getTimeSigModel().getNumerator()) /
-			static_cast<float>(Engine::getSong()->getTimeSigModel().getDenominator());
-		float zoomFactor = m_zoomLevels[m_zoomingModel.value()];
-		//the bars which disappears at the left side by scrolling
-		int leftBars = m_currentPosition * zoomFactor / TimePos::ticksPerBar();
-		//iterates the visible bars and draw the shading on uneven bars
-		for (int x = m_whiteKeyWidth, barCount = leftBars;
-			x < width() + m_currentPosition * zoomFactor / timeSignature;
-			x += m_ppb, ++barCount)
-		{
-			if ((barCount + leftBars) % 2 != 0)
-			{
-				p.fillRect(x - m_currentPosition * zoomFactor / timeSignature,
-					PR_TOP_MARGIN,
-					m_ppb,
-					height() - (PR_BOTTOM_MARGIN + PR_TOP_MARGIN),
-					m_backgroundShade);
-			}
-		}
-
-		// draw vertical beat lines
-		int ticksPerBeat = DefaultTicksPerBar /
-			Engine::getSong()->getTimeSigModel().getDenominator();
-		p.setPen(m_beatLineColor);
-		for(tick = m_currentPosition - m_currentPosition % ticksPerBeat,
-			x = xCoordOfTick( tick );
-			x <= width();
-			tick += ticksPerBeat, x = xCoordOfTick(tick))
-		{
-			p.drawLine(x, PR_TOP_MARGIN, x, noteEditBottom());
-		}
-
-		// draw vertical bar lines
-		p.setPen(m_barLineColor);
-		for(tick = m_currentPosition - m_currentPosition % TimePos::ticksPerBar(),
-			x = xCoordOfTick( tick );
-			x <= width();
-			tick += TimePos::ticksPerBar(), x = xCoordOfTick(tick))
-		{
-			p.drawLine(x, PR_TOP_MARGIN, x, noteEditBottom());
-		}
-
-		// draw marked semitones after the grid
-		for(x = 0; x < m_markedSemiTones.size(); ++x)
+		// have to modify the notes edit area height instead
+		m_notesEditHeight = height() - (m_pianoKeysVisible * m_keyLineHeight)
+			- PR_TOP_MARGIN - PR_BOTTOM_MARGIN;
+	}
+	// check if we're trying to show more keys than available
+	else if (m_pianoKeysVisible >= NumKeys)
+	{
+		m_pianoKeysVisible = NumKeys;
+		// have to modify the notes edit area height instead
+		m_notesEditHeight = height() - (NumKeys * m_keyLineHeight) -
+			PR_TOP_MARGIN - PR_BOTTOM_MARGIN;
+		partialKeyVisible = 0;
+	}
+	int topKey = std::clamp(m_startKey + m_pianoKeysVisible - 1, 0, NumKeys - 1);
+	// if not resizing the note edit area, we can change m_notesEditHeight
+	if (m_action != Action::ResizeNoteEditArea && partialKeyVisible != 0)
+	{
+		// calculate the height change adding and subtracting the partial key
+		int noteAreaPlus = (m_notesEditHeight + partialKeyVisible) - m_userSetNotesEditHeight;
+		int noteAreaMinus = m_userSetNotesEditHeight - (m_notesEditHeight - partialKeyVisible);
+		// if adding the partial key to height is more distant from the set height
+		// we want to subtract the partial key
+		if (noteAreaPlus > noteAreaMinus)
 		{
-			const int key_num = m_markedSemiTones.at(x);
-			const int y = yCoordOfKey(key_num);
-			if(y >= keyAreaBottom() - 1) { break; }
-			p.fillRect(m_whiteKeyWidth + 1,
-				y,
-				width() - 10,
-				m_keyLineHeight,
-				m_markedSemitoneColor);
+			m_notesEditHeight -= partialKeyVisible;
+			// since we're adding a partial key, we add one to the number visible
+			m_pianoKeysVisible += 1;
 		}
+		// otherwise we add height
+		else { m_notesEditHeight += partialKeyVisible; }
 	}
 
-	// reset MIDI clip
-	p.setClipRect(0, 0, width(), height());
-
-	// erase the area below the piano, because there might be keys that
-	// should be only half-visible
-	p.fillRect( QRect( 0, keyAreaBottom(),
-			m_whiteKeyWidth, noteEditBottom() - keyAreaBottom()), bgColor);
+	renderGridLayer(topKey, drawNoteNames);
+	renderNoteLayer(topKey, drawNoteNames);
+	p.drawPixmap(0, 0, m_gridLayer);
+	p.drawPixmap(0, 0, m_noteLayer);
 
-	// display note editing info
+	QFont f = p.font();
 	f.setBold(false);
 	p.setFont(adjustedToPixelSize(f, SMALL_FONT_SIZE));
-	p.setPen(m_noteModeColor);
-	p.drawText( QRect( 0, keyAreaBottom(),
-					  m_whiteKeyWidth, noteEditBottom() - keyAreaBottom()),
-			   Qt::AlignCenter | Qt::TextWordWrap,
-			   m_nemStr.at(static_cast<int>(m_noteEditMode)) + ":" );
 
-	// set clipping area, because we are not allowed to paint over
-	// keyboard...
-	p.setClipRect(
-		m_whiteKeyWidth,
-		PR_TOP_MARGIN,
-		width() - m_whiteKeyWidth,
-		height() - PR_TOP_MARGIN - PR_BOTTOM_MARGIN);
-
-	// following code draws all notes in visible area
-	// and the note editing stuff (volume, panning, etc)
+	auto xCoordOfTick = [this](int tick) {
+		return m_whiteKeyWidth + (
+			(tick - m_currentPosition) * m_ppb / TimePos::ticksPerBar()
+		);
+	};
 
 	// setup selection-vars
 	int sel_pos_start = m_selectStartTick;
@@ -3695,229 +3466,82 @@ void PianoRoll::paintEvent(QPaintEvent * pe )
 	}
 
 	int y_base = keyAreaBottom() - 1;
-	if( hasValidMidiClip() )
-	{
-		p.setClipRect(
-			m_whiteKeyWidth,
-			PR_TOP_MARGIN,
-			width() - m_whiteKeyWidth,
-			height() - PR_TOP_MARGIN);
-
-		const int topKey = qBound(0, m_startKey + m_pianoKeysVisible - 1, NumKeys - 1);
-		const int bottomKey = topKey - m_pianoKeysVisible;
-
-		QPolygonF editHandles;
 
-		// Return a note's Y position on the grid
-		auto noteYPos = [&](const int key)
-		{
-			return (topKey - key) * m_keyLineHeight + keyAreaTop() - 1;
-		};
+	p.setClipRect(
+		m_whiteKeyWidth,
+		PR_TOP_MARGIN,
+		width() - m_whiteKeyWidth,
+		height() - PR_TOP_MARGIN);
 
-		// -- Begin ghost MIDI clip
-		if( !m_ghostNotes.empty() )
-		{
-			for( const Note *note : m_ghostNotes )
-			{
-				int len_ticks = note->length();
+	const int bottomKey = topKey - m_pianoKeysVisible;
 
-				if( len_ticks == 0 )
-				{
-					continue;
-				}
-				else if( len_ticks < 0 )
-				{
-					len_ticks = 4;
-				}
-
-				int pos_ticks = note->pos();
+	// Return a note's Y position on the grid
+	auto noteYPos = [&](const int key)
+	{
+		return (topKey - key) * m_keyLineHeight + keyAreaTop() - 1;
+	};
 
-				int note_width = len_ticks * m_ppb / TimePos::ticksPerBar();
-				const int x = ( pos_ticks - m_currentPosition ) *
-						m_ppb / TimePos::ticksPerBar();
-				// skip this note if not in visible area at all
-				if (!(x + note_width >= 0 && x <= width() - m_whiteKeyWidth))
-				{
-					continue;
-				}
+	// draw clip bounds
+	p.fillRect(
+		xCoordOfTick(m_midiClip->length() - m_midiClip->startTimeOffset()),
+		PR_TOP_MARGIN,
+		width() - 10,
+		noteEditBottom(),
+		m_outOfBoundsShade
+	);
+	p.fillRect(
+		0,
+		PR_TOP_MARGIN,
+		xCoordOfTick(-m_midiClip->startTimeOffset()),
+		noteEditBottom(),
+		m_outOfBoundsShade
+	);
 
-				// is the note in visible area?
-				if (note->key() > bottomKey && note->key() <= topKey)
-				{
+	// -- Knife tool (draw cut line)
+	if (m_action == Action::Knife && m_knifeDown)
+	{
+		int x1 = xCoordOfTick(m_knifeStartTickPos);
+		int y1 = y_base - (m_knifeStartKey - m_startKey + 1) * m_keyLineHeight;
+		int x2 = xCoordOfTick(m_knifeEndTickPos);
+		int y2 = y_base - (m_knifeEndKey - m_startKey + 1) * m_keyLineHeight;
 
-					// we've done and checked all, let's draw the note
-					drawNoteRect(
-						p, x + m_whiteKeyWidth, noteYPos(note->key()), note_width,
-						note, m_ghostNoteColor, m_ghostNoteTextColor, m_selectedNoteColor,
-						m_ghostNoteOpacity, m_ghostNoteBorders, drawNoteNames);
-				}
+		p.setPen(QPen(m_knifeCutLineColor, 1));
+		p.drawLine(x1, y1, x2, y2);
+	}
+	// -- End knife tool
 
-			}
-		}
-		// -- End ghost MIDI clip
+	//draw current step recording notes
+	for( const Note *note : m_stepRecorder.getCurStepNotes() )
+	{
+		int len_ticks = note->length();
 
-		for( const Note *note : m_midiClip->notes() )
+		if( len_ticks == 0 )
 		{
-			int len_ticks = note->length();
-
-			if( len_ticks == 0 )
-			{
-				continue;
-			}
-			else if( len_ticks < 0 )
-			{
-				len_ticks = 4;
-			}
-
-			int pos_ticks = note->pos();
-			int note_width = len_ticks * m_ppb / TimePos::ticksPerBar();
-
-			int detuningLength = note->detuning() != nullptr && !note->detuning()->automationClip()->getTimeMap().isEmpty()
-				? note->detuning()->automationClip()->getTimeMap().lastKey() * m_ppb / TimePos::ticksPerBar()
-				: note_width;
-
-			const int x = ( pos_ticks - m_currentPosition ) *
-					m_ppb / TimePos::ticksPerBar();
-			// Skip this note if not in visible area at all
-			// But still draw the note if the detuning curve extends past the end of it.
-			if (!(x + std::max(note_width, detuningLength) >= 0 && x <= width() - m_whiteKeyWidth))
-			{
-				continue;
-			}
-
-			// is the note in visible area?
-			if (note->key() > bottomKey && note->key() <= topKey)
-			{
-				// We've done and checked all, let's draw the note with
-				// the appropriate color
-				const auto fillColor = note->type() == Note::Type::Regular ? m_noteColor : m_stepNoteColor;
-
-				drawNoteRect(
-					p, x + m_whiteKeyWidth, noteYPos(note->key()), note_width,
-					note, fillColor, m_noteTextColor, m_selectedNoteColor,
-					m_noteOpacity, m_noteBorders, drawNoteNames
-				);
-			}
-
-			// draw note editing stuff
-			int editHandleTop = 0;
-			if( m_noteEditMode == NoteEditMode::Volume )
-			{
-				QColor color = m_barColor.lighter(30 + (note->getVolume() * 90 / MaxVolume));
-				if( note->selected() )
-				{
-					color = m_selectedNoteColor;
-				}
-				p.setPen( QPen( color, NOTE_EDIT_LINE_WIDTH ) );
-
-				editHandleTop = noteEditBottom() -
-					( (float)( note->getVolume() - MinVolume ) ) /
-					( (float)( MaxVolume - MinVolume ) ) *
-					( (float)( noteEditBottom() - noteEditTop() ) );
-
-				p.drawLine( QLineF ( noteEditLeft() + x + 0.5, editHandleTop + 0.5,
-							noteEditLeft() + x + 0.5, noteEditBottom() + 0.5 ) );
-
-			}
-			else if( m_noteEditMode == NoteEditMode::Panning )
-			{
-				QColor color = m_noteColor;
-				if( note->selected() )
-				{
-					color = m_selectedNoteColor;
-				}
-
-				p.setPen( QPen( color, NOTE_EDIT_LINE_WIDTH ) );
-
-				editHandleTop = noteEditBottom() -
-					( (float)( note->getPanning() - PanningLeft ) ) /
-					( (float)( (PanningRight - PanningLeft ) ) ) *
-					( (float)( noteEditBottom() - noteEditTop() ) );
-
-				p.drawLine( QLine( noteEditLeft() + x, noteEditTop() +
-						( (float)( noteEditBottom() - noteEditTop() ) ) / 2.0f,
-						    noteEditLeft() + x , editHandleTop ) );
-			}
-			editHandles << QPoint ( x + noteEditLeft(),
-						editHandleTop );
-
-			if( note->hasDetuningInfo() )
-			{
-				drawDetuningInfo(p, note, x + m_whiteKeyWidth, noteYPos(note->key()));
-				p.setClipRect(
-					m_whiteKeyWidth,
-					PR_TOP_MARGIN,
-					width() - m_whiteKeyWidth,
-					height() - PR_TOP_MARGIN);
-			}
+			continue;
 		}
 
-		// draw clip bounds
-		p.fillRect(
-			xCoordOfTick(m_midiClip->length() - m_midiClip->startTimeOffset()),
-			PR_TOP_MARGIN,
-			width() - 10,
-			noteEditBottom(),
-			m_outOfBoundsShade
-		);
-		p.fillRect(
-			0,
-			PR_TOP_MARGIN,
-			xCoordOfTick(-m_midiClip->startTimeOffset()),
-			noteEditBottom(),
-			m_outOfBoundsShade
-		);
 
-		// -- Knife tool (draw cut line)
-		if (m_action == Action::Knife && m_knifeDown)
-		{
-			int x1 = xCoordOfTick(m_knifeStartTickPos);
-			int y1 = y_base - (m_knifeStartKey - m_startKey + 1) * m_keyLineHeight;
-			int x2 = xCoordOfTick(m_knifeEndTickPos);
-			int y2 = y_base - (m_knifeEndKey - m_startKey + 1) * m_keyLineHeight;
+		int pos_ticks = note->pos();
 
-			p.setPen(QPen(m_knifeCutLineColor, 1));
-			p.drawLine(x1, y1, x2, y2);
+		int note_width = len_ticks * m_ppb / TimePos::ticksPerBar();
+		const int x = ( pos_ticks - m_currentPosition ) *
+				m_ppb / TimePos::ticksPerBar();
+		// skip this note if not in visible area at all
+		if (!(x + note_width >= 0 && x <= width() - m_whiteKeyWidth))
+		{
+			continue;
 		}
-		// -- End knife tool
 
-		//draw current step recording notes
-		for( const Note *note : m_stepRecorder.getCurStepNotes() )
+		// is the note in visible area?
+		if (note->key() > bottomKey && note->key() <= topKey)
 		{
-			int len_ticks = note->length();
-
-			if( len_ticks == 0 )
-			{
-				continue;
-			}
-
-
-			int pos_ticks = note->pos();
 
-			int note_width = len_ticks * m_ppb / TimePos::ticksPerBar();
-			const int x = ( pos_ticks - m_currentPosition ) *
-					m_ppb / TimePos::ticksPerBar();
-			// skip this note if not in visible area at all
-			if (!(x + note_width >= 0 && x <= width() - m_whiteKeyWidth))
-			{
-				continue;
-			}
-
-			// is the note in visible area?
-			if (note->key() > bottomKey && note->key() <= topKey)
-			{
-
-				// we've done and checked all, let's draw the note
-				drawNoteRect(
-					p, x + m_whiteKeyWidth, noteYPos(note->key()), note_width,
-					note, m_currentStepNoteColor, m_noteTextColor, m_selectedNoteColor,
-					m_noteOpacity, m_noteBorders, drawNoteNames);
-			}
+			// we've done and checked all, let's draw the note
+			drawNoteRect(
+				p, x + m_whiteKeyWidth, noteYPos(note->key()), note_width,
+				note, m_currentStepNoteColor, m_noteTextColor, m_selectedNoteColor,
+				m_noteOpacity, m_noteBorders, drawNoteNames);
 		}
-
-		p.setPen(QPen(m_noteColor, NOTE_EDIT_LINE_WIDTH + 2));
-		p.drawPoints( editHandles );
-
 	}
 
 	p.setClipRect(
@@ -4018,6 +3642,536 @@ void PianoRoll::paintEvent(QPaintEvent * pe )
 
 
 
+void PianoRoll::renderGridLayer(int topKey, bool drawNoteNames)
+{
+	const auto& timeSig = Engine::getSong()->getTimeSigModel();
+	auto layerKey = GridLayerKey{
+		size(), devicePixelRatioF(), m_currentPosition, m_startKey, topKey, m_pianoKeysVisible,
+		m_notesEditHeight, m_ppb, m_whiteKeyWidth, m_keyLineHeight, m_zoomingModel.value(), quantization(),
+		timeSig.getNumerator(), timeSig.getDenominator(), m_noteEditMode, drawNoteNames, m_markedSemiTones, {}, {}
+	};
+	for (int k = 0; k < NumKeys; ++k)
+	{
+		layerKey.mappedKeys[k] = m_midiClip->instrumentTrack()->isKeyMapped(k);
+		layerKey.pressedKeys[k] = m_midiClip->instrumentTrack()->pianoModel()->isKeyPressed(k);
+	}
+	if (!m_gridLayer.isNull() && layerKey == m_gridLayerKey) { return; }
+	m_gridLayerKey = std::move(layerKey);
+
+	m_gridLayer = QPixmap(size() * devicePixelRatioF());
+	m_gridLayer.setDevicePixelRatio(devicePixelRatioF());
+	m_gridLayer.fill(Qt::transparent);
+
+	QPainter p(&m_gridLayer);
+	// what a painter on the widget would start with
+	p.setPen(palette().color(foregroundRole()));
+	p.setBackground(palette().brush(backgroundRole()));
+	p.setFont(font());
+
+	QStyleOption opt;
+	opt.initFrom( this );
+	style()->drawPrimitive( QStyle::PE_Widget, &opt, &p, this );
+
+	QBrush bgColor = p.background();
+
+	// fill with bg color
+	p.fillRect( 0, 0, width(), height(), bgColor );
+
+	// set font-size to 80% of key line height
+	QFont f = p.font();
+	int keyFontSize = m_keyLineHeight * 0.8;
+	p.setFont(adjustedToPixelSize(f, keyFontSize));
+	QFontMetrics fontMetrics(p.font());
+	// G-1 is one of the widest; plus one pixel margin for the shadow
+	QRect const boundingRect = fontMetrics.boundingRect(QString("G-1")) + QMargins(0, 0, 1, 0);
+
+	auto xCoordOfTick = [this](int tick) {
+		return m_whiteKeyWidth + (
+			(tick - m_currentPosition) * m_ppb / TimePos::ticksPerBar()
+		);
+	};
+
+	int topNote = topKey % KeysPerOctave;
+	int x, q = quantization(), tick;
+
+	// draw vertical quantization lines
+	// If we're over 100% zoom, we allow all quantization level grids
+	if (m_zoomingModel.value() <= 3)
+	{
+		// we're under 100% zoom
+		// allow quantization grid up to 1/24 for triplets
+		if (q % 3 != 0 && q < 8) { q = 8; }
+		// allow quantization grid up to 1/32 for normal notes
+		else if (q < 6) { q = 6; }
+	}
+    
+	p.setPen(m_lineColor);
+	for (tick = m_currentPosition - m_currentPosition % q,
+		x = xCoordOfTick(tick);
+		x <= width();
+		tick += q, x = xCoordOfTick(tick))
+	{
+		p.drawLine(x, keyAreaTop(), x, noteEditBottom());
+	}
+
+	// draw horizontal grid lines and piano notes
+	p.setClipRect(0, keyAreaTop(), width(), keyAreaBottom() - keyAreaTop());
+	// the first grid line from the top Y position
+	int grid_line_y = keyAreaTop() + m_keyLineHeight - 1;
+
+	// lambda function for returning the height of a key
+	auto keyHeight = [&](
+		const int key
+	) -> int
+	{
+		switch (prKeyOrder[key % KeysPerOctave])
+		{
+		case KeyType::WhiteBig:
+			return m_whiteKeyBigHeight;
+		case KeyType::WhiteSmall:
+			return m_whiteKeySmallHeight;
+		case KeyType::Black:
+			return m_blackKeyHeight;
+		}
+		return 0; // should never happen
+	};
+	// lambda function for returning the distance to the top of a key
+	auto gridCorrection = [&](
+		const int key
+	) -> int
+	{
+		const int keyCode = key % KeysPerOctave;
+		switch (prKeyOrder[keyCode])
+		{
+		case KeyType::WhiteBig:
+			return m_whiteKeySmallHeight;
+		case KeyType::WhiteSmall:
+			// These two keys need to adjust up small height instead of only key line height
+			if (static_cast<Key>(keyCode) == Key::C || static_cast<Key>(keyCode) == Key::F)
+			{
+				return m_whiteKeySmallHeight;
+			}
+		case KeyType::Black:
+			return m_blackKeyHeight;
+		}
+		return 0; // should never happen
+	};
+	auto keyWidth = [&](
+		const int key
+	) -> int
+	{
+		switch (prKeyOrder[key % KeysPerOctave])
+		{
+		case KeyType::WhiteSmall:
+		case KeyType::WhiteBig:
+			return m_whiteKeyWidth;
+		case KeyType::Black:
+			return m_blackKeyWidth;
+		}
+		return 0; // should never happen
+	};
+	// lambda function to draw a key
+	auto drawKey = [&](
+		const int key,
+		const int yb)
+	{
+		const bool mapped = m_midiClip->instrumentTrack()->isKeyMapped(key);
+		const bool pressed = m_midiClip->instrumentTrack()->pianoModel()->isKeyPressed(key);
+		const int keyCode = key % KeysPerOctave;
+		const int yt = yb - gridCorrection(key);
+		const int kh = keyHeight(key);
+		const int kw = keyWidth(key);
+		// set key colors
+		p.setPen(QColor(0, 0, 0));
+		switch (prKeyOrder[keyCode])
+		{
+		case KeyType::WhiteSmall:
+		case KeyType::WhiteBig:
+			if (mapped)
+			{
+				if (pressed) { p.setBrush(m_whiteKeyActiveBackground); }
+				else { p.setBrush(m_whiteKeyInactiveBackground); }
+			}
+			else
+			{
+				p.setBrush(m_whiteKeyDisabledBackground);
+			}
+			break;
+		case KeyType::Black:
+			if (mapped)
+			{
+				if (pressed) { p.setBrush(m_blackKeyActiveBackground); }
+				else { p.setBrush(m_blackKeyInactiveBackground); }
+			}
+			else
+			{
+				p.setBrush(m_blackKeyDisabledBackground);
+			}
+		}
+		// draw key
+		p.drawRect(PIANO_X, yt, kw, kh);
+		// draw note name
+		if (static_cast<Key>(keyCode) == Key::C || (drawNoteNames && Piano::isWhiteKey(key)))
+		{
+			// small font sizes have 1 pixel offset instead of 2
+			auto zoomOffset = m_zoomYLevels[m_zoomingYModel.value()] > 1.0f ? 2 : 1;
+			QString noteString = getNoteString(key);
+			QRect textRect(
+				m_whiteKeyWidth - boundingRect.width() - 2,
+				yb - m_keyLineHeight + zoomOffset,
+				boundingRect.width(),
+				boundingRect.height()
+			);
+			p.setPen(pressed ? m_whiteKeyActiveTextShadow : m_whiteKeyInactiveTextShadow);
+			p.drawText(textRect.adjusted(0, 1, 1, 0), Qt::AlignRight | Qt::AlignHCenter, noteString);
+			p.setPen(pressed ? m_whiteKeyActiveTextColor : m_whiteKeyInactiveTextColor);
+			// if (static_cast<Key>(keyCode) == Key::C) { p.setPen(textColor()); }
+			// else { p.setPen(textColorLight()); }
+			p.drawText(textRect, Qt::AlignRight | Qt::AlignHCenter, noteString);
+		}
+	};
+	// lambda for drawing the horizontal grid line
+	auto drawHorizontalLine = [&](
+		const int key,
+		const int y
+	)
+	{
+		if (static_cast<Key>(key % KeysPerOctave) == Key::C) { p.setPen(m_beatLineColor); }
+		else { p.setPen(m_lineColor); }
+		p.drawLine(m_whiteKeyWidth, y, width(), y);
+	};
+	// correct y offset of the top key
+	switch (prKeyOrder[topNote])
+	{
+	case KeyType::WhiteSmall:
+	case KeyType::WhiteBig:
+		break;
+	case KeyType::Black:
+		// draw extra white key
+		drawKey(topKey + 1, grid_line_y - m_keyLineHeight);
+	}
+	// loop through visible keys
+	const int lastKey = qMax(0, topKey - m_pianoKeysVisible);
+	for (int key = topKey; key > lastKey; --key)
+	{
+		bool whiteKey = Piano::isWhiteKey(key);
+		if (whiteKey)
+		{
+			drawKey(key, grid_line_y);
+			drawHorizontalLine(key, grid_line_y);
+			grid_line_y += m_keyLineHeight;
+		}
+		else
+		{
+			// draw next white key
+			drawKey(key - 1, grid_line_y + m_keyLineHeight);
+			drawHorizontalLine(key - 1, grid_line_y + m_keyLineHeight);
+			// draw black key over previous and next white key
+			drawKey(key, grid_line_y);
+			drawHorizontalLine(key, grid_line_y);
+			// drew two grid keys so skip ahead properly
+			grid_line_y += m_keyLineHeight + m_keyLineHeight;
+			// capture double key draw
+			--key;
+		}
+	}
+
+	// don't draw over keys
+	p.setClipRect(m_whiteKeyWidth, keyAreaTop(), width(), noteEditBottom() - keyAreaTop());
+
+	// draw alternating shading on bars
+	float timeSignature =
+		static_cast<float>(Engine::getSong()->getTimeSigModel().getNumerator()) /
+		static_cast<float>(Engine::getSong()->getTimeSigModel().getDenominator());
+	float zoomFactor = m_zoomLevels[m_zoomingModel.value()];
+	//the bars which disappears at the left side by scrolling
+	int leftBars = m_currentPosition * zoomFactor / TimePos::ticksPerBar();
+	//iterates the visible bars and draw the shading on uneven bars
+	for (int x = m_whiteKeyWidth, barCount = leftBars;
+		x < width() + m_currentPosition * zoomFactor / timeSignature;
+		x += m_ppb, ++barCount)
+	{
+		if ((barCount + leftBars) % 2 != 0)
+		{
+			p.fillRect(x - m_currentPosition * zoomFactor / timeSignature,
+				PR_TOP_MARGIN,
+				m_ppb,
+				height() - (PR_BOTTOM_MARGIN + PR_TOP_MARGIN),
+				m_backgroundShade);
+		}
+	}
+
+	// draw vertical beat lines
+	int ticksPerBeat = DefaultTicksPerBar /
+		Engine::getSong()->getTimeSigModel().getDenominator();
+	p.setPen(m_beatLineColor);
+	for(tick = m_currentPosition - m_currentPosition % ticksPerBeat,
+		x = xCoordOfTick( tick );
+		x <= width();
+		tick += ticksPerBeat, x = xCoordOfTick(tick))
+	{
+		p.drawLine(x, PR_TOP_MARGIN, x, noteEditBottom());
+	}
+
+	// draw vertical bar lines
+	p.setPen(m_barLineColor);
+	for(tick = m_currentPosition - m_currentPosition % TimePos::ticksPerBar(),
+		x = xCoordOfTick( tick );
+		x <= width();
+		tick += TimePos::ticksPerBar(), x = xCoordOfTick(tick))
+	{
+		p.drawLine(x, PR_TOP_MARGIN, x, noteEditBottom());
+	}
+
+	// draw marked semitones after the grid
+	for(x = 0; x < m_markedSemiTones.size(); ++x)
+	{
+		const int key_num = m_markedSemiTones.at(x);
+		const int y = yCoordOfKey(key_num);
+		if(y >= keyAreaBottom() - 1) { break; }
+		p.fillRect(m_whiteKeyWidth + 1,
+			y,
+			width() - 10,
+			m_keyLineHeight,
+			m_markedSemitoneColor);
+	}
+
+	// reset MIDI clip
+	p.setClipRect(0, 0, width(), height());
+
+	// erase the area below the piano, because there might be keys that
+	// should be only half-visible
+	p.fillRect( QRect( 0, keyAreaBottom(),
+			m_whiteKeyWidth, noteEditBottom() - keyAreaBottom()), bgColor);
+
+	// display note editing info
+	f.setBold(false);
+	p.setFont(adjustedToPixelSize(f, SMALL_FONT_SIZE));
+	p.setPen(m_noteModeColor);
+	p.drawText( QRect( 0, keyAreaBottom(),
+					  m_whiteKeyWidth, noteEditBottom() - keyAreaBottom()),
+			   Qt::AlignCenter | Qt::TextWordWrap,
+			   m_nemStr.at(static_cast<int>(m_noteEditMode)) + ":" );
+}
+
+
+
+
+void PianoRoll::renderNoteLayer(int topKey, bool drawNoteNames)
+{
+	const auto notesHash = hashNotes(m_midiClip->notes());
+	const auto ghostNotesHash = hashNotes(m_ghostNotes);
+
+	// The indexes hold pointers to the notes, so rebuild them as soon as the
+	// notes were moved, added or removed
+	if (m_midiClip != m_indexedMidiClip || notesHash.geometry != m_indexedNotesHash)
+	{
+		m_noteIndex.rebuild(m_midiClip->notes(), [this](const Note& note) {
+			// Also find notes whose detuning curve extends past their end
+			const auto& detuning = note.detuning();
+			const tick_t detuningLength = detuning && !detuning->automationClip()->getTimeMap().isEmpty()
+				? detuning->automationClip()->getTimeMap().lastKey()
+				: 0;
+			const tick_t length = note.length() < 0 ? 4 : static_cast<tick_t>(note.length());
+			return length == 0 ? note.pos() - 1 : note.pos() + std::max(length, detuningLength);
+		});
+		m_indexedMidiClip = m_midiClip;
+		m_indexedNotesHash = notesHash.geometry;
+	}
+	if (ghostNotesHash.geometry != m_indexedGhostNotesHash)
+	{
+		m_ghostNoteIndex.rebuild(m_ghostNotes, [](const Note& note) {
+			const tick_t length = note.length() < 0 ? 4 : static_cast<tick_t>(note.length());
+			return length == 0 ? note.pos() - 1 : note.pos() + length;
+		});
+		m_indexedGhostNotesHash = ghostNotesHash.geometry;
+	}
+
+	const auto layerKey = NoteLayerKey{
+		size(), devicePixelRatioF(), m_currentPosition, m_startKey, topKey, m_pianoKeysVisible,
+		m_notesEditHeight, m_ppb, m_whiteKeyWidth, m_keyLineHeight, m_noteEditMode, m_editMode, drawNoteNames,
+		m_midiClip, notesHash.geometry, notesHash.appearance, ghostNotesHash.geometry
+	};
+	if (!m_noteLayer.isNull() && layerKey == m_noteLayerKey) { return; }
+	m_noteLayerKey = layerKey;
+
+	m_noteLayer = QPixmap(size() * devicePixelRatioF());
+	m_noteLayer.setDevicePixelRatio(devicePixelRatioF());
+	m_noteLayer.fill(Qt::transparent);
+
+	QPainter p(&m_noteLayer);
+	QFont f = font();
+	f.setBold(false);
+	p.setFont(adjustedToPixelSize(f, SMALL_FONT_SIZE));
+
+	p.setClipRect(
+		m_whiteKeyWidth,
+		PR_TOP_MARGIN,
+		width() - m_whiteKeyWidth,
+		height() - PR_TOP_MARGIN);
+
+	const int bottomKey = topKey - m_pianoKeysVisible;
+
+	// The range of ticks in view, plus a tick on each side for rounding;
+	// the exact checks below are done in pixels as before
+	const tick_t firstTick = m_currentPosition - 1;
+	const tick_t lastTick = m_currentPosition
+		+ (width() - m_whiteKeyWidth) * TimePos::ticksPerBar() / std::max(m_ppb, 1) + 1;
+
+	QPolygonF editHandles;
+
+	// Return a note's Y position on the grid
+	auto noteYPos = [&](const int key)
+	{
+		return (topKey - key) * m_keyLineHeight + keyAreaTop() - 1;
+	};
+
+	// -- Begin ghost MIDI clip
+	m_ghostNoteIndex.query(firstTick, lastTick, bottomKey + 1, topKey, m_visibleNotes);
+	for (const Note* note : m_visibleNotes)
+	{
+		int len_ticks = note->length();
+
+		if( len_ticks == 0 )
+		{
+			continue;
+		}
+		else if( len_ticks < 0 )
+		{
+			len_ticks = 4;
+		}
+
+		int pos_ticks = note->pos();
+
+		int note_width = len_ticks * m_ppb / TimePos::ticksPerBar();
+		const int x = ( pos_ticks - m_currentPosition ) *
+				m_ppb / TimePos::ticksPerBar();
+		// skip this note if not in visible area at all
+		if (!(x + note_width >= 0 && x <= width() - m_whiteKeyWidth))
+		{
+			continue;
+		}
+
+		// is the note in visible area?
+		if (note->key() > bottomKey && note->key() <= topKey)
+		{
+
+			// we've done and checked all, let's draw the note
+			drawNoteRect(
+				p, x + m_whiteKeyWidth, noteYPos(note->key()), note_width,
+				note, m_ghostNoteColor, m_ghostNoteTextColor, m_selectedNoteColor,
+				m_ghostNoteOpacity, m_ghostNoteBorders, drawNoteNames);
+		}
+
+	}
+	// -- End ghost MIDI clip
+
+	// The note editing bars are drawn for the notes on all keys
+	m_noteIndex.query(firstTick, lastTick, 0, NumKeys - 1, m_visibleNotes);
+	for (const Note* note : m_visibleNotes)
+	{
+		int len_ticks = note->length();
+
+		if( len_ticks == 0 )
+		{
+			continue;
+		}
+		else if( len_ticks < 0 )
+		{
+			len_ticks = 4;
+		}
+
+		int pos_ticks = note->pos();
+		int note_width = len_ticks * m_ppb / TimePos::ticksPerBar();
+
+		int detuningLength = note->detuning() != nullptr && !note->detuning()->automationClip()->getTimeMap().isEmpty()
+			? note->detuning()->automationClip()->getTimeMap().lastKey() * m_ppb / TimePos::ticksPerBar()
+			: note_width;
+
+		const int x = ( pos_ticks - m_currentPosition ) *
+				m_ppb / TimePos::ticksPerBar();
+		// Skip this note if not in visible area at all
+		// But still draw the note if the detuning curve extends past the end of it.
+		if (!(x + std::max(note_width, detuningLength) >= 0 && x <= width() - m_whiteKeyWidth))
+		{
+			continue;
+		}
+
+		// is the note in visible area?
+		if (note->key() > bottomKey && note->key() <= topKey)
+		{
+			// We've done and checked all, let's draw the note with
+			// the appropriate color
+			const auto fillColor = note->type() == Note::Type::Regular ? m_noteColor : m_stepNoteColor;
+
+			drawNoteRect(
+				p, x + m_whiteKeyWidth, noteYPos(note->key()), note_width,
+				note, fillColor, m_noteTextColor, m_selectedNoteColor,
+				m_noteOpacity, m_noteBorders, drawNoteNames
+			);
+		}
+
+		// draw note editing stuff
+		int editHandleTop = 0;
+		if( m_noteEditMode == NoteEditMode::Volume )
+		{
+			QColor color = m_barColor.lighter(30 + (note->getVolume() * 90 / MaxVolume));
+			if( note->selected() )
+			{
+				color = m_selectedNoteColor;
+			}
+			p.setPen( QPen( color, NOTE_EDIT_LINE_WIDTH ) );
+
+			editHandleTop = noteEditBottom() -
+				( (float)( note->getVolume() - MinVolume ) ) /
+				( (float)( MaxVolume - MinVolume ) ) *
+				( (float)( noteEditBottom() - noteEditTop() ) );
+
+			p.drawLine( QLineF ( noteEditLeft() + x + 0.5, editHandleTop + 0.5,
+						noteEditLeft() + x + 0.5, noteEditBottom() + 0.5 ) );
+
+		}
+		else if( m_noteEditMode == NoteEditMode::Panning )
+		{
+			QColor color = m_noteColor;
+			if( note->selected() )
+			{
+				color = m_selectedNoteColor;
+			}
+
+			p.setPen( QPen( color, NOTE_EDIT_LINE_WIDTH ) );
+
+			editHandleTop = noteEditBottom() -
+				( (float)( note->getPanning() - PanningLeft ) ) /
+				( (float)( (PanningRight - PanningLeft ) ) ) *
+				( (float)( noteEditBottom() - noteEditTop() ) );
+
+			p.drawLine( QLine( noteEditLeft() + x, noteEditTop() +
+					( (float)( noteEditBottom() - noteEditTop() ) ) / 2.0f,
+					    noteEditLeft() + x , editHandleTop ) );
+		}
+		editHandles << QPoint ( x + noteEditLeft(),
+					editHandleTop );
+
+		if( note->hasDetuningInfo() )
+		{
+			drawDetuningInfo(p, note, x + m_whiteKeyWidth, noteYPos(note->key()));
+			p.setClipRect(
+				m_whiteKeyWidth,
+				PR_TOP_MARGIN,
+				width() - m_whiteKeyWidth,
+				height() - PR_TOP_MARGIN);
+		}
+	}
+
+	p.setPen(QPen(m_noteColor, NOTE_EDIT_LINE_WIDTH + 2));
+	p.drawPoints( editHandles );
+}
+
+
+
+
+
 void PianoRoll::updateScrollbars()
 {
 	m_leftRightScroll->setGeometry(
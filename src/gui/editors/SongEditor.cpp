@@ -350,6 +350,9 @@ void SongEditor::selectRegionFromPixels(int xStart, int xEnd)
 		//deselect all clips
 		for (auto &it : findChildren<selectableObject *>()) { it->setSelected(false); }
 
+		// the region may span tracks and bars without clip views
+		createAllClipViews();
+
 		rubberBand()->setEnabled(true);
 		rubberBand()->show();
 
@@ -862,6 +865,9 @@ void SongEditor::zoomingChanged()
 
 void SongEditor::selectAllClips( bool select )
 {
+	// Clips of virtualized tracks may not have views to select yet
+	if (select) { createAllClipViews(); }
+
 	QVector<selectableObject *> so = select ? rubberBand()->selectableObjects() : rubberBand()->selectedObjects();
 	for( int i = 0; i < so.count(); ++i )
 	{
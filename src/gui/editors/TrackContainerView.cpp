@@ -31,6 +31,7 @@
 
 #include "TrackContainer.h"
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 #include "DataFile.h"
 #include "MainWindow.h"
 #include "FileBrowser.h"
@@ -84,7 +85,8 @@ TrackContainerView::TrackContainerView( TrackContainer * _tc ) :
 	m_trackViews(),
 	m_scrollArea( new scrollArea( this ) ),
 	m_ppb( DEFAULT_PIXELS_PER_BAR ),
-	m_rubberBand( new RubberBand( m_scrollArea ) )
+	m_rubberBand( new RubberBand( m_scrollArea ) ),
+	m_virtualized(ConfigManager::inst()->value("ui", "virtualtracklist").toInt())
 {
 	m_tc->setHook( this );
 	//keeps the direction of the widget, undepended on the locale
@@ -118,6 +120,15 @@ TrackContainerView::TrackContainerView( TrackContainer * _tc ) :
 	connect( m_tc, SIGNAL(trackAdded(lmms::Track*)),
 			this, SLOT(createTrackView(lmms::Track*)),
 			Qt::QueuedConnection );
+
+	if (m_virtualized)
+	{
+		// rangeChanged also covers resizing the view and adding or resizing tracks
+		connect(m_scrollArea->verticalScrollBar(), &QScrollBar::valueChanged,
+			this, &TrackContainerView::scheduleVisibleTracksUpdate);
+		connect(m_scrollArea->verticalScrollBar(), &QScrollBar::rangeChanged,
+			this, &TrackContainerView::scheduleVisibleTracksUpdate);
+	}
 }
 
 
@@ -262,6 +273,7 @@ void TrackContainerView::realignTracks()
 		trackView->show();
 		trackView->update();
 	}
+	scheduleVisibleTracksUpdate();
 
 	emit tracksRealigned();
 }
@@ -365,6 +377,52 @@ void TrackContainerView::clearAllTracks()
 
 
 
+void TrackContainerView::createAllClipViews()
+{
+	for (const auto& trackView : m_trackViews)
+	{
+		trackView->getTrackContentWidget()->createAllClipViews();
+	}
+}
+
+
+
+
+void TrackContainerView::updateVisibleTracks()
+{
+	m_visibleTracksUpdatePending = false;
+	if (!m_virtualized) { return; }
+
+	// Keep one screen above and below materialized, so slow scrolling
+	// does not create views right at the edge
+	const int viewHeight = m_scrollArea->viewport()->height();
+	const int top = m_scrollArea->verticalScrollBar()->value() - viewHeight;
+	const int bottom = m_scrollArea->verticalScrollBar()->value() + 2 * viewHeight;
+
+	int y = 0;
+	for (const auto& trackView : m_trackViews)
+	{
+		const int height = trackView->height();
+		trackView->getTrackContentWidget()->setInView(y + height > top && y < bottom);
+		y += height;
+	}
+}
+
+
+
+
+void TrackContainerView::scheduleVisibleTracksUpdate()
+{
+	// While loading a project every new track realigns the others, so only
+	// look at the positions once the event loop is back
+	if (!m_virtualized || m_visibleTracksUpdatePending) { return; }
+	m_visibleTracksUpdatePending = true;
+	QMetaObject::invokeMethod(this, &TrackContainerView::updateVisibleTracks, Qt::QueuedConnection);
+}
+
+
+
+
 void TrackContainerView::dragEnterEvent( QDragEnterEvent * _dee )
 {
 	StringPairDrag::processDragEnterEvent( _dee,
@@ -23,6 +23,7 @@
  */
 
 
+#include <algorithm>
 #include <QCheckBox>
 #include <QComboBox>
 #include <QGroupBox>
@@ -133,10 +134,15 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 			"ui", "enableautosave", "1").toInt()),
 	m_enableRunningAutoSave(ConfigManager::inst()->value(
 			"ui", "enablerunningautosave", "0").toInt()),
+	m_undoBudget(std::clamp(ConfigManager::inst()->value("app", "undobudget",
+			QString::number(ProjectJournal::DEFAULT_UNDO_BUDGET_MB)).toInt(),
+			ProjectJournal::MIN_UNDO_BUDGET_MB, ProjectJournal::MAX_UNDO_BUDGET_MB)),
 	m_smoothScroll(ConfigManager::inst()->value(
 			"ui", "smoothscroll").toInt()),
 	m_animateAFP(ConfigManager::inst()->value(
 			"ui", "animateafp", "1").toInt()),
+	m_virtualTrackList(ConfigManager::inst()->value(
+			"ui", "virtualtracklist").toInt()),
 	m_vstEmbedMethod(ConfigManager::inst()->vstEmbedMethod()),
 	m_vstAlwaysOnTop(ConfigManager::inst()->value(
 			"ui", "vstalwaysontop").toInt()),
@@ -431,6 +437,23 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 	m_runningAutoSave->setVisible(m_enableAutoSave);
 
 
+	// Undo history memory budget, in steps of the minimum budget
+	QGroupBox * undoBox = new QGroupBox(tr("Undo history"), performance_w);
+	QVBoxLayout * undoLayout = new QVBoxLayout(undoBox);
+
+	m_undoBudgetSlider = new QSlider(Qt::Horizontal, undoBox);
+	m_undoBudgetSlider->setRange(1, ProjectJournal::MAX_UNDO_BUDGET_MB / ProjectJournal::MIN_UNDO_BUDGET_MB);
+	m_undoBudgetSlider->setPageStep(4);
+	m_undoBudgetSlider->setValue(m_undoBudget / ProjectJournal::MIN_UNDO_BUDGET_MB);
+	connect(m_undoBudgetSlider, SIGNAL(valueChanged(int)),
+			this, SLOT(setUndoBudget(int)));
+	undoLayout->addWidget(m_undoBudgetSlider);
+
+	m_undoBudgetLbl = new QLabel(undoBox);
+	setUndoBudget(m_undoBudgetSlider->value());
+	undoLayout->addWidget(m_undoBudgetLbl);
+
+
 	// UI effect vs. performance tab.
 	QGroupBox * uiFxBox = new QGroupBox(tr("User interface (UI) effects vs. performance"), performance_w);
 	QVBoxLayout * uiFxLayout = new QVBoxLayout(uiFxBox);
@@ -439,6 +462,8 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 		m_smoothScroll, SLOT(toggleSmoothScroll(bool)), false);
 	addCheckBox(tr("Display playback cursor in AudioFileProcessor"), uiFxBox, uiFxLayout,
 		m_animateAFP, SLOT(toggleAnimateAFP(bool)), false);
+	addCheckBox(tr("Only create clip widgets for visible tracks"), uiFxBox, uiFxLayout,
+		m_virtualTrackList, SLOT(toggleVirtualTrackList(bool)), true);
 
 
 	// Plugins group
@@ -479,6 +504,7 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 
 	// Performance layout ordering.
 	performance_layout->addWidget(autoSaveBox);
+	performance_layout->addWidget(undoBox);
 	performance_layout->addWidget(uiFxBox);
 	performance_layout->addWidget(pluginsBox);
 	performance_layout->addStretch();
@@ -1017,10 +1043,14 @@ void SetupDialog::accept()
 					QString::number(m_enableAutoSave));
 	ConfigManager::inst()->setValue("ui", "enablerunningautosave",
 					QString::number(m_enableRunningAutoSave));
+	ConfigManager::inst()->setValue("app", "undobudget",
+					QString::number(m_undoBudget));
 	ConfigManager::inst()->setValue("ui", "smoothscroll",
 					QString::number(m_smoothScroll));
 	ConfigManager::inst()->setValue("ui", "animateafp",
 					QString::number(m_animateAFP));
+	ConfigManager::inst()->setValue("ui", "virtualtracklist",
+					QString::number(m_virtualTrackList));
 	ConfigManager::inst()->setValue("ui", "vstembedmethod",
 					m_vstEmbedComboBox->currentData().toString());
 	ConfigManager::inst()->setValue("ui", "vstalwaysontop",
@@ -1201,6 +1231,13 @@ void SetupDialog::toggleRunningAutoSave(bool enabled)
 }
 
 
+void SetupDialog::setUndoBudget(int steps)
+{
+	m_undoBudget = steps * ProjectJournal::MIN_UNDO_BUDGET_MB;
+	m_undoBudgetLbl->setText(tr("Memory for undo history: %1 MB").arg(m_undoBudget));
+}
+
+
 void SetupDialog::resetAutoSave()
 {
 	setAutoSaveInterval(MainWindow::DEFAULT_SAVE_INTERVAL_MINUTES);
@@ -1221,6 +1258,12 @@ void SetupDialog::toggleAnimateAFP(bool enabled)
 }
 
 
+void SetupDialog::toggleVirtualTrackList(bool enabled)
+{
+	m_virtualTrackList = enabled;
+}
+
+
 void SetupDialog::vstEmbedMethodChanged()
 {
 	m_vstEmbedMethod = m_vstEmbedComboBox->currentData().toString();
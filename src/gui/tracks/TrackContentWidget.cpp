@@ -28,6 +28,7 @@
 #include <QContextMenuEvent>
 #include <QMenu>
 #include <QPainter>
+#include <QSet>
 
 #include "AutomationClip.h"
 #include "Clipboard.h"
@@ -157,6 +158,7 @@ void TrackContentWidget::updateBackground()
 	pmp.drawLine(0, h - (horizontalWidth() + 1) / 2, w * 2, h - (horizontalWidth() + 1) / 2);
 
 	pmp.end();
+	m_backgroundStale = false;
 
 	// Force redraw
 	update();
@@ -207,6 +209,183 @@ void TrackContentWidget::removeClipView( ClipView * clipv )
 
 
 
+void TrackContentWidget::removeClipView( int clipNum )
+{
+	if( isVirtualized() )
+	{
+		// Only some views exist, so find the one of the pattern by position
+		for( const auto& clipView : m_clipViews )
+		{
+			if( clipView->getClip()->startPosition().getBar() == clipNum )
+			{
+				removeClipView( clipView );
+				return;
+			}
+		}
+	}
+	else if( clipNum >= 0 && clipNum < m_clipViews.size() )
+	{
+		removeClipView( m_clipViews[clipNum] );
+	}
+}
+
+
+
+
+bool TrackContentWidget::wantsClipView( const Clip * clip ) const
+{
+	if( !isVirtualized() ) { return true; }
+	if( !m_inView ) { return false; }
+
+	const TrackContainerView * tcv = m_trackView->trackContainerView();
+	if( tcv == getGUI()->patternEditor()->m_editor )
+	{
+		return clip->startPosition().getBar() == Engine::patternStore()->currentPattern();
+	}
+
+	// The visible range plus one screen on each side
+	const int begin = tcv->currentPosition();
+	const int span = static_cast<int>( width() * TimePos::ticksPerBar() / tcv->pixelsPerBar() );
+	return clip->endPosition() >= begin - span && clip->startPosition() <= begin + 2 * span;
+}
+
+
+
+
+bool TrackContentWidget::hasClipView( const Clip * clip ) const
+{
+	return std::any_of( m_clipViews.begin(), m_clipViews.end(),
+		[clip]( const ClipView * clipView ) { return clipView->getClip() == clip; } );
+}
+
+
+
+
+void TrackContentWidget::setInView( bool inView )
+{
+	if( inView == m_inView ) { return; }
+	m_inView = inView;
+
+	if( m_inView && m_backgroundStale ) { updateBackground(); }
+	updateClipViews();
+}
+
+
+
+
+void TrackContentWidget::createAllClipViews()
+{
+	if( !isVirtualized() ) { return; }
+
+	m_updatingClipViews = true;
+	createMissingClipViews( true );
+	changePosition();
+	m_updatingClipViews = false;
+}
+
+
+
+
+bool TrackContentWidget::isVirtualized() const
+{
+	return m_trackView->trackContainerView()->isVirtualized();
+}
+
+
+
+
+void TrackContentWidget::scheduleClipViewsUpdate()
+{
+	if( !isVirtualized() || m_updatingClipViews || m_clipViewsUpdatePending ) { return; }
+	m_clipViewsUpdatePending = true;
+	// Not done right away, as this may be reached from a view that would be deleted
+	QMetaObject::invokeMethod( this, &TrackContentWidget::updateClipViews, Qt::QueuedConnection );
+}
+
+
+
+
+void TrackContentWidget::updateClipViews()
+{
+	m_clipViewsUpdatePending = false;
+	if( !isVirtualized() || m_updatingClipViews ) { return; }
+	m_updatingClipViews = true;
+
+	// Keep views which are selected or interacted with, so selections and
+	// drags survive scrolling
+	for( auto it = m_clipViews.begin(); it != m_clipViews.end(); )
+	{
+		ClipView * clipView = *it;
+		if( wantsClipView( clipView->getClip() ) || clipView->isSelected() ||
+			clipView->hasFocus() || QWidget::mouseGrabber() == clipView )
+		{
+			++it;
+			continue;
+		}
+		it = m_clipViews.erase( it );
+		delete clipView;
+	}
+
+	if( m_inView ) { createMissingClipViews( false ); }
+
+	changePosition();
+	m_updatingClipViews = false;
+}
+
+
+
+
+void TrackContentWidget::createMissingClipViews( bool all )
+{
+	auto viewed = QSet<const Clip*>{};
+	for( const auto& clipView : m_clipViews )
+	{
+		viewed.insert( clipView->getClip() );
+	}
+	for( const auto& clip : getTrack()->getClips() )
+	{
+		if( !viewed.contains( clip ) && ( all || wantsClipView( clip ) ) )
+		{
+			clip->createView( m_trackView );
+		}
+	}
+}
+
+
+
+
+void TrackContentWidget::paintClipsWithoutViews( QPainter & p )
+{
+	auto viewed = QSet<const Clip*>{};
+	for( const auto& clipView : m_clipViews )
+	{
+		viewed.insert( clipView->getClip() );
+	}
+
+	const TrackContainerView * tcv = m_trackView->trackContainerView();
+	const float ppb = tcv->pixelsPerBar();
+	const int begin = tcv->currentPosition();
+	const int end = endPosition( tcv->currentPosition() );
+	const QColor trackColor = getTrack()->color().value_or( palette().color( QPalette::Button ) );
+
+	bool missing = false;
+	for( const auto& clip : getTrack()->getClips() )
+	{
+		if( viewed.contains( clip ) || clip->endPosition() < begin || clip->startPosition() > end ) { continue; }
+
+		const int x = static_cast<int>( ( clip->startPosition() - begin ) * ppb / TimePos::ticksPerBar() );
+		const int w = std::max( 1, static_cast<int>( clip->length() * ppb / TimePos::ticksPerBar() ) );
+		p.fillRect( x, 0, w, height() - 1, clip->color().value_or( trackColor ) );
+		missing = true;
+	}
+
+	// e.g. a clip was moved into view by undo
+	if( missing && m_inView ) { scheduleClipViewsUpdate(); }
+}
+
+
+
+
 /*! \brief Update ourselves by updating all the ClipViews attached.
  *
  */
@@ -231,6 +410,8 @@ void TrackContentWidget::update()
  */
 void TrackContentWidget::changePosition( const TimePos & newPos )
 {
+	scheduleClipViewsUpdate();
+
 	if (m_trackView->trackContainerView() == getGUI()->patternEditor()->m_editor)
 	{
 		const int curPattern = Engine::patternStore()->currentPattern();
@@ -292,8 +473,15 @@ void TrackContentWidget::changePosition( const TimePos & newPos )
 	}
 	setUpdatesEnabled( true );
 
-	// redraw background
-	updateBackground();
+	// redraw background, or wait until the track comes into view
+	if( isVirtualized() && !m_inView )
+	{
+		m_backgroundStale = true;
+	}
+	else
+	{
+		updateBackground();
+	}
 //	update();
 }
 
@@ -636,6 +824,8 @@ void TrackContentWidget::paintEvent( QPaintEvent * pe )
 	{
 		p.drawTiledPixmap(rect(), m_background, QPoint(
 				tcv->currentPosition().getTicks() * ppb / TimePos::ticksPerBar(), 0));
+
+		if (isVirtualized()) { paintClipsWithoutViews(p); }
 	}
 }
 
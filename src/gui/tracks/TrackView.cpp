@@ -426,6 +426,17 @@ void TrackView::paintEvent( QPaintEvent * pe )
  */
 void TrackView::createClipView( Clip * clip )
 {
+	// A virtualized track only creates views for the clips around the view
+	if( m_trackContainerView->isVirtualized() )
+	{
+		if( m_trackContentWidget.hasClipView( clip ) ) { return; }
+		if( !clip->getSelectViewOnCreate() && !m_trackContentWidget.wantsClipView( clip ) )
+		{
+			m_trackContentWidget.update();
+			return;
+		}
+	}
+
 	ClipView * tv = clip->createView( this );
 	if( clip->getSelectViewOnCreate() == true )
 	{
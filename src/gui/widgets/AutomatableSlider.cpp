@@ -29,6 +29,7 @@
 #include <QInputDialog>
 
 #include "CaptionMenu.h"
+#include "RepaintScheduler.h"
 
 
 namespace lmms::gui
@@ -135,8 +136,7 @@ void AutomatableSlider::modelChanged()
 {
 	QSlider::setRange( model()->minValue(), model()->maxValue() );
 	updateSlider();
-	connect( model(), SIGNAL(dataChanged()),
-				this, SLOT(updateSlider()));
+	RepaintScheduler::connectDataChanged(model(), this, [this] { updateSlider(); });
 }
 
 
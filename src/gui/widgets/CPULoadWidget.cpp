@@ -31,6 +31,8 @@
 #include "CPULoadWidget.h"
 #include "embed.h"
 #include "Engine.h"
+#include "GuiApplication.h"
+#include "MainWindow.h"
 
 
 namespace lmms::gui
@@ -44,16 +46,13 @@ CPULoadWidget::CPULoadWidget( QWidget * _parent ) :
 	m_background( embed::getIconPixmap( "cpuload_bg" ) ),
 	m_leds( embed::getIconPixmap( "cpuload_leds" ) ),
 	m_changed( true ),
-	m_updateTimer()
+	m_telemetryReader(Engine::audioEngine()->telemetry())
 {
 	setFixedSize( m_background.width(), m_background.height() );
 
 	m_temp = QPixmap( width(), height() );
-	
 
-	connect( &m_updateTimer, SIGNAL(timeout()),
-					this, SLOT(updateCpuLoad()));
-	m_updateTimer.start( 100 );	// update cpu-load at 10 fps
+	connect(getGUI()->mainWindow(), &MainWindow::periodicUpdate, this, &CPULoadWidget::updateCpuLoad);
 }
 
 
@@ -90,20 +89,36 @@ void CPULoadWidget::paintEvent( QPaintEvent *  )
 
 void CPULoadWidget::updateCpuLoad()
 {
+	// Average the loads of all periods rendered since the last update
+	int load = 0;
+	auto detailLoad = std::array<int, AudioEngineProfiler::DetailCount>{};
+	const auto periods = static_cast<int>(m_telemetryReader.read([&](const AudioTelemetry::Snapshot& snapshot) {
+		load += snapshot.cpuLoad;
+		for (std::size_t i = 0; i < detailLoad.size(); ++i)
+		{
+			detailLoad[i] += snapshot.detailLoad[i];
+		}
+	}));
+	if (periods == 0) { return; }
+
+	for (auto& detail : detailLoad) { detail /= periods; }
+	const auto detail = [&](AudioEngineProfiler::DetailType type) {
+		return detailLoad[static_cast<std::size_t>(type)];
+	};
+
 	// Additional display smoothing for the main load-value. Stronger averaging
 	// cannot be used directly in the profiler: cpuLoad() must react fast enough
 	// to be useful as overload indicator in AudioEngine::criticalXRuns().
-	const int new_load = (m_currentLoad + Engine::audioEngine()->cpuLoad()) / 2;
+	const int new_load = (m_currentLoad + load / periods) / 2;
 
 	if (new_load != m_currentLoad)
 	{
-		auto engine = Engine::audioEngine();
 		setToolTip(
 			tr("DSP total: %1%").arg(new_load) + "\n"
-			+ tr(" - Notes and setup: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::NoteSetup)) + "\n"
-			+ tr(" - Instruments: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Instruments)) + "\n"
-			+ tr(" - Effects: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Effects)) + "\n"
-			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing))
+			+ tr(" - Notes and setup: %1%").arg(detail(AudioEngineProfiler::DetailType::NoteSetup)) + "\n"
+			+ tr(" - Instruments: %1%").arg(detail(AudioEngineProfiler::DetailType::Instruments)) + "\n"
+			+ tr(" - Effects: %1%").arg(detail(AudioEngineProfiler::DetailType::Effects)) + "\n"
+			+ tr(" - Mixing: %1%").arg(detail(AudioEngineProfiler::DetailType::Mixing))
 		);
 		m_currentLoad = new_load;
 		m_changed = true;
@@ -56,6 +56,7 @@
 #include "ConfigManager.h"
 #include "DeprecationHelper.h"
 #include "KeyboardShortcuts.h"
+#include "RepaintScheduler.h"
 #include "SimpleTextFloat.h"
 
 namespace
@@ -97,7 +98,7 @@ Fader::Fader(FloatModel* model, const QString& name, QWidget* parent, bool model
 		// We currently assume that the model is not changed later on and only connect here once
 
 		// This is for example used to update the tool tip which shows the current value of the fader
-		connect(model, &FloatModel::dataChanged, this, &Fader::modelValueChanged);
+		RepaintScheduler::connectDataChanged(model, this, [this] { modelValueChanged(); });
 
 		// Trigger manually so that the tool tip is initialized correctly
 		modelValueChanged();
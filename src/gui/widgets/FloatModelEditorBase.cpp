@@ -34,12 +34,12 @@
 #include "lmms_math.h"
 #include "DeprecationHelper.h"
 #include "CaptionMenu.h"
-#include "ControllerConnection.h"
 #include "GuiApplication.h"
 #include "KeyboardShortcuts.h"
 #include "LocaleHelper.h"
 #include "MainWindow.h"
 #include "ProjectJournal.h"
+#include "RepaintScheduler.h"
 #include "SimpleTextFloat.h"
 #include "StringPairDrag.h"
 
@@ -524,13 +524,6 @@ void FloatModelEditorBase::friendlyUpdate()
 {
 	if (model() == nullptr) { return; }
 
-	// If the controller changes constantly, only repaint every 1024th frame
-	if (model()->useControllerValue()
-		&& model()->controllerConnection()
-		&& model()->controllerConnection()->getController()->frequentUpdates()
-		&& Controller::runningFrames() % (256 * 4) != 0)
-	{ return; }
-
 	// If this float model is currently controlling dynamic floating text...
 	if (floatingTextType() == FloatingTextType::Dynamic)
 	{
@@ -562,8 +555,7 @@ void FloatModelEditorBase::doConnections()
 {
 	if (model() != nullptr)
 	{
-		QObject::connect(model(), SIGNAL(dataChanged()),
-					this, SLOT(friendlyUpdate()));
+		RepaintScheduler::connectDataChanged(model(), this, [this] { friendlyUpdate(); });
 
 		QObject::connect(model(), SIGNAL(propertiesChanged()),
 						this, SLOT(update()));
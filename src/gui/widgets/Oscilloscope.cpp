@@ -23,6 +23,7 @@
  */
 
 
+#include <algorithm>
 #include <QMouseEvent>
 #include <QPainter>
 
@@ -47,7 +48,8 @@ Oscilloscope::Oscilloscope( QWidget * _p ) :
 	m_leftChannelColor(71, 253, 133),
 	m_rightChannelColor(71, 253, 133),
 	m_otherChannelsColor(71, 253, 133),
-	m_clippingColor(255, 64, 64)
+	m_clippingColor(255, 64, 64),
+	m_telemetryReader(Engine::audioEngine()->telemetry())
 {
 	setFixedSize( m_background.width(), m_background.height() );
 	setActive( ConfigManager::inst()->value( "ui", "displaywaveform").toInt() );
@@ -73,13 +75,14 @@ Oscilloscope::~Oscilloscope()
 
 
 
-void Oscilloscope::updateAudioBuffer(const SampleFrame* buffer)
+void Oscilloscope::updateAudioBuffer()
 {
-	if( !Engine::getSong()->isExporting() )
+	const auto snapshot = m_telemetryReader.latest();
+	if (snapshot && !Engine::getSong()->isExporting())
 	{
-		const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
-		memcpy(m_buffer, buffer, sizeof(SampleFrame) * frames);
+		std::copy(snapshot->output.begin(), snapshot->output.end(), m_buffer);
 	}
+	update();
 }
 
 
@@ -92,19 +95,13 @@ void Oscilloscope::setActive( bool _active )
 	{
 		connect( getGUI()->mainWindow(),
 					SIGNAL(periodicUpdate()),
-					this, SLOT(update()));
-		connect( Engine::audioEngine(),
-			SIGNAL(nextAudioBuffer(const lmms::SampleFrame*)),
-			this, SLOT(updateAudioBuffer(const lmms::SampleFrame*)));
+					this, SLOT(updateAudioBuffer()));
 	}
 	else
 	{
 		disconnect( getGUI()->mainWindow(),
 					SIGNAL(periodicUpdate()),
-					this, SLOT(update()));
-		disconnect( Engine::audioEngine(),
-			SIGNAL(nextAudioBuffer(const lmms::SampleFrame*)),
-			this, SLOT(updateAudioBuffer(const lmms::SampleFrame*)));
+					this, SLOT(updateAudioBuffer()));
 		// we have to update (remove last waves),
 		// because timer doesn't do that anymore
 		update();
@@ -88,6 +88,26 @@ private slots:
 		QCOMPARE(ab.interleavedBuffer().channels(), 2);
 	}
 
+	//! Verifies that the interleaved buffer only picks up planar changes once it is synced again
+	void SyncInterleavedBuffer()
+	{
+		auto ab = AudioBuffer{4, 2};
+		ab.allocateInterleavedBuffer();
+		ab.silenceAllChannels();
+
+		ab.buffer(0)[1] = 0.5f;
+		ab.buffer(1)[2] = -0.25f;
+		ab.invalidateInterleavedBuffer();
+		ab.syncInterleavedBuffer();
+		QCOMPARE(ab.interleavedBuffer().frame(1)[0], 0.5f);
+		QCOMPARE(ab.interleavedBuffer().frame(2)[1], -0.25f);
+
+		ab.interleavedBuffer().frame(3)[0] = 1.f;
+		ab.syncFromInterleavedBuffer();
+		QCOMPARE(ab.buffer(0)[3], 1.f);
+		QCOMPARE(ab.buffer(1)[2], -0.25f);
+	}
+
 
 	//! Verifies that the `addGroup` method can add the first group correctly
 	void AddGroup_FirstGroup()
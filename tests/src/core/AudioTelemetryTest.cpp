@@ -0,0 +1,94 @@
+/*
+ * AudioTelemetryTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AudioTelemetry.h"
+
+#include <QObject>
+#include <QtTest>
+#include <vector>
+
+using namespace lmms;
+
+namespace
+{
+
+void publish(AudioTelemetry& telemetry, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		auto& snapshot = telemetry.beginWrite();
+		snapshot.period = telemetry.published();
+		telemetry.endWrite();
+	}
+}
+
+} // namespace
+
+class AudioTelemetryTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void readerSeesEachSnapshotOnce()
+	{
+		auto telemetry = AudioTelemetry{4};
+		publish(telemetry, 3);
+
+		auto reader = AudioTelemetry::Reader{telemetry};
+		QCOMPARE(reader.read([](const auto&) {}), std::size_t{0});
+
+		publish(telemetry, 5);
+		auto periods = std::vector<std::uint64_t>{};
+		reader.read([&](const auto& snapshot) { periods.push_back(snapshot.period); });
+		QCOMPARE(periods, (std::vector<std::uint64_t>{3, 4, 5, 6, 7}));
+		QCOMPARE(reader.latest()->period, std::uint64_t{7});
+		QCOMPARE(reader.read([](const auto&) {}), std::size_t{0});
+	}
+
+	void slowReaderSkipsOverwrittenSnapshots()
+	{
+		auto telemetry = AudioTelemetry{4};
+		auto reader = AudioTelemetry::Reader{telemetry};
+		publish(telemetry, AudioTelemetry::Capacity * 3);
+
+		auto periods = std::vector<std::uint64_t>{};
+		reader.read([&](const auto& snapshot) { periods.push_back(snapshot.period); });
+		QCOMPARE(periods.size(), AudioTelemetry::ReadableSnapshots);
+		QCOMPARE(periods.front(), std::uint64_t{AudioTelemetry::Capacity * 3 - AudioTelemetry::ReadableSnapshots});
+		QCOMPARE(periods.back(), std::uint64_t{AudioTelemetry::Capacity * 3 - 1});
+	}
+
+	void channelsAreAllocatedUpFront()
+	{
+		auto telemetry = AudioTelemetry{16};
+		telemetry.reserveChannels(3);
+		QVERIFY(telemetry.channelCapacity() >= 3);
+
+		auto& snapshot = telemetry.beginWrite();
+		QCOMPARE(snapshot.output.size(), std::size_t{16});
+		QCOMPARE(snapshot.channels.size(), telemetry.channelCapacity());
+	}
+};
+
+QTEST_GUILESS_MAIN(AudioTelemetryTest)
+#include "AudioTelemetryTest.moc"
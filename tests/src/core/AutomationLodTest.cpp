@@ -0,0 +1,94 @@
+/*
+ * AutomationLodTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AutomationLod.h"
+
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace lmms;
+
+class AutomationLodTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void incrementalUpdatesMatchTheCurve()
+	{
+		auto rng = std::mt19937{1234};
+		auto value = std::uniform_real_distribution<float>{-1.f, 1.f};
+		auto curve = std::vector<float>(4000);
+		std::generate(curve.begin(), curve.end(), [&] { return value(rng); });
+
+		auto sampled = 0;
+		const auto sample = [&](tick_t from, tick_t to, float* out) {
+			std::copy(curve.begin() + from, curve.begin() + to, out);
+			sampled += to - from;
+		};
+
+		auto lod = AutomationLod{};
+		lod.update(10, 3000, sample);
+		QCOMPARE(sampled, 2990);
+
+		for (int i = 0; i < 50; ++i)
+		{
+			// Change a few ticks and sometimes the extent of the curve
+			const auto from = static_cast<tick_t>(10 + rng() % 2900);
+			const auto to = static_cast<tick_t>(from + rng() % 50);
+			std::generate(curve.begin() + from, curve.begin() + to + 1, [&] { return value(rng); });
+			lod.invalidate(from, to);
+
+			const auto end = static_cast<tick_t>(3000 + rng() % 900);
+			sampled = 0;
+			lod.update(10, end, sample);
+			QVERIFY(sampled < 1000);
+
+			for (int level = 0; level < lod.levelCount(); ++level)
+			{
+				lod.forEachBucket(level, 10, end, [&](tick_t tick, const AutomationLod::Bucket& bucket) {
+					const auto first = curve.begin() + tick;
+					const auto last = curve.begin() + std::min(tick + (1 << level), end);
+					QCOMPARE(bucket.min, *std::min_element(first, last));
+					QCOMPARE(bucket.max, *std::max_element(first, last));
+				});
+			}
+		}
+	}
+
+	void levelMatchesZoom()
+	{
+		auto lod = AutomationLod{};
+		lod.update(0, 192 * 16, [](tick_t from, tick_t to, float* out) { std::fill(out, out + (to - from), 0.f); });
+
+		QCOMPARE(lod.levelFor(0.5f), 0);
+		QCOMPARE(lod.levelFor(1.f), 0);
+		QCOMPARE(lod.levelFor(5.f), 2);
+		QCOMPARE(lod.levelFor(1e6f), lod.levelCount() - 1);
+	}
+};
+
+QTEST_GUILESS_MAIN(AutomationLodTest)
+#include "AutomationLodTest.moc"
@@ -0,0 +1,237 @@
+/*
+ * Lv2ProcTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "lmmsconfig.h"
+
+#include <QObject>
+#include <QtTest>
+
+#ifdef LMMS_HAVE_LV2
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "AudioBuffer.h"
+#include "AudioEngine.h"
+#include "AutomatableModel.h"
+#include "Engine.h"
+#include "Lv2Manager.h"
+#include "Lv2Proc.h"
+#include "SampleFrame.h"
+#include "lmms_constants.h"
+
+using namespace lmms;
+
+namespace
+{
+
+//! A simple mono gain plugin from the LV2 example bundle
+constexpr auto AmpUri = "http://lv2plug.in/plugins/eg-amp";
+constexpr int ChainLength = 8;
+//! Non-unity on purpose: at 0 dB eg-amp is an identity and a skipped stage goes unnoticed
+constexpr float GainDb = -6.f;
+
+//! A chain of effects, each made of one processor per channel group, as Lv2ControlBase does it
+class Chain
+{
+public:
+	explicit Chain(const LilvPlugin* plugin)
+	{
+		for (int i = 0; i < ChainLength; ++i)
+		{
+			auto& stage = m_stages.emplace_back();
+			unsigned ch = 0;
+			while (ch < DEFAULT_CHANNELS)
+			{
+				auto& proc = stage.emplace_back(std::make_unique<Lv2Proc>(plugin, nullptr));
+				m_channelsPerProc = proc->planarChannels();
+				if (m_channelsPerProc == 0) { return; }
+
+				AutomatableModel* gain = proc->modelAtPort("gain");
+				if (gain == nullptr) { m_gainSet = false; }
+				else { gain->setValue(GainDb); }
+				proc->copyModelsFromCore();
+				ch += m_channelsPerProc;
+			}
+		}
+	}
+
+	bool supportsPlanar() const { return m_channelsPerProc != 0; }
+	bool gainSet() const { return m_gainSet; }
+
+	//! What Effect::processAudioBuffer and Lv2Effect did for each effect before
+	void processInterleaved(AudioBuffer& buffer)
+	{
+		const f_cnt_t frames = buffer.frames();
+		auto tmp = std::vector<SampleFrame>(frames);
+		for (auto& stage : m_stages)
+		{
+			SampleFrame* buf = buffer.interleavedBuffer().asSampleFrames().data();
+			unsigned firstChan = 0;
+			for (auto& proc : stage)
+			{
+				proc->copyBuffersFromCore(buf, firstChan, m_channelsPerProc, frames);
+				proc->run(frames);
+				proc->copyBuffersToCore(tmp.data(), firstChan, m_channelsPerProc, frames);
+				firstChan += m_channelsPerProc;
+			}
+			std::copy(tmp.begin(), tmp.end(), buf);
+			toPlanar(buffer.interleavedBuffer(), buffer.groupBuffers(0));
+		}
+	}
+
+	//! The zero-copy path: the ports work on the planar channels in place
+	void processPlanar(AudioBuffer& buffer)
+	{
+		const f_cnt_t frames = buffer.frames();
+		float* const* channels = buffer.groupBuffers(0).data();
+		for (auto& stage : m_stages)
+		{
+			unsigned firstChan = 0;
+			for (auto& proc : stage)
+			{
+				proc->connectPlanarBuffers(channels + firstChan, channels + firstChan, m_channelsPerProc);
+				proc->run(frames);
+				firstChan += m_channelsPerProc;
+			}
+			toInterleaved(buffer.groupBuffers(0), buffer.interleavedBuffer());
+		}
+	}
+
+private:
+	std::vector<std::vector<std::unique_ptr<Lv2Proc>>> m_stages;
+	unsigned m_channelsPerProc = 1;
+	bool m_gainSet = true;
+};
+
+void fillRamp(AudioBuffer& buffer)
+{
+	for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+	{
+		auto channel = buffer.buffer(ch);
+		for (std::size_t f = 0; f < channel.size(); ++f)
+		{
+			channel[f] = (ch ? -1.f : 1.f) * static_cast<float>(f) / channel.size();
+		}
+	}
+	toInterleaved(buffer.groupBuffers(0), buffer.interleavedBuffer());
+}
+
+} // namespace
+
+class Lv2ProcTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		Engine::destroy();
+	}
+
+	void planarBindingMatchesCopying()
+	{
+		const auto chain = createChain();
+		if (!chain) { QSKIP("eg-amp is not installed"); }
+
+		const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
+		auto copied = AudioBuffer{frames};
+		copied.allocateInterleavedBuffer();
+		auto planar = AudioBuffer{frames};
+		planar.allocateInterleavedBuffer();
+		fillRamp(copied);
+		fillRamp(planar);
+
+		QVERIFY(chain->gainSet());
+
+		chain->processInterleaved(copied);
+		chain->processPlanar(planar);
+
+		const float factor = std::pow(10.f, GainDb * ChainLength / 20.f);
+		auto expected = AudioBuffer{frames};
+		fillRamp(expected);
+		for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+		{
+			for (f_cnt_t f = 0; f < frames; ++f)
+			{
+				QCOMPARE(planar.buffer(ch)[f], copied.buffer(ch)[f]);
+				QVERIFY(std::abs(planar.buffer(ch)[f] - expected.buffer(ch)[f] * factor) <= 1e-6f);
+			}
+		}
+	}
+
+	void benchmarkCopying()
+	{
+		const auto chain = createChain();
+		if (!chain) { QSKIP("eg-amp is not installed"); }
+
+		auto buffer = AudioBuffer{Engine::audioEngine()->framesPerPeriod()};
+		buffer.allocateInterleavedBuffer();
+		fillRamp(buffer);
+		QBENCHMARK { chain->processInterleaved(buffer); }
+	}
+
+	void benchmarkPlanarBinding()
+	{
+		const auto chain = createChain();
+		if (!chain) { QSKIP("eg-amp is not installed"); }
+
+		auto buffer = AudioBuffer{Engine::audioEngine()->framesPerPeriod()};
+		buffer.allocateInterleavedBuffer();
+		fillRamp(buffer);
+		QBENCHMARK { chain->processPlanar(buffer); }
+	}
+
+private:
+	static std::unique_ptr<Chain> createChain()
+	{
+		const LilvPlugin* plugin = Engine::getLv2Manager()->getPlugin(std::string{AmpUri});
+		if (!plugin) { return nullptr; }
+		auto chain = std::make_unique<Chain>(plugin);
+		return chain->supportsPlanar() ? std::move(chain) : nullptr;
+	}
+};
+
+#else
+
+class Lv2ProcTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void planarBindingMatchesCopying()
+	{
+		QSKIP("LMMS was built without LV2 support");
+	}
+};
+
+#endif // LMMS_HAVE_LV2
+
+QTEST_GUILESS_MAIN(Lv2ProcTest)
+#include "Lv2ProcTest.moc"
@@ -0,0 +1,112 @@
+/*
+ * NoteIndexTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NoteIndex.h"
+
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace lmms;
+
+namespace
+{
+
+tick_t noteEnd(const Note& note)
+{
+	// like the piano roll: leave out empty notes
+	return note.length() > 0 ? note.endPos() : note.pos() - 1;
+}
+
+} // namespace
+
+class NoteIndexTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void queryMatchesLinearScan()
+	{
+		auto rng = std::mt19937{1234};
+		auto pos = std::uniform_int_distribution<tick_t>{0, 192 * 64};
+		auto length = std::uniform_int_distribution<tick_t>{0, 192 * 2};
+		auto key = std::uniform_int_distribution<int>{0, NumKeys - 1};
+
+		auto storage = std::vector<std::unique_ptr<Note>>{};
+		auto notes = NoteVector{};
+		for (int i = 0; i < 5000; ++i)
+		{
+			storage.push_back(std::make_unique<Note>(TimePos{length(rng)}, TimePos{pos(rng)}, key(rng)));
+			notes.push_back(storage.back().get());
+		}
+		std::stable_sort(notes.begin(), notes.end(), Note::lessThan);
+
+		auto index = NoteIndex{};
+		index.rebuild(notes, noteEnd);
+
+		auto result = NoteVector{};
+		for (int i = 0; i < 200; ++i)
+		{
+			const tick_t start = pos(rng);
+			const tick_t end = start + length(rng) * 4;
+			const int lowKey = key(rng);
+			const int highKey = std::min(lowKey + 24, NumKeys - 1);
+
+			auto expected = NoteVector{};
+			for (Note* note : notes)
+			{
+				if (note->length() > 0 && note->key() >= lowKey && note->key() <= highKey
+					&& note->pos() <= end && note->endPos() >= start)
+				{
+					expected.push_back(note);
+				}
+			}
+
+			index.query(start, end, lowKey, highKey, result);
+			QCOMPARE(result, expected);
+		}
+	}
+
+	void longNotesAreFoundFromTheirEnd()
+	{
+		auto longNote = Note{TimePos{192 * 16}, TimePos{0}, 60};
+		auto shortNote = Note{TimePos{48}, TimePos{192}, 60};
+		auto notes = NoteVector{&longNote, &shortNote};
+
+		auto index = NoteIndex{};
+		index.rebuild(notes, noteEnd);
+
+		auto result = NoteVector{};
+		index.query(192 * 15, 192 * 15 + 10, 60, 60, result);
+		QCOMPARE(result, NoteVector{&longNote});
+
+		index.query(0, 192 * 32, 61, 127, result);
+		QVERIFY(result.empty());
+	}
+};
+
+QTEST_GUILESS_MAIN(NoteIndexTest)
+#include "NoteIndexTest.moc"
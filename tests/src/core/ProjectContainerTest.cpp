@@ -0,0 +1,86 @@
+/*
+ * ProjectContainerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QBuffer>
+#include <QObject>
+#include <QtTest>
+
+#include "ProjectContainer.h"
+
+class ProjectContainerTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void RoundTripTest()
+	{
+		using namespace lmms;
+
+		const auto xml = QByteArray{"<?xml version=\"1.0\"?>\n<lmms-project><song/></lmms-project>\n"};
+		const auto blobs = std::vector<QByteArray>{QByteArray(4096, '\x7f'), QByteArray{}, QByteArray{"\0\1\2", 3}};
+
+		auto data = QByteArray{};
+		auto buffer = QBuffer{&data};
+		buffer.open(QIODevice::WriteOnly);
+		QVERIFY(ProjectContainer::write(buffer, xml, blobs));
+		buffer.close();
+
+		buffer.open(QIODevice::ReadOnly);
+		QVERIFY(ProjectContainer::isContainer(buffer));
+		const auto contents = ProjectContainer::read(buffer);
+		QVERIFY(contents.has_value());
+		QCOMPARE(contents->xml, xml);
+		QVERIFY(contents->blobs == blobs);
+
+		buffer.seek(0);
+		const auto xmlOnly = ProjectContainer::readXml(buffer);
+		QVERIFY(xmlOnly.has_value());
+		QCOMPARE(*xmlOnly, xml);
+	}
+
+	void InvalidDataTest()
+	{
+		using namespace lmms;
+
+		auto data = QByteArray{"<?xml version=\"1.0\"?>"};
+		auto buffer = QBuffer{&data};
+		buffer.open(QIODevice::ReadOnly);
+		QVERIFY(!ProjectContainer::isContainer(buffer));
+		QVERIFY(!ProjectContainer::read(buffer).has_value());
+
+		// Truncated container
+		auto written = QByteArray{};
+		auto out = QBuffer{&written};
+		out.open(QIODevice::WriteOnly);
+		QVERIFY(ProjectContainer::write(out, QByteArray(1000, 'x'), {}));
+		out.close();
+		written.chop(20);
+
+		auto truncated = QBuffer{&written};
+		truncated.open(QIODevice::ReadOnly);
+		QVERIFY(!ProjectContainer::read(truncated).has_value());
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectContainerTest)
+#include "ProjectContainerTest.moc"
@@ -0,0 +1,117 @@
+/*
+ * RemoteProcessChannelTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RemoteProcessChannel.h"
+
+#include <QObject>
+#include <QtTest>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using lmms::RemoteProcessChannel;
+using namespace std::chrono_literals;
+
+class RemoteProcessChannelTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void midiRingKeepsOrderAcrossWrapAround()
+	{
+		auto host = RemoteProcessChannel{};
+		host.create();
+		auto client = RemoteProcessChannel{};
+		client.attach(host.key());
+
+		auto received = std::vector<int>{};
+		const auto collect = [&](const RemoteProcessChannel::MidiEntry& e) { received.push_back(e.param0); };
+
+		int next = 0;
+		for (int round = 0; round < 5; ++round)
+		{
+			for (int i = 0; i < 700; ++i, ++next)
+			{
+				QVERIFY(host.pushMidiEvent({0, 0, next, 0, 0}));
+			}
+			client.drainMidiEvents(collect);
+		}
+
+		QCOMPARE(received.size(), std::size_t{3500});
+		for (int i = 0; i < 3500; ++i)
+		{
+			QCOMPARE(received[i], i);
+		}
+	}
+
+	void midiRingRejectsWhenFull()
+	{
+		auto host = RemoteProcessChannel{};
+		host.create();
+
+		for (std::uint32_t i = 0; i < RemoteProcessChannel::Data::MidiRingSize; ++i)
+		{
+			QVERIFY(host.pushMidiEvent({}));
+		}
+		QVERIFY(!host.pushMidiEvent({}));
+	}
+
+	void waitTimesOutWithoutAnswer()
+	{
+		auto host = RemoteProcessChannel{};
+		host.create();
+		host.requestProcessing();
+		QVERIFY(!host.waitForProcessingDone(10ms));
+	}
+
+	//! Measures one request/done round trip between two threads, which is
+	//! the per-period signalling overhead of a remote plugin
+	void roundTripLatency()
+	{
+		auto host = RemoteProcessChannel{};
+		host.create();
+
+		auto quit = std::atomic<bool>{false};
+		auto clientThread = std::thread{[&] {
+			auto client = RemoteProcessChannel{};
+			client.attach(host.key());
+			while (!quit)
+			{
+				if (client.waitForRequest(10ms)) { client.signalProcessingDone(); }
+			}
+		}};
+
+		QBENCHMARK
+		{
+			host.requestProcessing();
+			QVERIFY(host.waitForProcessingDone(1000ms));
+		}
+
+		quit = true;
+		clientThread.join();
+	}
+};
+
+QTEST_GUILESS_MAIN(RemoteProcessChannelTest)
+#include "RemoteProcessChannelTest.moc"